@@ -16,10 +16,12 @@ fn main() {
         "cpp/lten/cpu/kernel/util.cc",
         "cpp/lten/cpu/all_close.cc",
         "cpp/lten/cpu/apply_rotary_pos_emb.cc",
+        "cpp/lten/cpu/arena.cc",
         "cpp/lten/cpu/binary_op.cc",
         "cpp/lten/cpu/cast.cc",
         "cpp/lten/cpu/common.cc",
         "cpp/lten/cpu/copy.cc",
+        "cpp/lten/cpu/cpu_allocator.cc",
         "cpp/lten/cpu/cpu_operators.cc",
         "cpp/lten/cpu/cpu_tensor_data.cc",
         "cpp/lten/cpu/fill.cc",
@@ -29,6 +31,8 @@ fn main() {
         "cpp/lten/cpu/lookup.cc",
         "cpp/lten/cpu/matmul.cc",
         "cpp/lten/cpu/normalizations.cc",
+        "cpp/lten/cpu/numa.cc",
+        "cpp/lten/cpu/paged_attention.cc",
         "cpp/lten/cpu/print.cc",
         "cpp/lten/cpu/rand.cc",
         "cpp/lten/cpu/reduce.cc",
@@ -39,13 +43,22 @@ fn main() {
         "cpp/lten/cpu/transform.cc",
         "cpp/lten/cpu/unfold.cc",
         "cpp/lten/cpu/view.cc",
+        "cpp/lten/arena.cc",
+        "cpp/lten/checksum.cc",
         "cpp/lten/device.cc",
         "cpp/lten/dtype.cc",
         "cpp/lten/functional.cc",
+        "cpp/lten/gguf.cc",
+        "cpp/lten/kv_cache.cc",
+        "cpp/lten/lazy_tensor.cc",
         "cpp/lten/lten.cc",
+        "cpp/lten/memory_stats.cc",
         "cpp/lten/mp.cc",
         "cpp/lten/mp_openmp.cc",
         "cpp/lten/operators.cc",
+        "cpp/lten/repack.cc",
+        "cpp/lten/safetensors.cc",
+        "cpp/lten/session.cc",
         "cpp/lten/tensor.cc",
     ];
     for file in lten_files.iter() {
@@ -134,21 +147,27 @@ fn main() {
         "cpp/lutil/internal/log.cc",
         "cpp/lutil/internal/sprintf.cc",
         "cpp/lutil/base64.cc",
+        "cpp/lutil/crc32.cc",
         "cpp/lutil/error.cc",
         "cpp/lutil/flags.cc",
         "cpp/lutil/half.cc",
         "cpp/lutil/ini_config.cc",
         "cpp/lutil/is_debug.cc",
+        "cpp/lutil/mapped_file_linux.cc",
+        "cpp/lutil/numa.cc",
+        "cpp/lutil/numa_linux.cc",
         "cpp/lutil/path_linux.cc",
         "cpp/lutil/path.cc",
         "cpp/lutil/platform_linux.cc",
         "cpp/lutil/random.cc",
+        "cpp/lutil/random_access_file_linux.cc",
         "cpp/lutil/reader.cc",
         "cpp/lutil/shared_library_linux.cc",
         "cpp/lutil/strings.cc",
         "cpp/lutil/time.cc",
         "cpp/lutil/thread_pool.cc",
         "cpp/lutil/zip_file.cc",
+        "cpp/lutil/zip_writer.cc",
     ];
     for file in lut_files.iter() {
         lut_build.file(file);
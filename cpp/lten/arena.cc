@@ -0,0 +1,64 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/arena.h"
+
+#include <memory>
+#include <vector>
+
+#include "lten/cpu/arena.h"
+#include "lutil/log.h"
+
+namespace lten {
+
+using op::cpu::Arena;
+
+namespace {
+
+// arenas of each nesting level in current thread.
+thread_local std::vector<std::unique_ptr<Arena>> gArenas;
+thread_local int gDepth = 0;
+
+}  // namespace
+
+ArenaScope::ArenaScope()
+    : _arena(nullptr),
+      _parent(Arena::getCurrent()) {
+  if (gDepth == static_cast<int>(gArenas.size())) gArenas.emplace_back(std::make_unique<Arena>());
+
+  _arena = gArenas[gDepth].get();
+  ++gDepth;
+  Arena::setCurrent(_arena);
+}
+
+ArenaScope::~ArenaScope() {
+  if (!isInnermost()) {
+    LOG(ERROR) << "ArenaScope is not destroyed in the reverse order of creation.";
+  }
+
+  _arena->reset();
+  Arena::setCurrent(_parent);
+  --gDepth;
+}
+
+bool ArenaScope::isInnermost() const {
+  return Arena::getCurrent() == _arena;
+}
+
+}  // namespace lten
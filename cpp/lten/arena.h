@@ -0,0 +1,67 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+namespace lten {
+
+namespace op {
+namespace cpu {
+class Arena;
+}  // namespace cpu
+}  // namespace op
+
+/// @brief RAII scope that routes all the CPU tensor allocations in current thread into a
+/// bump-pointer arena, typically wrapping one forward step:
+///
+///   {
+///     ArenaScope scope;
+///     logits = model.forward(...);
+///   }
+///
+/// When the scope exits, the arena is reset at once. Tensors created inside the scope and still
+/// alive after it (like `logits` above) are detected and promoted: their data is copied into
+/// regular blocks, so they are valid after the scope. Note that raw data pointers of the promoted
+/// tensors obtained inside the scope are invalidated.
+///
+/// Scopes could be nested, each nesting level has its own arena. Arenas are kept per thread and
+/// reused by the later scopes of the same level, so a steady generation loop does not allocate
+/// from the system at all.
+class ArenaScope {
+ public:
+  ArenaScope();
+  ~ArenaScope();
+
+  ArenaScope(const ArenaScope &) = delete;
+  ArenaScope &operator=(const ArenaScope &) = delete;
+
+  /// @brief Returns true if this is the innermost scope of current thread.
+  bool isInnermost() const;
+
+  /// @brief Get the arena of this scope.
+  op::cpu::Arena *getArena() const {
+    return _arena;
+  }
+
+ private:
+  op::cpu::Arena *_arena;
+  op::cpu::Arena *_parent;
+};
+
+}  // namespace lten
@@ -0,0 +1,153 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/arena.h"
+
+#include <thread>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "lten/cpu/arena.h"
+#include "lten/cpu/cpu_allocator.h"
+#include "lten/functional.h"
+
+namespace lten {
+
+using op::cpu::Arena;
+using op::cpu::CpuAllocator;
+
+CATCH_TEST_CASE("test ArenaScope allocation", "[core][arena]") {
+  CATCH_REQUIRE(Arena::getCurrent() == nullptr);
+
+  Tensor x = F::rand({16, 32}, DType::kFloat);
+  {
+    ArenaScope scope;
+    Arena *arena = scope.getArena();
+    CATCH_REQUIRE(Arena::getCurrent() == arena);
+
+    int64_t numAllocs = CpuAllocator::getStats().numAllocs;
+    Tensor y = F::mul(x, 2.0f);
+    Tensor z = F::add(y, x);
+    CATCH_REQUIRE(arena->getUsedBytes() == 2 * 16 * 32 * sizeof(float));
+    CATCH_REQUIRE(F::allClose(z, F::mul(x, 3.0f)));
+
+    // the first allocation of the arena allocates its chunk.
+    CATCH_REQUIRE(CpuAllocator::getStats().numAllocs - numAllocs <= 1);
+  }
+
+  CATCH_REQUIRE(Arena::getCurrent() == nullptr);
+}
+
+CATCH_TEST_CASE("test ArenaScope escaped tensor", "[core][arena]") {
+  Tensor x = F::rand({16, 32}, DType::kFloat);
+  Tensor ref = F::mul(x, 2.0f);
+
+  Tensor y;
+  Arena *arena;
+  const float *ptr;
+  int64_t numPromoted;
+  {
+    ArenaScope scope;
+    arena = scope.getArena();
+    numPromoted = arena->getNumPromoted();
+
+    Tensor t = F::mul(x, 2.0f);
+    y = t.view({32, 16});
+    ptr = y.getData<float>();
+
+    // dead tensors are not promoted.
+    Tensor z = F::add(t, x);
+  }
+
+  CATCH_REQUIRE(arena->getNumPromoted() - numPromoted == 1);
+  CATCH_REQUIRE(y.getData<float>() != ptr);
+  CATCH_REQUIRE(F::allClose(y.view({16, 32}), ref));
+
+  // y is no longer in the arena.
+  {
+    ArenaScope scope;
+    Tensor z = F::mul(x, 2.0f);
+  }
+  CATCH_REQUIRE(F::allClose(y.view({16, 32}), ref));
+}
+
+CATCH_TEST_CASE("test ArenaScope nested", "[core][arena]") {
+  Tensor x = F::rand({16, 32}, DType::kFloat);
+  Tensor y;
+  {
+    ArenaScope outer;
+    Tensor a = F::mul(x, 2.0f);
+    {
+      ArenaScope inner;
+      CATCH_REQUIRE(inner.isInnermost());
+      CATCH_REQUIRE(!outer.isInnermost());
+      CATCH_REQUIRE(inner.getArena() != outer.getArena());
+
+      Tensor b = F::mul(a, 2.0f);
+      y = F::add(b, a);
+      CATCH_REQUIRE(outer.getArena()->getUsedBytes() == 16 * 32 * sizeof(float));
+      CATCH_REQUIRE(inner.getArena()->getUsedBytes() == 2 * 16 * 32 * sizeof(float));
+    }
+
+    CATCH_REQUIRE(outer.isInnermost());
+    CATCH_REQUIRE(F::allClose(y, F::mul(x, 6.0f)));
+  }
+
+  CATCH_REQUIRE(F::allClose(y, F::mul(x, 6.0f)));
+}
+
+CATCH_TEST_CASE("test ArenaScope tensor destroyed in other thread", "[core][arena]") {
+  Tensor x = F::rand({16, 32}, DType::kFloat);
+
+  // the tensor is destroyed by the thread while the scope promotes it.
+  for (int i = 0; i < 100; ++i) {
+    std::thread thread;
+    {
+      ArenaScope scope;
+      Tensor t = F::mul(x, 2.0f);
+      thread = std::thread([t]() mutable { t = Tensor(); });
+    }
+    thread.join();
+  }
+}
+
+CATCH_TEST_CASE("test Arena chunks", "[core][arena]") {
+  Arena arena;
+  void *p0 = arena.allocate(1);
+  void *p1 = arena.allocate(100);
+  CATCH_REQUIRE(reinterpret_cast<Byte *>(p1) - reinterpret_cast<Byte *>(p0) == Arena::Alignment);
+  CATCH_REQUIRE(arena.getCapacity() == Arena::DefaultChunkSize);
+
+  // overflow into new chunks.
+  arena.allocate(Arena::DefaultChunkSize);
+  arena.allocate(Arena::DefaultChunkSize);
+  int64_t capacity = arena.getCapacity();
+  CATCH_REQUIRE(capacity >= 3 * Arena::DefaultChunkSize);
+
+  // chunks are merged on reset, then the same round fits in one chunk.
+  arena.reset();
+  CATCH_REQUIRE(arena.getUsedBytes() == 0);
+  CATCH_REQUIRE(arena.getCapacity() == capacity);
+
+  arena.allocate(1);
+  arena.allocate(Arena::DefaultChunkSize);
+  arena.allocate(Arena::DefaultChunkSize);
+  CATCH_REQUIRE(arena.getCapacity() == capacity);
+}
+
+}  // namespace lten
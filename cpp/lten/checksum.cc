@@ -0,0 +1,188 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/checksum.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "lten/cpu/cpu_tensor_data.h"
+#include "lten/mp.h"
+#include "lten/tensor.h"
+#include "lutil/crc32.h"
+#include "lutil/error.h"
+#include "lutil/log.h"
+#include "lutil/mapped_file.h"
+#include "lutil/reader.h"
+#include "lutil/strings.h"
+#include "lutil/zip_file.h"
+
+namespace lten {
+
+namespace {
+
+constexpr int64_t ChunkSize = 4 * 1024 * 1024;
+
+// identity of the file content recorded in the sidecar: size, modification time and inode.
+// Returns an empty string if the file could not be stat'ed.
+std::string getFileStamp(const std::string &filename) {
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) return "";
+
+#ifdef __linux__
+  int64_t mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+  int64_t mtimeNs = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#endif
+
+  return lut::sprintf(
+      "crc32c size=%d mtime=%d inode=%d",
+      static_cast<int64_t>(st.st_size),
+      mtimeNs,
+      static_cast<int64_t>(st.st_ino));
+}
+
+std::string getSidecarFilename(const std::string &filename) {
+  return filename + ".verified";
+}
+
+bool isVerifiedBefore(const std::string &filename, const std::string &stamp) {
+  std::string sidecar = getSidecarFilename(filename);
+  struct stat st;
+  if (stat(sidecar.c_str(), &st) != 0) return false;
+
+  std::unique_ptr<lut::ReadableFile> fp = lut::ReadableFile::open(sidecar);
+  return lut::trim(fp->readLine()) == stamp;
+}
+
+void writeSidecar(const std::string &filename, const std::string &stamp) {
+  std::string sidecar = getSidecarFilename(filename);
+  FILE *fp = fopen(sidecar.c_str(), "w");
+  bool ok = fp && fprintf(fp, "%s\n", stamp.c_str()) > 0;
+  if (fp && fclose(fp) != 0) ok = false;
+  if (!ok) {
+    LOG(WARN) << "unable to write " << sidecar << ", the verification is not cached.";
+  }
+}
+
+// CRC-32C of the next `size` bytes in `reader`. The mapped data is read in place.
+uint32_t crc32cOfNext(lut::Reader *reader, int64_t size, std::vector<int8_t> *buffer) {
+  int64_t offset = 0;
+  std::shared_ptr<lut::MappedFile> mappedFile = reader->getMappedFile(&offset);
+  if (mappedFile && offset + size <= static_cast<int64_t>(mappedFile->getData().size())) {
+    uint32_t crc = lut::crc32c(mappedFile->getData().subspan(offset, size));
+    reader->skip(size);
+    return crc;
+  }
+
+  uint32_t crc = 0;
+  buffer->resize(std::min(size, ChunkSize));
+  for (int64_t pos = 0; pos < size; pos += ChunkSize) {
+    lut::Span<int8_t> chunk = lut::makeSpan(*buffer).subspan(0, std::min(ChunkSize, size - pos));
+    reader->readSpan(chunk);
+    crc = lut::crc32c(lut::makeConstSpan(chunk.data(), chunk.size()), crc);
+  }
+
+  return crc;
+}
+
+// verify the slots of entry `name` in the format of Tensor::read(). The entries other than tensors
+// are skipped.
+void verifyEntry(
+    const lut::ZipFile &zipFile,
+    const std::string &name,
+    std::atomic<int64_t> *numVerified,
+    std::atomic<int64_t> *numUnchecked) {
+  if (zipFile.getFileSize(name) < 4) return;
+
+  std::shared_ptr<lut::Reader> reader = zipFile.open(name);
+  reader->adviseSequential();
+  if (reader->readString(4) != "tnsr") return;
+
+  TensorShape::read(reader.get());
+  if (reader->readString(4) != "tdat") THROW(Aborted, "bad tensor data format: " + name);
+
+  int32_t numSlot = reader->readValue<int32_t>();
+  if (numSlot <= 0 || numSlot > TensorData::MaxSlot) THROW(Aborted, "invalid num slot: " + name);
+
+  // each element takes at least 5/8 bytes (kQInt4x32).
+  int64_t maxNumEl = zipFile.getFileSize(name) * 2;
+  std::vector<int8_t> buffer;
+  for (int i = 0; i < numSlot; ++i) {
+    DType dtype = reader->readValue<int16_t>();
+    int64_t numel = reader->readValue<int64_t>();
+    if (!dtype.isValid() || numel < 0 || numel > maxNumEl ||
+        (dtype.isQuantized() && numel % dtype.getGroupSize() != 0)) {
+      THROW(Aborted, "bad tensor data format: " + name);
+    }
+
+    uint32_t crc = crc32cOfNext(reader.get(), dtype.getTotalSize(numel), &buffer);
+    int16_t magicNumber = reader->readValue<int16_t>();
+    if (magicNumber == op::cpu::CpuTensorData::SlotMagicCrc32c) {
+      if (reader->readValue<uint32_t>() != crc) {
+        THROW(Aborted, lut::sprintf("checksum mismatch in tensor %s.", name));
+      }
+      ++*numVerified;
+    } else if (magicNumber == op::cpu::CpuTensorData::SlotMagic) {
+      ++*numUnchecked;
+    } else {
+      THROW(Aborted, "bad tensor data format (magic number): " + name);
+    }
+  }
+}
+
+}  // namespace
+
+VerifyResult::VerifyResult()
+    : numVerified(0),
+      numUnchecked(0),
+      cached(false) {
+}
+
+VerifyResult verifyModel(const std::string &filename, bool useCache) {
+  VerifyResult result;
+  std::string stamp = getFileStamp(filename);
+  if (useCache && !stamp.empty() && isVerifiedBefore(filename, stamp)) {
+    result.cached = true;
+    return result;
+  }
+
+  std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(filename);
+  std::vector<std::string> names = zipFile->getList();
+
+  std::atomic<int64_t> numVerified{0};
+  std::atomic<int64_t> numUnchecked{0};
+  MP::parallelForOrThrow(names.size(), [&](MP::Context ctx) {
+    verifyEntry(*zipFile, names[ctx.getBlockIdx()], &numVerified, &numUnchecked);
+  });
+
+  result.numVerified = numVerified;
+  result.numUnchecked = numUnchecked;
+
+  // the files without checksums are not recorded, they are never verified.
+  if (useCache && !stamp.empty() && result.numUnchecked == 0) writeSidecar(filename, stamp);
+  return result;
+}
+
+}  // namespace lten
@@ -0,0 +1,55 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+namespace lten {
+
+/// @brief Result of verifyModel().
+struct VerifyResult {
+  /// @brief number of tensor slots whose CRC-32C matched.
+  int64_t numVerified;
+
+  /// @brief number of tensor slots without checksum, written by the converters before it.
+  int64_t numUnchecked;
+
+  /// @brief true if the file was not read since the sidecar shows it was verified before.
+  bool cached;
+
+  VerifyResult();
+};
+
+/// @brief Verify the CRC-32C checksums of all the tensors in model file (zip) `filename`. The
+/// tensors are verified in parallel with the worker threads of MP, and the pages read are shared
+/// with the page cache, so a following load maps them without reading the disk again. Throws
+/// AbortedError on checksum mismatch or a corrupted tensor.
+///
+/// If `useCache` is true, the size, modification time and inode of a verified file are recorded in
+/// the sidecar file "<filename>.verified". A file matching its sidecar is not read again, so warm
+/// restarts skip the verification. Failure to write the sidecar is not an error.
+/// @param filename the model file.
+/// @param useCache skip the verified files and record the newly verified ones.
+/// @return the verification result.
+VerifyResult verifyModel(const std::string &filename, bool useCache = true);
+
+}  // namespace lten
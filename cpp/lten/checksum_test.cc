@@ -0,0 +1,113 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/checksum.h"
+
+#include <stdio.h>
+#include <string>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/functional.h"
+#include "lten/lten.h"
+#include "lten/repack.h"
+#include "lten/test_helper.h"
+#include "lutil/error.h"
+#include "lutil/mapped_file.h"
+#include "lutil/zip_file.h"
+
+namespace lten {
+
+namespace {
+
+std::string readWholeFile(const std::string &filename) {
+  std::shared_ptr<lut::MappedFile> file = lut::MappedFile::open(filename);
+  return std::string(
+      reinterpret_cast<const char *>(file->getData().data()),
+      file->getData().size());
+}
+
+bool fileExists(const std::string &filename) {
+  FILE *fp = fopen(filename.c_str(), "rb");
+  if (fp) fclose(fp);
+  return fp != nullptr;
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("test verify model checksum", "[core][checksum]") {
+  std::string inputFile = getTestFilePath("test_checksum_in.zip");
+  std::string outputFile = getTestFilePath("test_checksum_out.zip");
+  std::string sidecar = outputFile + ".verified";
+  remove(sidecar.c_str());
+
+  Tensor w = F::rand({16, 64}, DType::kFloat);
+  Tensor b = F::rand({8, 20}, DType::kFloat);
+  std::string zipData;
+  appendTensorZipEntry(&zipData, "w.tensor", w, 0);
+  appendTensorZipEntry(&zipData, "b.tensor", b, 0);
+  writeFile(inputFile, zipData);
+
+  // the legacy file has no checksum and is never cached.
+  VerifyResult result = verifyModel(inputFile);
+  CATCH_REQUIRE(result.numVerified == 0);
+  CATCH_REQUIRE(result.numUnchecked == 2);
+  CATCH_REQUIRE(!fileExists(inputFile + ".verified"));
+
+  RepackOptions options;
+  options.weightType = DType::kQInt4x32;
+  repackModel(inputFile, outputFile, options);
+  std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(outputFile);
+  CATCH_REQUIRE(F::allClose(readTensor(*zipFile, "b.tensor"), b));
+  zipFile = nullptr;
+
+  result = verifyModel(outputFile, false);
+  CATCH_REQUIRE(result.numVerified == 2);
+  CATCH_REQUIRE(!result.cached);
+  CATCH_REQUIRE(!fileExists(sidecar));
+
+  // the second verification is skipped by the sidecar.
+  result = verifyModel(outputFile);
+  CATCH_REQUIRE(result.numVerified == 2);
+  CATCH_REQUIRE(fileExists(sidecar));
+  result = verifyModel(outputFile);
+  CATCH_REQUIRE(result.cached);
+  CATCH_REQUIRE(result.numVerified == 0);
+
+  LVerifyResult lresult;
+  CATCH_REQUIRE(lten_verify_model(outputFile.c_str(), 0, &lresult) == 0);
+  CATCH_REQUIRE(lresult.num_verified == 2);
+  CATCH_REQUIRE(lresult.cached == 0);
+
+  // flip one byte in the data of b. The rewritten file does not match the sidecar any more.
+  std::string data = readWholeFile(outputFile);
+  std::string::size_type pos = data.find(
+      std::string(reinterpret_cast<const char *>(b.getData<float>()), 16));
+  CATCH_REQUIRE(pos != std::string::npos);
+  data[pos + 5] ^= 1;
+  remove(outputFile.c_str());
+  writeFile(outputFile, data);
+  CATCH_REQUIRE_THROWS_AS(verifyModel(outputFile), lut::AbortedError);
+  CATCH_REQUIRE(lten_verify_model(outputFile.c_str(), 1, &lresult) != 0);
+
+  remove(inputFile.c_str());
+  remove(outputFile.c_str());
+  remove(sidecar.c_str());
+}
+
+}  // namespace lten
@@ -19,7 +19,7 @@
 
 #pragma once
 
-#include <vector>
+#include <algorithm>
 
 #include "lten/tensor.h"
 #include "lutil/span.h"
@@ -43,7 +43,7 @@ class TensorAccessorBase {
     _size = tensor.getShape_()->getData_().data();
   }
 
-  int getShape(int d) const {
+  Tensor::ShapeType getShape(int d) const {
     CHECK(d < DIM);
     return _size[d].shape;
   }
@@ -76,11 +76,11 @@ class TensorAccessor : public TensorAccessorBase<T, DIM> {
       : TensorAccessorBase<T, DIM>(size, data) {
   }
 
-  TensorAccessor<T, DIM - 1> operator[](int index) {
+  TensorAccessor<T, DIM - 1> operator[](int64_t index) {
     int64_t offset = index * this->_size[0].stride;
     return TensorAccessor<T, DIM - 1>(this->_size + 1, this->_data + offset);
   }
-  const TensorAccessor<T, DIM - 1> operator[](int index) const {
+  const TensorAccessor<T, DIM - 1> operator[](int64_t index) const {
     int64_t offset = index * this->_size[0].stride;
     return TensorAccessor<T, DIM - 1>(this->_size + 1, this->_data + offset);
   }
@@ -100,16 +100,19 @@ class TensorAccessor<T, 1> : public TensorAccessorBase<T, 1> {
       : TensorAccessorBase<T, 1>(size, data) {
   }
 
-  T &operator[](int index) {
+  T &operator[](int64_t index) {
     int64_t offset = index * this->_size[0].stride;
     return this->_data[offset];
   }
-  const T &operator[](int index) const {
+  const T &operator[](int64_t index) const {
     int64_t offset = index * this->_size[0].stride;
     return this->_data[offset];
   }
 };
 
+/// @brief The DIM-dimensional sub-tensors in the last DIM dimensions of a tensor. The data pointer
+/// of i-th sub-tensor is computed on the fly from the shape and stride of the leading (batch)
+/// dimensions, so non-contiguous tensors are iterated without any heap allocation.
 template<typename T, int DIM>
 class TensorList {
  public:
@@ -119,128 +122,73 @@ class TensorList {
   lut::Span<const TensorShape::Elem> getShape() const {
     return lut::Span<const TensorShape::Elem>(_shape, DIM);
   }
-  int getShape(int d) const {
+  Tensor::ShapeType getShape(int d) const {
     return _shape[d].shape;
   }
-  int getLength() const {
-    if (_basePtr) {
-      return _size;
-    } else {
-      return static_cast<int>(_pointerList.size());
-    }
+  int64_t getLength() const {
+    return _size;
   }
-  lut::Span<T *const> getDataPtrList() {
-    if (_basePtr && _pointerList.empty()) {
-      for (int i = 0; i < _size; ++i) {
-        _pointerList.push_back(_basePtr + i * _stride);
-      }
+
+  /// @brief Get data pointer of the index-th sub-tensor.
+  T *getDataPtr(int64_t index) const {
+    if (_numBatchDim == 1) return _basePtr + index * _batchShape[0].stride;
+
+    int64_t offset = 0;
+    for (int d = _numBatchDim - 1; d >= 0; --d) {
+      offset += (index % _batchShape[d].shape) * _batchShape[d].stride;
+      index /= _batchShape[d].shape;
     }
-    return lut::makeConstSpan(_pointerList);
+    return _basePtr + offset;
   }
 
-  TensorAccessor<T, DIM> getTensor(int index) const {
-    if (_basePtr) {
-      return TensorAccessor<T, DIM>(_shape, _basePtr + index * _stride);
-    } else {
-      return TensorAccessor<T, DIM>(_shape, _pointerList[index]);
-    }
+  TensorAccessor<T, DIM> getTensor(int64_t index) const {
+    return TensorAccessor<T, DIM>(_shape, getDataPtr(index));
   }
 
  private:
-  const TensorShape::Elem *_shape;
-  std::vector<T *> _pointerList;
-
-  int64_t _stride;
-  int _size;
+  TensorShape::Elem _shape[DIM];
+  TensorShape::Elem _batchShape[TensorShape::MaxDim];
+  int _numBatchDim;
+  int64_t _size;
   T *_basePtr;
 
-  TensorList(const TensorShape::Elem *shape, std::vector<T *> &&pointerList)
-      : _shape(shape),
-        _pointerList(std::move(pointerList)),
-        _stride(0),
-        _size(0),
-        _basePtr(nullptr) {
-  }
-
-  TensorList(const TensorShape::Elem *shape, T *data, int size, int stride)
-      : _shape(shape),
-        _stride(stride),
-        _size(size),
-        _basePtr(data) {
-  }
+  TensorList(lut::Span<const TensorShape::Elem> shape, T *data);
 };
 
-template<typename T, int SUBTENSOR_DIM>
-void getDataPointerList(
-    T *base,
-    lut::Span<const TensorShape::Elem> shape,
-    std::vector<T *> &pointerList) {
-  CHECK(shape.size() >= SUBTENSOR_DIM);
-
-  if (shape.size() == SUBTENSOR_DIM) {
-    pointerList.push_back(base);
-  } else {
-    int size = shape.front().shape;
-    int stride = shape.front().stride;
-    int dim = shape.size();
-
-    for (int i = 0; i < size; ++i) {
-      T *pointer = base + i * stride;
-      if (dim - SUBTENSOR_DIM == 1) {
-        pointerList.push_back(pointer);
-      } else {
-        getDataPointerList<T, SUBTENSOR_DIM>(pointer, shape.subspan(1), pointerList);
-      }
+template<typename T, int DIM>
+TensorList<T, DIM>::TensorList(lut::Span<const TensorShape::Elem> shape, T *data)
+    : _numBatchDim(0),
+      _size(1),
+      _basePtr(data) {
+  CHECK(shape.size() >= DIM);
+  int numBatchDim = static_cast<int>(shape.size()) - DIM;
+  std::copy(shape.begin() + numBatchDim, shape.end(), _shape);
+
+  // drop the singleton batch dimensions and merge the contiguous ones, then the common case,
+  // batch dimensions of a contiguous tensor, has only one dimension left.
+  for (int d = 0; d < numBatchDim; ++d) {
+    const TensorShape::Elem &elem = shape[d];
+    _size *= elem.shape;
+    if (elem.shape == 1) continue;
+
+    TensorShape::Elem *last = _numBatchDim ? &_batchShape[_numBatchDim - 1] : nullptr;
+    if (last && last->stride == elem.stride * elem.shape) {
+      last->shape *= elem.shape;
+      last->stride = elem.stride;
+    } else {
+      _batchShape[_numBatchDim++] = elem;
     }
   }
 }
 
 template<typename T, int DIM>
 TensorList<T, DIM> TensorList<T, DIM>::fromTensor(const Tensor &src) {
-  std::vector<T *> pointerList;
-  lut::Span<const TensorShape::Elem> shape = src.getShape_()->getData_();
-  getDataPointerList<T, DIM>(src.getData<T>(), shape, pointerList);
-
-  const TensorShape::Elem *tensorShape = shape.data() + (shape.size() - DIM);
-  if (src.isContiguous()) {
-    int numTensor = 1;
-    for (int i = 0; i < src.getDim() - DIM; ++i) {
-      numTensor *= src.getShape(i);
-    }
-
-    int stride = 1;
-    for (int i = 0; i < DIM; ++i) {
-      stride *= tensorShape[i].shape;
-    }
-
-    return TensorList<T, DIM>(tensorShape, src.getData<T>(), numTensor, stride);
-  } else {
-    return TensorList<T, DIM>(tensorShape, std::move(pointerList));
-  }
+  return TensorList<T, DIM>(src.getShape_()->getData_(), src.getData<T>());
 }
 
 template<typename T, int DIM>
 TensorList<T, DIM> TensorList<T, DIM>::fromTensor(Tensor &src) {
-  std::vector<T *> pointerList;
-  lut::Span<const TensorShape::Elem> shape = src.getShape_()->getData_();
-  getDataPointerList<T, DIM>(src.getData<T>(), shape, pointerList);
-
-  const TensorShape::Elem *tensorShape = shape.data() + (shape.size() - DIM);
-  if (src.isContiguous()) {
-    int numTensor = 1;
-    for (int i = 0; i < src.getDim() - DIM; ++i) {
-      numTensor *= src.getShape(i);
-    }
-
-    int stride = 1;
-    for (int i = 0; i < DIM; ++i) {
-      stride *= tensorShape[i].shape;
-    }
-
-    return TensorList<T, DIM>(tensorShape, src.getData<T>(), numTensor, stride);
-  } else {
-    return TensorList<T, DIM>(tensorShape, std::move(pointerList));
-  }
+  return TensorList<T, DIM>(src.getShape_()->getData_(), src.getData<T>());
 }
 
 }  // namespace cpu
@@ -37,11 +37,11 @@ float maxDiffKernel(Tensor A, Tensor B) {
   CHECK(vA.getLength() == vB.getLength());
 
   float maxDiff = 0.0f;
-  for (int j = 0; j < vA.getLength(); ++j) {
+  for (int64_t j = 0; j < vA.getLength(); ++j) {
     TensorAccessor<const T, 1> a = vA.getTensor(j);
     TensorAccessor<const T, 1> b = vB.getTensor(j);
 
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       float diff = fabs(static_cast<float>(a[i]) - static_cast<float>(b[i]));
       if (diff > maxDiff) maxDiff = diff;
     }
@@ -55,10 +55,10 @@ float meanAbsKernel(Tensor A) {
   TensorList<const T, 1> vA = TensorList<const T, 1>::fromTensor(A);
 
   double sum = 0.0;
-  for (int j = 0; j < vA.getLength(); ++j) {
+  for (int64_t j = 0; j < vA.getLength(); ++j) {
     TensorAccessor<const T, 1> a = vA.getTensor(j);
 
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       sum += fabs(static_cast<float>(a[i]));
     }
   }
@@ -38,12 +38,12 @@ Tensor applyRotaryPosEmbKernel(const Tensor &input, const Tensor &roPE) {
   CHECK(vA.getLength() == vC.getLength());
   CHECK(vA.getLength() == vR.getLength());
 
-  for (int j = 0; j < vA.getLength(); ++j) {
+  for (int64_t j = 0; j < vA.getLength(); ++j) {
     TensorAccessor<const T, 1> a = vA.getTensor(j);
     TensorAccessor<const T, 1> r = vR.getTensor(j);
     TensorAccessor<T, 1> c = vC.getTensor(j);
 
-    for (int i = 0; i < a.getShape(0); i += 2) {
+    for (int64_t i = 0; i < a.getShape(0); i += 2) {
       c[i + 0] = a[i + 0] * r[i + 0] - a[i + 1] * r[i + 1];
       c[i + 1] = a[i + 1] * r[i + 0] + a[i + 0] * r[i + 1];
     }
@@ -0,0 +1,145 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/cpu/arena.h"
+
+#include <algorithm>
+
+#include "lten/cpu/cpu_allocator.h"
+#include "lten/cpu/cpu_tensor_data.h"
+#include "lutil/error.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+namespace {
+
+thread_local Arena *gCurrentArena = nullptr;
+
+}  // namespace
+
+Arena::Arena()
+    : _offset(0),
+      _usedBytes(0),
+      _capacity(0),
+      _numPromoted(0),
+      _numTracked(0) {
+}
+
+Arena::~Arena() {
+  promoteEscaped();
+  freeChunks();
+}
+
+Arena *Arena::getCurrent() {
+  return gCurrentArena;
+}
+
+void Arena::setCurrent(Arena *arena) {
+  gCurrentArena = arena;
+}
+
+void Arena::allocChunk(int64_t size) {
+  Chunk chunk;
+  chunk.data = reinterpret_cast<Byte *>(CpuAllocator::allocate(size));
+  chunk.size = size;
+
+  _chunks.push_back(chunk);
+  _capacity += size;
+  _offset = 0;
+}
+
+void Arena::freeChunks() {
+  for (const Chunk &chunk : _chunks) {
+    CpuAllocator::free(chunk.data, chunk.size);
+  }
+
+  _chunks.clear();
+  _capacity = 0;
+  _offset = 0;
+}
+
+void *Arena::allocate(int64_t size) {
+  CHECK(size >= 0);
+  size = (size + Alignment - 1) / Alignment * Alignment;
+
+  if (_chunks.empty() || _offset + size > _chunks.back().size) {
+    // grow geometrically to keep the number of chunks small in the first round.
+    allocChunk(std::max({size, DefaultChunkSize, _capacity}));
+  }
+
+  Byte *ptr = _chunks.back().data + _offset;
+  _offset += size;
+  _usedBytes += size;
+  return ptr;
+}
+
+int Arena::track(CpuTensorData *tensorData) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _tensors.push_back(tensorData);
+  ++_numTracked;
+
+  return static_cast<int>(_tensors.size()) - 1;
+}
+
+bool Arena::untrack(CpuTensorData *tensorData) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // promoted after the caller read its arena.
+  if (tensorData->_arena.load() != this) return false;
+
+  int index = tensorData->_arenaIndex;
+  CHECK(index >= 0 && index < static_cast<int>(_tensors.size()) && _tensors[index] == tensorData);
+
+  _tensors[index] = nullptr;
+  --_numTracked;
+  return true;
+}
+
+void Arena::promoteEscaped() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_numTracked) {
+    for (CpuTensorData *tensorData : _tensors) {
+      if (!tensorData) continue;
+
+      tensorData->promote();
+      ++_numPromoted;
+    }
+  }
+
+  _tensors.clear();
+  _numTracked = 0;
+}
+
+void Arena::reset() {
+  promoteEscaped();
+  if (_chunks.size() > 1) {
+    int64_t capacity = _capacity;
+    freeChunks();
+    allocChunk(capacity);
+  }
+
+  _offset = 0;
+  _usedBytes = 0;
+}
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
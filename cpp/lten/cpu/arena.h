@@ -0,0 +1,130 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <mutex>
+#include <vector>
+
+#include "lten/dtype.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+class CpuTensorData;
+
+/// @brief Bump-pointer arena for the CPU tensor data. Allocation is a pointer increment inside
+/// the current chunk, memory is released all at once by reset().
+///
+/// The tensor data allocated from the arena are tracked. When reset() is called, the tensor data
+/// that are still alive (escaped from the scope) are promoted: their contents are copied into
+/// blocks of the CpuAllocator, so that the tensors stay valid after the arena is reused.
+///
+/// Allocation and reset() should happen in the thread owning the arena. The tracked tensor data
+/// may be destroyed in any thread, even concurrently with reset(), as long as the arena itself is
+/// alive.
+class Arena {
+ public:
+  static constexpr int64_t DefaultChunkSize = 16 * 1024 * 1024;
+  static constexpr int64_t Alignment = 64;
+
+  Arena();
+  ~Arena();
+
+  /// @brief Get the arena that CpuTensorData allocates from in current thread, or nullptr.
+  static Arena *getCurrent();
+  static void setCurrent(Arena *arena);
+
+  /// @brief Allocate `size` bytes aligned to `Alignment`. New chunk is allocated when the current
+  /// one is full.
+  void *allocate(int64_t size);
+
+  /// @brief Track a tensor data that allocated its slots from this arena.
+  /// @return index of the tensor data in arena, used in untrack().
+  int track(CpuTensorData *tensorData);
+
+  /// @brief Called when a tracked tensor data is destroyed. Returns false if it was already
+  /// promoted, then the promoted copy should be released by the tensor data.
+  bool untrack(CpuTensorData *tensorData);
+
+  /// @brief Promote the escaped tensor data and release all the allocations. When more than one
+  /// chunk is used, they are merged into a single chunk so the next round fits in it.
+  void reset();
+
+  /// @brief Get bytes allocated since the last reset().
+  int64_t getUsedBytes() const {
+    return _usedBytes;
+  }
+
+  /// @brief Get the total size of chunks.
+  int64_t getCapacity() const {
+    return _capacity;
+  }
+
+  /// @brief Get number of tensor data promoted by reset() in the life of the arena.
+  int64_t getNumPromoted() const {
+    return _numPromoted;
+  }
+
+ private:
+  struct Chunk {
+    Byte *data;
+    int64_t size;
+  };
+
+  std::vector<Chunk> _chunks;
+  int64_t _offset;
+  int64_t _usedBytes;
+  int64_t _capacity;
+  int64_t _numPromoted;
+
+  std::mutex _mutex;
+  std::vector<CpuTensorData *> _tensors;
+  int _numTracked;
+
+  void allocChunk(int64_t size);
+  void freeChunks();
+  void promoteEscaped();
+};
+
+/// @brief RAII scope that suspends the arena of current thread during its lifetime, for the
+/// tensors expected to outlive the arena scope, like the weights loaded on demand.
+class NoArenaScope {
+ public:
+  NoArenaScope()
+      : _arena(Arena::getCurrent()) {
+    Arena::setCurrent(nullptr);
+  }
+  ~NoArenaScope() {
+    Arena::setCurrent(_arena);
+  }
+
+  NoArenaScope(const NoArenaScope &) = delete;
+  NoArenaScope &operator=(const NoArenaScope &) = delete;
+
+ private:
+  Arena *_arena;
+};
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
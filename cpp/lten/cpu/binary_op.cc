@@ -36,9 +36,9 @@ Tensor broadcastTensor(const Tensor &a, lut::Span<const Tensor::ShapeType> targe
 }
 
 template<typename T>
-Tensor binaryOpKernel(const Tensor &A, const Tensor &B, BinaryOp op) {
+Tensor binaryOpKernel(Tensor A, const Tensor &B, BinaryOp op) {
   Tensor xB = broadcastTensor(B, A.getShape());
-  Tensor C = tensorLike(A);
+  Tensor C = tensorLikeOrReuse(A);
 
   TensorList<const T, 1> vA = TensorList<const T, 1>::fromTensor(A);
   TensorList<const T, 1> vB = TensorList<const T, 1>::fromTensor(xB);
@@ -50,7 +50,7 @@ Tensor binaryOpKernel(const Tensor &A, const Tensor &B, BinaryOp op) {
     TensorAccessor<const T, 1> b = vB.getTensor(ctx.getBlockIdx());
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       if (op == BinaryOp::ADD) {
         c[i] = a[i] + b[i];
       } else if (op == BinaryOp::MUL) {
@@ -65,10 +65,10 @@ Tensor binaryOpKernel(const Tensor &A, const Tensor &B, BinaryOp op) {
 }
 
 // apply C <- BinaryOp(A, B)
-Tensor binaryOp(const Tensor &A, const Tensor &B, BinaryOp op) {
-  if (A.getDType() == DType::kFloat) return binaryOpKernel<float>(A, B, op);
+Tensor binaryOp(Tensor A, const Tensor &B, BinaryOp op) {
+  if (A.getDType() == DType::kFloat) return binaryOpKernel<float>(std::move(A), B, op);
 #if LUT_CPU_ARCH == LUT_AARCH64
-  if (A.getDType() == DType::kFloat16) return binaryOpKernel<Float16>(A, B, op);
+  if (A.getDType() == DType::kFloat16) return binaryOpKernel<Float16>(std::move(A), B, op);
 #endif
 
   NOT_IMPL();
@@ -28,7 +28,7 @@ namespace cpu {
 enum class BinaryOp { ADD, MUL };
 
 // apply C <- BinaryOp(A, B)
-Tensor binaryOp(const Tensor &A, const Tensor &B, BinaryOp op);
+Tensor binaryOp(Tensor A, const Tensor &B, BinaryOp op);
 
 }  // namespace cpu
 }  // namespace op
@@ -97,8 +97,7 @@ Tensor castFp32ToQ4(Tensor A) {
       0,
       (kernel::QInt4x32 *)tensorData->getData<QInt4x32>(0),
       kernel::Mode::OMP);
-  auto tensorShape = std::make_shared<TensorShape>(A.getShape());
-  return Tensor::create(tensorShape, tensorData);
+  return Tensor::create(TensorShape(lut::makeConstSpan(A.getShape())), tensorData);
 }
 
 }  // namespace cpu
@@ -28,24 +28,20 @@ Tensor expandBatchDims(const Tensor &input, lut::Span<const Tensor::ShapeType> s
   if (input.getDim() == static_cast<int>(shape.size())) return input;
   int nBroadcastDim = static_cast<int>(shape.size()) - input.getDim();
 
-  Tensor x = input;
-  std::vector<TensorShape::Elem> broadcastShape;
+  CHECK(shape.size() <= TensorShape::MaxDim);
+  TensorShape::Elem broadcastShape[TensorShape::MaxDim];
   for (int i = 0; i < nBroadcastDim; ++i) {
-    TensorShape::Elem shapeElem;
-    shapeElem.stride = 0;
-    shapeElem.shape = shape[i];
-    broadcastShape.push_back(shapeElem);
+    broadcastShape[i].stride = 0;
+    broadcastShape[i].shape = shape[i];
   }
 
   for (int i = 0; i < input.getDim(); ++i) {
-    TensorShape::Elem shapeElem;
-    shapeElem.stride = input.getStride(i);
-    shapeElem.shape = input.getShape(i);
-    broadcastShape.push_back(shapeElem);
+    broadcastShape[nBroadcastDim + i].stride = input.getStride(i);
+    broadcastShape[nBroadcastDim + i].shape = input.getShape(i);
   }
 
   return Tensor::create(
-      std::make_shared<TensorShape>(broadcastShape),
+      TensorShape(lut::makeConstSpan(broadcastShape, shape.size())),
       input.getDataShared_(),
       input.getOffset_());
 }
@@ -40,7 +40,7 @@ bool isShapeMatch(const Tensor &A, const Tensor &B);
 template<typename T>
 void copyVector(TensorAccessor<T, 1> dest, TensorAccessor<const T, 1> src) {
   CHECK(dest.getShape(0) == src.getShape(0));
-  for (int i = 0; i < src.getShape(0); ++i) {
+  for (int64_t i = 0; i < src.getShape(0); ++i) {
     dest[i] = src[i];
   }
 }
@@ -0,0 +1,417 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/cpu/cpu_allocator.h"
+
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "lutil/error.h"
+#include "lutil/log.h"
+#include "lutil/platform.h"
+#include "lutil/strings.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+namespace {
+
+constexpr int NumSubClasses = 4;
+constexpr int MinBlockSizeLog2 = 6;
+
+// get the block size and the size class index of `size`. There are NumSubClasses classes in each
+// (2^k, 2^(k+1)].
+int64_t getSizeClass(int64_t size, int *index) {
+  if (size <= CpuAllocator::MinBlockSize) {
+    *index = 0;
+    return CpuAllocator::MinBlockSize;
+  }
+
+  int k = 63 - __builtin_clzll(static_cast<uint64_t>(size - 1));
+  int64_t base = int64_t(1) << k;
+  int64_t step = base / NumSubClasses;
+  int64_t sub = (size - base + step - 1) / step;
+
+  *index = (k - MinBlockSizeLog2) * NumSubClasses + static_cast<int>(sub);
+  return base + sub * step;
+}
+
+// inverse of getSizeClass(): get the block size of size class `index`.
+int64_t getClassBlockSize(int index) {
+  if (index == 0) return CpuAllocator::MinBlockSize;
+
+  int k = (index - 1) / NumSubClasses + MinBlockSizeLog2;
+  int64_t sub = (index - 1) % NumSubClasses + 1;
+  int64_t base = int64_t(1) << k;
+  return base + sub * (base / NumSubClasses);
+}
+
+// the shared part of the allocator. It is never destroyed since the thread caches are flushed
+// into it when the threads exit, which may happen after the static destructors.
+class GlobalCache {
+ public:
+  static GlobalCache *getInstance() {
+    static GlobalCache *instance = new GlobalCache();
+    return instance;
+  }
+
+  std::atomic<int64_t> numAllocs;
+  std::atomic<int64_t> numCacheHits;
+  std::atomic<int64_t> numSystemAllocs;
+  std::atomic<int64_t> numSystemFrees;
+  std::atomic<int64_t> allocatedBytes;
+  std::atomic<int64_t> numCachedBlocks;
+  std::atomic<int64_t> cachedBytes;
+  std::atomic<int64_t> maxCachedBytes;
+
+  std::atomic<int> hugePagePolicy;
+  std::atomic<int64_t> hugePageMinSize;
+  std::atomic<int64_t> numHugePageBlocks;
+  std::atomic<int64_t> hugePageBytes;
+  std::atomic<int64_t> numHugeTlbPages;
+
+  // account a block of `blockSize` into the cache. Returns false if the cap is exceeded.
+  bool reserveCache(int64_t blockSize) {
+    int64_t cached = cachedBytes.fetch_add(blockSize) + blockSize;
+    if (cached > maxCachedBytes.load()) {
+      cachedBytes.fetch_sub(blockSize);
+      return false;
+    }
+
+    numCachedBlocks.fetch_add(1);
+    return true;
+  }
+
+  void releaseCache(int64_t blockSize) {
+    cachedBytes.fetch_sub(blockSize);
+    numCachedBlocks.fetch_sub(1);
+  }
+
+  void *systemAlloc(int64_t blockSize) {
+    void *ptr = allocFromSystem(blockSize);
+    if (!ptr) {
+      // the cached blocks may be the reason of OOM.
+      trim(0);
+      ptr = allocFromSystem(blockSize);
+    }
+    if (!ptr) {
+      throw lut::AbortedError(
+          lut::sprintf("out of memory: failed to allocate %d bytes", blockSize));
+    }
+
+    numSystemAllocs.fetch_add(1);
+    return ptr;
+  }
+
+  void systemFree(void *ptr, int64_t blockSize) {
+    numSystemFrees.fetch_add(1);
+    if (numHugePageBlocks.load() > 0) {
+      std::unique_lock<std::mutex> lock(_hugeMutex);
+      auto it = _hugeBlocks.find(ptr);
+      if (it != _hugeBlocks.end()) {
+        bool isHugeTlb = it->second;
+        _hugeBlocks.erase(it);
+        lock.unlock();
+
+        numHugePageBlocks.fetch_sub(1);
+        hugePageBytes.fetch_sub(blockSize);
+        if (isHugeTlb) numHugeTlbPages.fetch_sub(getNumHugeTlbPages(blockSize));
+        lut::freeHugePageMem(ptr, blockSize, isHugeTlb);
+        return;
+      }
+    }
+
+    lut::free32ByteAlignedMem(ptr);
+  }
+
+  // push a block already accounted by reserveCache().
+  void push(void *ptr, int64_t blockSize) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _freeLists[blockSize].push_back(ptr);
+  }
+
+  void *pop(int64_t blockSize) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _freeLists.find(blockSize);
+    if (it == _freeLists.end() || it->second.empty()) return nullptr;
+
+    void *ptr = it->second.back();
+    it->second.pop_back();
+    releaseCache(blockSize);
+    return ptr;
+  }
+
+  // release the cached blocks in the global free lists until cachedBytes <= `target`.
+  void trim(int64_t target) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _freeLists.begin(); it != _freeLists.end() && cachedBytes.load() > target;) {
+      std::vector<void *> &blocks = it->second;
+      while (!blocks.empty() && cachedBytes.load() > target) {
+        systemFree(blocks.back(), it->first);
+        blocks.pop_back();
+        releaseCache(it->first);
+      }
+
+      it = blocks.empty() ? _freeLists.erase(it) : std::next(it);
+    }
+  }
+
+ private:
+  std::mutex _mutex;
+  std::unordered_map<int64_t, std::vector<void *>> _freeLists;
+
+  // blocks allocated by lut::allocHugePageMem(), and whether they are from MAP_HUGETLB.
+  std::mutex _hugeMutex;
+  std::unordered_map<void *, bool> _hugeBlocks;
+  std::atomic<bool> _hugeTlbWarned;
+
+  static int64_t getNumHugeTlbPages(int64_t blockSize) {
+    return (blockSize + lut::HugePageSize - 1) / lut::HugePageSize;
+  }
+
+  void *allocFromSystem(int64_t blockSize) {
+    HugePagePolicy policy = static_cast<HugePagePolicy>(hugePagePolicy.load());
+    if (policy == HugePagePolicy::kDisabled || blockSize < hugePageMinSize.load()) {
+      return lut::alloc32ByteAlignedMem(blockSize);
+    }
+
+    bool isHugeTlb = false;
+    void *ptr = lut::allocHugePageMem(blockSize, policy == HugePagePolicy::kHugeTlb, &isHugeTlb);
+    if (!ptr) return lut::alloc32ByteAlignedMem(blockSize);
+
+    if (policy == HugePagePolicy::kHugeTlb && !isHugeTlb && !_hugeTlbWarned.exchange(true)) {
+      LOG(WARN) << "no reserved huge page available, fall back to transparent huge pages.";
+    }
+
+    std::lock_guard<std::mutex> lock(_hugeMutex);
+    _hugeBlocks[ptr] = isHugeTlb;
+    numHugePageBlocks.fetch_add(1);
+    hugePageBytes.fetch_add(blockSize);
+    if (isHugeTlb) numHugeTlbPages.fetch_add(getNumHugeTlbPages(blockSize));
+
+    return ptr;
+  }
+
+  GlobalCache()
+      : numAllocs(0),
+        numCacheHits(0),
+        numSystemAllocs(0),
+        numSystemFrees(0),
+        allocatedBytes(0),
+        numCachedBlocks(0),
+        cachedBytes(0),
+        maxCachedBytes(CpuAllocator::DefaultMaxCachedBytes),
+        hugePagePolicy(static_cast<int>(HugePagePolicy::kDisabled)),
+        hugePageMinSize(CpuAllocator::DefaultHugePageMinSize),
+        numHugePageBlocks(0),
+        hugePageBytes(0),
+        numHugeTlbPages(0),
+        _hugeTlbWarned(false) {
+  }
+};
+
+// lock-free cache of small blocks for each thread.
+class ThreadCache {
+ public:
+  static constexpr int NumClasses = 41;
+
+  ThreadCache();
+  ~ThreadCache();
+
+  std::vector<void *> &getFreeList(int index) {
+    return _freeLists[index];
+  }
+
+  // move all the blocks into the global cache.
+  void flush();
+
+ private:
+  std::vector<void *> _freeLists[NumClasses];
+};
+
+// ThreadCache may be used after destroyed in the destructors of other thread_local objects.
+// `gThreadCacheAlive` is trivially destructible, so it is always safe to check.
+thread_local bool gThreadCacheAlive = false;
+thread_local ThreadCache gThreadCache;
+
+ThreadCache::ThreadCache() {
+  gThreadCacheAlive = true;
+}
+
+ThreadCache::~ThreadCache() {
+  flush();
+  gThreadCacheAlive = false;
+}
+
+void ThreadCache::flush() {
+  GlobalCache *global = GlobalCache::getInstance();
+  for (int i = 0; i < NumClasses; ++i) {
+    for (void *ptr : _freeLists[i]) {
+      global->push(ptr, getClassBlockSize(i));
+    }
+    _freeLists[i].clear();
+  }
+}
+
+// get the thread cache of current thread, or nullptr if `blockSize` is not cached by threads or
+// the cache is not available.
+ThreadCache *getThreadCache(int64_t blockSize) {
+  if (blockSize > CpuAllocator::MaxThreadCachedSize) return nullptr;
+
+  // force the initialization of gThreadCache on the first access.
+  if (!gThreadCacheAlive) {
+    ThreadCache *tc = &gThreadCache;
+    return gThreadCacheAlive ? tc : nullptr;
+  }
+  return &gThreadCache;
+}
+
+}  // namespace
+
+CpuAllocatorStats::CpuAllocatorStats()
+    : numAllocs(0),
+      numCacheHits(0),
+      numSystemAllocs(0),
+      numSystemFrees(0),
+      allocatedBytes(0),
+      numCachedBlocks(0),
+      cachedBytes(0),
+      numHugePageBlocks(0),
+      hugePageBytes(0),
+      numHugeTlbPages(0) {
+}
+
+void *CpuAllocator::allocate(int64_t size) {
+  CHECK(size >= 0);
+  GlobalCache *global = GlobalCache::getInstance();
+
+  int index;
+  int64_t blockSize = getSizeClass(size, &index);
+  global->numAllocs.fetch_add(1);
+  global->allocatedBytes.fetch_add(blockSize);
+
+  void *ptr = nullptr;
+  ThreadCache *tc = getThreadCache(blockSize);
+  if (tc && !tc->getFreeList(index).empty()) {
+    ptr = tc->getFreeList(index).back();
+    tc->getFreeList(index).pop_back();
+    global->releaseCache(blockSize);
+  } else {
+    ptr = global->pop(blockSize);
+  }
+
+  if (ptr) {
+    global->numCacheHits.fetch_add(1);
+    return ptr;
+  }
+
+  try {
+    return global->systemAlloc(blockSize);
+  } catch (const lut::AbortedError &) {
+    global->allocatedBytes.fetch_sub(blockSize);
+    throw;
+  }
+}
+
+void CpuAllocator::free(void *ptr, int64_t size) {
+  if (!ptr) return;
+  GlobalCache *global = GlobalCache::getInstance();
+
+  int index;
+  int64_t blockSize = getSizeClass(size, &index);
+  global->allocatedBytes.fetch_sub(blockSize);
+
+  if (!global->reserveCache(blockSize)) {
+    global->systemFree(ptr, blockSize);
+    return;
+  }
+
+  ThreadCache *tc = getThreadCache(blockSize);
+  if (tc && tc->getFreeList(index).size() < MaxThreadCachedBlocksPerClass) {
+    tc->getFreeList(index).push_back(ptr);
+  } else {
+    global->push(ptr, blockSize);
+  }
+}
+
+int64_t CpuAllocator::getBlockSize(int64_t size) {
+  int index;
+  return getSizeClass(size, &index);
+}
+
+void CpuAllocator::setMaxCachedBytes(int64_t maxCachedBytes) {
+  CHECK(maxCachedBytes >= 0);
+  GlobalCache *global = GlobalCache::getInstance();
+  global->maxCachedBytes.store(maxCachedBytes);
+  global->trim(maxCachedBytes);
+}
+
+int64_t CpuAllocator::getMaxCachedBytes() {
+  return GlobalCache::getInstance()->maxCachedBytes.load();
+}
+
+void CpuAllocator::setHugePagePolicy(HugePagePolicy policy, int64_t minSize) {
+  CHECK(minSize >= 0);
+  GlobalCache *global = GlobalCache::getInstance();
+  global->hugePagePolicy.store(static_cast<int>(policy));
+  global->hugePageMinSize.store(minSize);
+}
+
+HugePagePolicy CpuAllocator::getHugePagePolicy() {
+  return static_cast<HugePagePolicy>(GlobalCache::getInstance()->hugePagePolicy.load());
+}
+
+int64_t CpuAllocator::getNumHugePages() {
+  int64_t numPages = GlobalCache::getInstance()->numHugeTlbPages.load();
+  int64_t numTransparentPages = lut::getNumProcessTransparentHugePages();
+  if (numTransparentPages > 0) numPages += numTransparentPages;
+
+  return numPages;
+}
+
+void CpuAllocator::trim() {
+  if (gThreadCacheAlive) gThreadCache.flush();
+  GlobalCache::getInstance()->trim(0);
+}
+
+CpuAllocatorStats CpuAllocator::getStats() {
+  GlobalCache *global = GlobalCache::getInstance();
+
+  CpuAllocatorStats stats;
+  stats.numAllocs = global->numAllocs.load();
+  stats.numCacheHits = global->numCacheHits.load();
+  stats.numSystemAllocs = global->numSystemAllocs.load();
+  stats.numSystemFrees = global->numSystemFrees.load();
+  stats.allocatedBytes = global->allocatedBytes.load();
+  stats.numCachedBlocks = global->numCachedBlocks.load();
+  stats.cachedBytes = global->cachedBytes.load();
+  stats.numHugePageBlocks = global->numHugePageBlocks.load();
+  stats.hugePageBytes = global->hugePageBytes.load();
+  stats.numHugeTlbPages = global->numHugeTlbPages.load();
+
+  return stats;
+}
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
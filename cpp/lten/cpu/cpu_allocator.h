@@ -0,0 +1,133 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+/// @brief Counters of the CPU caching allocator.
+struct CpuAllocatorStats {
+  /// @brief number of allocate() calls.
+  int64_t numAllocs;
+
+  /// @brief number of allocations served by the cache (including the per-thread caches).
+  int64_t numCacheHits;
+
+  /// @brief number of blocks allocated from or released to the system.
+  int64_t numSystemAllocs;
+  int64_t numSystemFrees;
+
+  /// @brief bytes of the blocks in use, rounded up to the size classes.
+  int64_t allocatedBytes;
+
+  /// @brief number and bytes of the free blocks kept in the cache.
+  int64_t numCachedBlocks;
+  int64_t cachedBytes;
+
+  /// @brief number and bytes of the blocks held from the system with huge page policy.
+  int64_t numHugePageBlocks;
+  int64_t hugePageBytes;
+
+  /// @brief number of reserved huge pages (MAP_HUGETLB) held by the allocator.
+  int64_t numHugeTlbPages;
+
+  CpuAllocatorStats();
+};
+
+/// @brief How the large blocks are allocated from the system.
+enum class HugePagePolicy {
+  /// @brief regular aligned allocation.
+  kDisabled,
+
+  /// @brief 2MB aligned mapping advised with MADV_HUGEPAGE, which is backed by transparent huge
+  /// pages when THP is enabled in "always" or "madvise" mode.
+  kTransparent,
+
+  /// @brief the reserved huge pages (MAP_HUGETLB, see /proc/sys/vm/nr_hugepages). Falls back to
+  /// kTransparent when no reserved page is available.
+  kHugeTlb
+};
+
+/// @brief Caching allocator for the CPU tensor data. Requested sizes are rounded up to size
+/// classes (4 classes per power of 2). Freed blocks are kept in a free list per size class instead
+/// of being returned to the system, so the intermediate tensors of the next step reuse them
+/// without the mmap/munmap and page faults of the system allocator.
+///
+/// Small blocks (<= MaxThreadCachedSize) are first cached in a per-thread cache which needs no
+/// lock. The total size of cached blocks is bounded by the retention cap, freed blocks beyond the
+/// cap are released to the system directly.
+///
+/// Blocks not smaller than the huge page threshold are typically weights, KV cache blocks and
+/// arena chunks. They are allocated with the huge page policy to reduce the TLB misses of the
+/// random access in GEMV. The policy is kDisabled by default, since huge pages change the memory
+/// footprint of the whole process.
+///
+/// All the blocks are 32-byte aligned. The allocator is thread-safe.
+class CpuAllocator {
+ public:
+  static constexpr int64_t Alignment = 32;
+  static constexpr int64_t MinBlockSize = 64;
+  static constexpr int64_t MaxThreadCachedSize = 65536;
+  static constexpr int MaxThreadCachedBlocksPerClass = 8;
+  static constexpr int64_t DefaultMaxCachedBytes = 1073741824;
+  static constexpr int64_t DefaultHugePageMinSize = 2097152;
+
+  /// @brief Allocate a block with at least `size` bytes.
+  static void *allocate(int64_t size);
+
+  /// @brief Free a block from allocate().
+  /// @param ptr the block.
+  /// @param size the size requested in allocate().
+  static void free(void *ptr, int64_t size);
+
+  /// @brief Get the actual size of the block for the requested size.
+  static int64_t getBlockSize(int64_t size);
+
+  /// @brief Set the upper bound of bytes of cached blocks. 0 disables the caching. Cached blocks
+  /// beyond the new cap are released immediately.
+  static void setMaxCachedBytes(int64_t maxCachedBytes);
+  static int64_t getMaxCachedBytes();
+
+  /// @brief Set the huge page policy for the blocks allocated from now on. It is expected to be
+  /// called at initialization, before the weights are loaded. Default is kDisabled.
+  /// @param policy the policy.
+  /// @param minSize blocks smaller than `minSize` bytes always use regular allocation.
+  static void setHugePagePolicy(HugePagePolicy policy, int64_t minSize = DefaultHugePageMinSize);
+  static HugePagePolicy getHugePagePolicy();
+
+  /// @brief Get the number of huge pages obtained: the reserved huge pages held by the allocator
+  /// plus the transparent huge pages of the whole process. The latter also counts the anonymous
+  /// memory not allocated by CpuAllocator, like the heap of malloc() and the thread stacks.
+  static int64_t getNumHugePages();
+
+  /// @brief Release the cached blocks to the system. Per-thread caches of other threads are not
+  /// touched, they are flushed when the threads exit.
+  static void trim();
+
+  /// @brief Get the statistics of the allocator.
+  static CpuAllocatorStats getStats();
+};
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
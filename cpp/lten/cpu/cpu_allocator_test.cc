@@ -0,0 +1,155 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/cpu/cpu_allocator.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <thread>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "lten/functional.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+CATCH_TEST_CASE("test CpuAllocator size classes", "[core][cpu_allocator]") {
+  CATCH_REQUIRE(CpuAllocator::getBlockSize(1) == 64);
+  CATCH_REQUIRE(CpuAllocator::getBlockSize(64) == 64);
+  CATCH_REQUIRE(CpuAllocator::getBlockSize(65) == 80);
+  CATCH_REQUIRE(CpuAllocator::getBlockSize(128) == 128);
+  CATCH_REQUIRE(CpuAllocator::getBlockSize(129) == 160);
+  CATCH_REQUIRE(CpuAllocator::getBlockSize(1000000) == 1048576);
+  CATCH_REQUIRE(CpuAllocator::getBlockSize(1048577) == 1310720);
+
+  // at most 25% of waste.
+  for (int64_t size = 65; size < 100000; size += 997) {
+    CATCH_REQUIRE(CpuAllocator::getBlockSize(size) >= size);
+    CATCH_REQUIRE(CpuAllocator::getBlockSize(size) * 4 < size * 5);
+  }
+}
+
+CATCH_TEST_CASE("test CpuAllocator cache", "[core][cpu_allocator]") {
+  CpuAllocator::trim();
+  CpuAllocatorStats stats0 = CpuAllocator::getStats();
+
+  // small block from the thread cache, large block from the global cache.
+  for (int64_t size : {int64_t(1000), int64_t(10000000)}) {
+    void *ptr = CpuAllocator::allocate(size);
+    CATCH_REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 32 == 0);
+    CpuAllocator::free(ptr, size);
+    CATCH_REQUIRE(
+        CpuAllocator::getStats().cachedBytes - stats0.cachedBytes ==
+        CpuAllocator::getBlockSize(size));
+
+    void *ptr1 = CpuAllocator::allocate(size - 1);
+    CATCH_REQUIRE(ptr1 == ptr);
+    CpuAllocator::free(ptr1, size - 1);
+    CpuAllocator::trim();
+  }
+
+  CpuAllocatorStats stats = CpuAllocator::getStats();
+  CATCH_REQUIRE(stats.numAllocs - stats0.numAllocs == 4);
+  CATCH_REQUIRE(stats.numCacheHits - stats0.numCacheHits == 2);
+  CATCH_REQUIRE(stats.numSystemAllocs - stats0.numSystemAllocs == 2);
+  CATCH_REQUIRE(stats.numSystemFrees - stats0.numSystemFrees == 2);
+  CATCH_REQUIRE(stats.allocatedBytes == stats0.allocatedBytes);
+  CATCH_REQUIRE(stats.cachedBytes == stats0.cachedBytes);
+}
+
+CATCH_TEST_CASE("test CpuAllocator retention cap", "[core][cpu_allocator]") {
+  int64_t maxCachedBytes = CpuAllocator::getMaxCachedBytes();
+  CpuAllocator::trim();
+  CpuAllocatorStats stats0 = CpuAllocator::getStats();
+
+  // blocks in the per-thread caches of other threads are also counted.
+  CpuAllocator::setMaxCachedBytes(stats0.cachedBytes + (4 << 20));
+  void *ptr0 = CpuAllocator::allocate(3 << 20);
+  void *ptr1 = CpuAllocator::allocate(3 << 20);
+  CpuAllocator::free(ptr0, 3 << 20);
+  CpuAllocator::free(ptr1, 3 << 20);
+  CATCH_REQUIRE(CpuAllocator::getStats().numCachedBlocks - stats0.numCachedBlocks == 1);
+
+  // shrink the cap.
+  CpuAllocator::setMaxCachedBytes(0);
+  CATCH_REQUIRE(CpuAllocator::getStats().cachedBytes <= stats0.cachedBytes);
+
+  CpuAllocator::setMaxCachedBytes(maxCachedBytes);
+}
+
+CATCH_TEST_CASE("test CpuAllocator thread cache", "[core][cpu_allocator]") {
+  CpuAllocator::trim();
+  CpuAllocatorStats stats0 = CpuAllocator::getStats();
+
+  // blocks in the cache of exited thread go to the global cache.
+  std::thread thread([]() {
+    for (int i = 0; i < 100; ++i) {
+      Tensor x = F::zeros({16, 16}, DType::kFloat);
+    }
+  });
+  thread.join();
+
+  CpuAllocatorStats stats = CpuAllocator::getStats();
+  CATCH_REQUIRE(stats.numCachedBlocks - stats0.numCachedBlocks == 1);
+  CATCH_REQUIRE(stats.cachedBytes - stats0.cachedBytes == 1024);
+
+  void *ptr = CpuAllocator::allocate(1024);
+  CATCH_REQUIRE(CpuAllocator::getStats().numCachedBlocks == stats0.numCachedBlocks);
+  CpuAllocator::free(ptr, 1024);
+  CpuAllocator::trim();
+}
+
+CATCH_TEST_CASE("test CpuAllocator huge page policy", "[core][cpu_allocator]") {
+  HugePagePolicy policy = CpuAllocator::getHugePagePolicy();
+  CATCH_REQUIRE(policy == HugePagePolicy::kDisabled);
+  CpuAllocator::trim();
+
+  for (HugePagePolicy p : {HugePagePolicy::kTransparent, HugePagePolicy::kHugeTlb}) {
+    CpuAllocator::setHugePagePolicy(p, 4 << 20);
+    CpuAllocatorStats stats0 = CpuAllocator::getStats();
+
+    // small blocks use the regular allocation.
+    void *ptr0 = CpuAllocator::allocate(1 << 20);
+    CATCH_REQUIRE(CpuAllocator::getStats().numHugePageBlocks == stats0.numHugePageBlocks);
+
+    int64_t size = (5 << 20) + 100;
+    int8_t *ptr1 = reinterpret_cast<int8_t *>(CpuAllocator::allocate(size));
+    CATCH_REQUIRE(reinterpret_cast<uintptr_t>(ptr1) % (2 << 20) == 0);
+    memset(ptr1, 1, size);
+
+    CpuAllocatorStats stats = CpuAllocator::getStats();
+    CATCH_REQUIRE(stats.numHugePageBlocks - stats0.numHugePageBlocks == 1);
+    CATCH_REQUIRE(stats.hugePageBytes - stats0.hugePageBytes == CpuAllocator::getBlockSize(size));
+    CATCH_REQUIRE(CpuAllocator::getNumHugePages() >= stats.numHugeTlbPages);
+
+    CpuAllocator::free(ptr0, 1 << 20);
+    CpuAllocator::free(ptr1, size);
+    CpuAllocator::trim();
+    CATCH_REQUIRE(CpuAllocator::getStats().numHugePageBlocks == stats0.numHugePageBlocks);
+    CATCH_REQUIRE(CpuAllocator::getStats().numHugeTlbPages == stats0.numHugeTlbPages);
+  }
+
+  CpuAllocator::setHugePagePolicy(policy);
+}
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
@@ -39,6 +39,7 @@
 #include "lten/cpu/lookup.h"
 #include "lten/cpu/matmul.h"
 #include "lten/cpu/normalizations.h"
+#include "lten/cpu/paged_attention.h"
 #include "lten/cpu/print.h"
 #include "lten/cpu/rand.h"
 #include "lten/cpu/reduce.h"
@@ -58,7 +59,7 @@ namespace cpu {
 CPUOperators::CPUOperators() {
 }
 
-Tensor CPUOperators::tensor(lut::Span<const int> shape, DType dtype) {
+Tensor CPUOperators::tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype) {
   return op::cpu::tensor(shape, dtype);
 }
 
@@ -69,7 +70,7 @@ Tensor CPUOperators::tensorLike(Tensor input) {
 // -- class CPUOperators ----------
 
 Tensor CPUOperators::rand(
-    lut::Span<const int> shape,
+    lut::Span<const Tensor::ShapeType> shape,
     DType dtype,
     lut::Random *generator,
     float min,
@@ -77,7 +78,7 @@ Tensor CPUOperators::rand(
   return op::cpu::rand(shape, dtype, generator, min, max);
 }
 
-Tensor CPUOperators::zeros(lut::Span<const int> shape, DType dtype) {
+Tensor CPUOperators::zeros(lut::Span<const Tensor::ShapeType> shape, DType dtype) {
   return op::cpu::zeros(shape, dtype);
 }
 
@@ -90,11 +91,11 @@ void CPUOperators::print(Tensor tensor) {
 }
 
 Tensor CPUOperators::add(Tensor input, Tensor other) {
-  return cpu::binaryOp(input, other, BinaryOp::ADD);
+  return cpu::binaryOp(std::move(input), other, BinaryOp::ADD);
 }
 
 Tensor CPUOperators::softmax(Tensor input) {
-  return cpu::softmax(input);
+  return cpu::softmax(std::move(input));
 }
 
 bool CPUOperators::allClose(Tensor A, Tensor B, float rtol, float atol) {
@@ -102,11 +103,11 @@ bool CPUOperators::allClose(Tensor A, Tensor B, float rtol, float atol) {
 }
 
 Tensor CPUOperators::mul(Tensor A, float k) {
-  return op::cpu::transform(A, k, 0.0f);
+  return op::cpu::transform(std::move(A), k, 0.0f);
 }
 
 Tensor CPUOperators::mul(Tensor A, Tensor B) {
-  return op::cpu::binaryOp(A, B, BinaryOp::MUL);
+  return op::cpu::binaryOp(std::move(A), B, BinaryOp::MUL);
 }
 
 Tensor CPUOperators::lookup(Tensor table, Tensor indices) {
@@ -114,7 +115,7 @@ Tensor CPUOperators::lookup(Tensor table, Tensor indices) {
 }
 
 Tensor CPUOperators::gelu(Tensor input) {
-  return cpu::gelu(input);
+  return cpu::gelu(std::move(input));
 }
 
 void CPUOperators::fill(Tensor input, float value) {
@@ -175,6 +176,33 @@ Tensor CPUOperators::unfold(Tensor input, int kernelSize, int stride) {
   return cpu::unfold(input, kernelSize, stride);
 }
 
+Tensor CPUOperators::varlenAttention(
+    Tensor q,
+    Tensor k,
+    Tensor v,
+    Tensor cuSeqlensQ,
+    Tensor cuSeqlensK) {
+  DType dtype = q.getDType();
+  if (dtype != DType::kFloat) {
+    q = cpu::cast(q, DType::kFloat);
+    k = cpu::cast(k, DType::kFloat);
+    v = cpu::cast(v, DType::kFloat);
+  }
+  if (!k.isContiguous()) {
+    Tensor x = cpu::tensorLike(k);
+    cpu::copy(k, x);
+    k = x;
+  }
+  if (!v.isContiguous()) {
+    Tensor x = cpu::tensorLike(v);
+    cpu::copy(v, x);
+    v = x;
+  }
+
+  Tensor x = cpu::varlenAttention(q, k, v, cuSeqlensQ, cuSeqlensK);
+  return dtype == DType::kFloat ? x : cpu::cast(x, dtype);
+}
+
 Tensor CPUOperators::cast(Tensor tensor, DType dtype) {
   return cpu::cast(tensor, dtype);
 }
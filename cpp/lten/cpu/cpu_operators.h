@@ -58,18 +58,24 @@ class CPUOperators : public Operators {
   Tensor mul(Tensor input, float other) override;
   Tensor mul(Tensor input, Tensor other) override;
   void print(Tensor tensor) override;
-  Tensor rand(lut::Span<const int> shape, DType dtype, lut::Random *generator, float min, float max)
-      override;
+  Tensor rand(
+      lut::Span<const Tensor::ShapeType> shape,
+      DType dtype,
+      lut::Random *generator,
+      float min,
+      float max) override;
   void repetitionPenalty(Tensor logits, Tensor history, float weight) override;
   Tensor rmsNorm(Tensor input, Tensor weight, float eps) override;
   Tensor softmax(Tensor input) override;
   Tensor sum(Tensor inputs) override;
   Tensor swiglu(Tensor A) override;
-  Tensor tensor(lut::Span<const int> shape, DType dtype) override;
+  Tensor tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype) override;
   Tensor tensorLike(Tensor input) override;
   Tensor to(Device device, Tensor tensor) override;
   Tensor unfold(Tensor input, int kernelSize, int stride) override;
-  Tensor zeros(lut::Span<const int> shape, DType dtype) override;
+  Tensor varlenAttention(Tensor q, Tensor k, Tensor v, Tensor cuSeqlensQ, Tensor cuSeqlensK)
+      override;
+  Tensor zeros(lut::Span<const Tensor::ShapeType> shape, DType dtype) override;
 
   DType getDefaultFloatType() override;
 
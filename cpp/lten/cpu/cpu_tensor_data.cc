@@ -19,10 +19,15 @@
 
 #include "lten/cpu/cpu_tensor_data.h"
 
+#include <stdint.h>
+#include <string.h>
+
+#include "lten/cpu/arena.h"
+#include "lten/cpu/cpu_allocator.h"
 #include "lten/device.h"
 #include "lten/dtype.h"
+#include "lten/memory_stats.h"
 #include "lutil/error.h"
-#include "lutil/platform.h"
 #include "lutil/span.h"
 
 namespace lten {
@@ -32,7 +37,8 @@ namespace cpu {
 CpuTensorData::Slot::Slot()
     : data(nullptr),
       numel(0),
-      dtype(DType::kUnknown) {
+      dtype(DType::kUnknown),
+      mapped(false) {
 }
 
 int64_t CpuTensorData::Slot::getNumEl() const {
@@ -46,7 +52,10 @@ Byte *CpuTensorData::Slot::getRawData() const {
 }
 
 CpuTensorData::CpuTensorData()
-    : _numSlot(0) {
+    : _numSlot(0),
+      _arena(nullptr),
+      _arenaIndex(-1),
+      _external(false) {
 }
 
 void CpuTensorData::readSlot(lut::Reader *fp, int slotIdx) {
@@ -62,10 +71,36 @@ void CpuTensorData::readSlot(lut::Reader *fp, int slotIdx) {
   if (slot.numel > MaxNumEl) throw lut::AbortedError("tensor too big");
 
   int64_t size = slot.dtype.getTotalSize(slot.numel);
-  slot.data = reinterpret_cast<Byte *>(lut::alloc32ByteAlignedMem(size));
-  fp->readSpan(lut::makeSpan(reinterpret_cast<int8_t *>(slot.data), size));
+  _numSlot = slotIdx + 1;
+
+  // for the stored entries in a mapped zip file, point to the data in place if it is aligned as
+  // the blocks from CpuAllocator. It saves both the allocation and the copy, and the pages are
+  // shared with the page cache.
+  int64_t offset = 0;
+  std::shared_ptr<lut::MappedFile> mappedFile = fp->getMappedFile(&offset);
+  if (mappedFile && offset + size <= static_cast<int64_t>(mappedFile->getData().size())) {
+    const int8_t *data = mappedFile->getData().data() + offset;
+    if (reinterpret_cast<uintptr_t>(data) % CpuAllocator::Alignment == 0) {
+      slot.data = reinterpret_cast<Byte *>(const_cast<int8_t *>(data));
+      slot.mapped = true;
+      _mappedFile = mappedFile;
+      fp->skip(size);
+    }
+  }
+
+  if (!slot.mapped) {
+    slot.data = reinterpret_cast<Byte *>(CpuAllocator::allocate(size));
+    recordTensorDataAlloc(Device::kCpu, size);
+    fp->readSpan(lut::makeSpan(reinterpret_cast<int8_t *>(slot.data), size));
+  }
   int magicNumber = fp->readValue<int16_t>();
-  if (magicNumber != 0x55aa) throw lut::AbortedError("bad tensor data format (magic number).");
+  if (magicNumber == SlotMagicCrc32c) {
+    // the checksum is checked by verifyModel(). Checking it here would fault in all the mapped
+    // pages on every load.
+    fp->readValue<uint32_t>();
+  } else if (magicNumber != SlotMagic) {
+    throw lut::AbortedError("bad tensor data format (magic number).");
+  }
 }
 
 std::shared_ptr<TensorData> CpuTensorData::create(int64_t numel, DType dtype) {
@@ -77,13 +112,15 @@ std::shared_ptr<TensorData> CpuTensorData::create(
   CHECK(slots.size() > 0 && slots.size() <= TensorData::MaxSlot);
 
   auto tensorData = std::make_shared<CpuTensorData>();
+  Arena *arena = Arena::getCurrent();
   for (const std::pair<int64_t, DType> &slotSpec : slots) {
     int64_t numel = slotSpec.first;
     DType dtype = slotSpec.second;
 
     CHECK(numel > 0);
     int64_t size = dtype.getTotalSize(numel);
-    void *data = lut::alloc32ByteAlignedMem(size);
+    void *data = arena ? arena->allocate(size) : CpuAllocator::allocate(size);
+    recordTensorDataAlloc(Device::kCpu, size);
     tensorData->_slots[tensorData->_numSlot].data = reinterpret_cast<Byte *>(data);
     tensorData->_slots[tensorData->_numSlot].numel = numel;
     tensorData->_slots[tensorData->_numSlot].dtype = dtype;
@@ -91,6 +128,29 @@ std::shared_ptr<TensorData> CpuTensorData::create(
     ++tensorData->_numSlot;
   }
 
+  if (arena) {
+    tensorData->_arena = arena;
+    tensorData->_arenaIndex = arena->track(tensorData.get());
+  }
+
+  return tensorData;
+}
+
+std::shared_ptr<TensorData> CpuTensorData::createFromPtr(
+    int64_t numel,
+    DType dtype,
+    Byte *data,
+    std::function<void()> deleter) {
+  CHECK(numel > 0 && data);
+
+  auto tensorData = std::make_shared<CpuTensorData>();
+  tensorData->_slots[0].data = data;
+  tensorData->_slots[0].numel = numel;
+  tensorData->_slots[0].dtype = dtype;
+  tensorData->_numSlot = 1;
+  tensorData->_external = true;
+  tensorData->_deleter = std::move(deleter);
+
   return tensorData;
 }
 
@@ -118,10 +178,38 @@ const SlotBase *CpuTensorData::getSlot(int slot) const {
   return &_slots[slot];
 }
 
+void CpuTensorData::promote() {
+  CHECK(_arena.load());
+  for (int i = 0; i < _numSlot; ++i) {
+    int64_t size = _slots[i].getSizeInBytes();
+    Byte *data = reinterpret_cast<Byte *>(CpuAllocator::allocate(size));
+    memcpy(data, _slots[i].data, size);
+    _slots[i].data = data;
+  }
+
+  _arena = nullptr;
+  _arenaIndex = -1;
+}
+
 CpuTensorData::~CpuTensorData() {
+  if (_external) {
+    if (_deleter) _deleter();
+    return;
+  }
+
   for (int i = 0; i < _numSlot; ++i) {
-    if (_slots[i].data) {
-      lut::free32ByteAlignedMem(_slots[i].data);
+    if (_slots[i].data && !_slots[i].mapped) {
+      recordTensorDataFree(Device::kCpu, _slots[i].getSizeInBytes());
+    }
+  }
+
+  // the memory is released by the arena, unless the data was promoted before untrack().
+  Arena *arena = _arena.load();
+  if (arena && arena->untrack(this)) return;
+
+  for (int i = 0; i < _numSlot; ++i) {
+    if (_slots[i].data && !_slots[i].mapped) {
+      CpuAllocator::free(_slots[i].data, _slots[i].getSizeInBytes());
       _slots[i].data = nullptr;
     }
   }
@@ -131,6 +219,10 @@ Device CpuTensorData::getDevice() const {
   return Device(Device::Type::kCpu);
 }
 
+bool CpuTensorData::isExternal() const {
+  return _external || _mappedFile;
+}
+
 int CpuTensorData::getNumSlot() const {
   return _numSlot;
 }
@@ -19,20 +19,40 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+
 #include "lten/device.h"
 #include "lten/tensor.h"
+#include "lutil/mapped_file.h"
 #include "lutil/span.h"
 
 namespace lten {
 namespace op {
 namespace cpu {
 
+class Arena;
+
 class CpuTensorData : public TensorData {
  public:
+  /// @brief Footer after the data of each slot in the tensor file. SlotMagicCrc32c is followed by
+  /// the uint32 CRC-32C of the slot data.
+  static constexpr int16_t SlotMagic = 0x55aa;
+  static constexpr int16_t SlotMagicCrc32c = 0x55ab;
+
   static std::shared_ptr<TensorData> create(int64_t numel0, DType dtype0);
   static std::shared_ptr<TensorData> create(lut::Span<const std::pair<int64_t, DType>> slots);
   static std::shared_ptr<TensorData> read(lut::Reader *fp);
 
+  /// @brief Create a tensor data with one slot that borrows the external memory `data` of `numel`
+  /// elements without copying. `deleter` (could be empty) is called when the tensor data is
+  /// destroyed. The external memory is not counted in the memory stats.
+  static std::shared_ptr<TensorData> createFromPtr(
+      int64_t numel,
+      DType dtype,
+      Byte *data,
+      std::function<void()> deleter);
+
   /// @brief Create a new instance of CpuTensorData with the same size and slots as `tensorData`.
   /// @param tensorData The reference tensorData object.
   /// @return A new instance of CpuTensorData.
@@ -42,6 +62,7 @@ class CpuTensorData : public TensorData {
   ~CpuTensorData();
 
   Device getDevice() const override;
+  bool isExternal() const override;
   int getNumSlot() const override;
   const SlotBase *getSlot(int slot) const override;
 
@@ -51,6 +72,9 @@ class CpuTensorData : public TensorData {
     int64_t numel;
     DType dtype;
 
+    // true if data points into _mappedFile instead of a block from CpuAllocator.
+    bool mapped;
+
     Slot();
 
     int64_t getNumEl() const override;
@@ -58,10 +82,30 @@ class CpuTensorData : public TensorData {
     Byte *getRawData() const override;
   };
 
+  friend class Arena;
+
   Slot _slots[TensorData::MaxSlot];
   int _numSlot;
 
+  // the arena that slots are allocated from, nullptr if allocated from CpuAllocator. It is reset
+  // by the promotion in the owning thread of arena, while the tensor data may be destroyed in
+  // other threads, so it is only trusted under the mutex of arena.
+  std::atomic<Arena *> _arena;
+  int _arenaIndex;
+
+  // true if the slot borrows external memory, which is released by _deleter.
+  bool _external;
+  std::function<void()> _deleter;
+
+  // the model file that the mapped slots point into. The mapping is read-only, so the tensor data
+  // with mapped slots is also treated as external.
+  std::shared_ptr<lut::MappedFile> _mappedFile;
+
   void readSlot(lut::Reader *fp, int slotIdx);
+
+  // move the slots out of the arena into the blocks from CpuAllocator. Called by the arena with its
+  // mutex held.
+  void promote();
 };
 
 }  // namespace cpu
@@ -35,7 +35,7 @@ void fillKernel(Tensor A, float value) {
   MP::parallelFor(vC.getLength(), [&vC, value](MP::Context ctx) {
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
-    for (int i = 0; i < c.getShape(0); ++i) {
+    for (int64_t i = 0; i < c.getShape(0); ++i) {
       c[i] = value;
     }
   });
@@ -29,7 +29,7 @@ namespace op {
 namespace cpu {
 
 template<typename T>
-T getFingerprintElem(Tensor A, int d0) {
+T getFingerprintElem(Tensor A, Tensor::ShapeType d0) {
   d0 = d0 > 0 ? std::min(d0, A.getShape(0) - 1) : std::max(d0, -A.getShape(0));
   if (d0 < 0) {
     d0 = A.getShape(0) + d0;
@@ -41,19 +41,19 @@ T getFingerprintElem(Tensor A, int d0) {
 }
 
 template<typename T>
-T getFingerprintElem(Tensor A, int d0, int d1) {
+T getFingerprintElem(Tensor A, Tensor::ShapeType d0, int d1) {
   d0 = d0 > 0 ? std::min(d0, A.getShape(0) - 1) : std::max(d0, -A.getShape(0));
   return getFingerprintElem<T>(A.subtensor(d0), d1);
 }
 
 template<typename T>
-T getFingerprintElem(Tensor A, int d0, int d1, int d2) {
+T getFingerprintElem(Tensor A, Tensor::ShapeType d0, int d1, int d2) {
   d0 = d0 > 0 ? std::min(d0, A.getShape(0) - 1) : std::max(d0, -A.getShape(0));
   return getFingerprintElem<T>(A.subtensor(d0), d1, d2);
 }
 
 template<typename T>
-T getFingerprintElem(Tensor A, int d0, int d1, int d2, int d3) {
+T getFingerprintElem(Tensor A, Tensor::ShapeType d0, int d1, int d2, int d3) {
   d0 = d0 > 0 ? std::min(d0, A.getShape(0) - 1) : std::max(d0, -A.getShape(0));
   return getFingerprintElem<T>(A.subtensor(d0), d1, d2, d3);
 }
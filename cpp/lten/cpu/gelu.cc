@@ -33,8 +33,8 @@ namespace cpu {
 constexpr float Sqrt2 = 1.4142136f;
 
 template<typename T>
-Tensor geluKernel(const Tensor &A) {
-  Tensor C = tensor(A.getShape(), DType::getType<T>());
+Tensor geluKernel(Tensor A) {
+  Tensor C = tensorLikeOrReuse(A);
 
   TensorList<const T, 1> vA = TensorList<const T, 1>::fromTensor(A);
   TensorList<T, 1> vC = TensorList<T, 1>::fromTensor(C);
@@ -44,8 +44,8 @@ Tensor geluKernel(const Tensor &A) {
     TensorAccessor<const T, 1> a = vA.getTensor(ctx.getBlockIdx());
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
-    int n = c.getShape(0);
-    for (int i = 0; i < n; ++i) {
+    int64_t n = c.getShape(0);
+    for (int64_t i = 0; i < n; ++i) {
       float x = a[i];
       x = x * 0.5f * (1.0f + erf(x / Sqrt2));
       c[i] = T(x);
@@ -55,12 +55,12 @@ Tensor geluKernel(const Tensor &A) {
   return C;
 }
 
-Tensor gelu(const Tensor &A) {
+Tensor gelu(Tensor A) {
   CHECK(A.getShape(-1) % 2 == 0);
 
-  if (A.getDType() == DType::kFloat) return geluKernel<float>(A);
+  if (A.getDType() == DType::kFloat) return geluKernel<float>(std::move(A));
 #if LUT_CPU_ARCH == LUT_AARCH64
-  if (A.getDType() == DType::kFloat16) return geluKernel<Float16>(A);
+  if (A.getDType() == DType::kFloat16) return geluKernel<Float16>(std::move(A));
 #endif
 
   NOT_IMPL();
@@ -25,7 +25,7 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-Tensor gelu(const Tensor &A);
+Tensor gelu(Tensor A);
 
 }  // namespace cpu
 }  // namespace op
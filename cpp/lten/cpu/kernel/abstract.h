@@ -65,11 +65,11 @@ struct GemvArgs {
   int M;
   int N;
   const ElementA *A;
-  int lda;
+  int64_t lda;
   const ElementX *x;
-  int incX;
+  int64_t incX;
   ElementY *y;
-  int incY;
+  int64_t incY;
 };
 
 template<typename ElementA, typename ElementB, typename ElementC>
@@ -80,11 +80,11 @@ struct GemmArgs {
   int N;
   int K;
   const ElementA *A;
-  int lda;
+  int64_t lda;
   const ElementB *B;
-  int ldb;
+  int64_t ldb;
   ElementC *C;
-  int ldc;
+  int64_t ldc;
 };
 
 }  // namespace kernel
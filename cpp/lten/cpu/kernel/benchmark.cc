@@ -29,8 +29,10 @@
 #include "lten/cpu/kernel/abstract.h"
 #include "lten/cpu/kernel/gemm.h"
 #include "lten/cpu/kernel/interface.h"
+#include "lten/mp.h"
 #include "lutil/attributes.h"
 #include "lutil/log.h"
+#include "lutil/numa.h"
 #include "lutil/strings.h"
 #include "lutil/time.h"
 
@@ -137,6 +139,61 @@ double benchmarkMklSgemm(int M, int K, int N, int numLoops = 2) {
 }
 #endif
 
+// GEMV (float) with A (N, K) in `dA`, returns the memory bandwidth in GB/s.
+double benchmarkGemvBandwidth(const std::vector<float> &dA, int N, int K, int numLoops) {
+  std::vector<float> dX(K);
+  std::vector<float> dY(N);
+
+  double t0 = lut::now();
+  for (int i = 0; i < numLoops; ++i) {
+    gemmFloat(false, true, 1, N, K, dX.data(), K, dA.data(), K, dY.data(), N, Mode::OMP);
+  }
+
+  double dt = (lut::now() - t0) / numLoops;
+  return N * K * sizeof(float) / dt / 1e9;
+}
+
+CATCH_TEST_CASE("benchmark GEMV bandwidth on NUMA nodes", "[benchmark][cpu_kernel][numa]") {
+  constexpr int N = 16384;
+  constexpr int K = 4096;
+  constexpr int NumLoops = 20;
+
+  std::vector<float> dA(N * K);
+  int64_t size = dA.size() * sizeof(float);
+
+  // warm up.
+  benchmarkGemvBandwidth(dA, N, K, 2);
+
+  // the whole weight on one node.
+  const std::vector<MP::NumaDomain> &domains = MP::getNumaDomains();
+  for (const MP::NumaDomain &domain : domains) {
+    if (domains.size() > 1 && !lut::bindMemoryToNode(dA.data(), size, domain.nodeId)) {
+      LOG(INFO) << "unable to bind memory to NUMA node " << domain.nodeId;
+      return;
+    }
+
+    double bandwidth = benchmarkGemvBandwidth(dA, N, K, NumLoops);
+    LOG(INFO) << lut::sprintf(
+        "GEMV (N,K)=(%d,%d) weight on node %d: %.2f GB/s",
+        N,
+        K,
+        domain.nodeId,
+        bandwidth);
+  }
+  if (domains.size() <= 1) return;
+
+  // rows placed on the node of the threads computing them.
+  int numThreads = MP::getMaxThreads();
+  for (const MP::NumaDomain &domain : domains) {
+    int64_t begin = MP::getPartitionBegin(N, domain.threadBegin, numThreads);
+    int64_t end = MP::getPartitionBegin(N, domain.threadEnd, numThreads);
+    lut::bindMemoryToNode(dA.data() + begin * K, (end - begin) * K * sizeof(float), domain.nodeId);
+  }
+
+  double bandwidth = benchmarkGemvBandwidth(dA, N, K, NumLoops);
+  LOG(INFO) << lut::sprintf("GEMV (N,K)=(%d,%d) rows partitioned: %.2f GB/s", N, K, bandwidth);
+}
+
 CATCH_TEST_CASE("benchmark Pack", "[benchmark][cpu_kernel][pack]") {
   constexpr int ROW = 4096;
   constexpr int COL = 4096;
@@ -33,7 +33,7 @@ namespace kernel {
 template<typename T>
 struct Block {
   T *data;
-  int32_t stride;
+  int64_t stride;
   int32_t numRows;
   int32_t numCols;
   bool transposed;
@@ -118,30 +118,30 @@ inline void Block<T>::copyTo(Block<T> tgt) {
 
   if ((!transposed) && (!tgt.transposed)) {
     for (int r = 0; r < numRows; ++r) {
-      int tgtOffset = r * tgt.stride;
-      int srcOffset = r * stride;
+      int64_t tgtOffset = r * tgt.stride;
+      int64_t srcOffset = r * stride;
       for (int c = 0; c < numCols; ++c) {
         tgt.data[tgtOffset + c] = data[srcOffset + c];
       }
     }
   } else if (transposed && (!tgt.transposed)) {
     for (int r = 0; r < numRows; ++r) {
-      int tgtOffset = r * tgt.stride;
+      int64_t tgtOffset = r * tgt.stride;
       for (int c = 0; c < numCols; ++c) {
         tgt.data[tgtOffset + c] = data[r + c * stride];
       }
     }
   } else if ((!transposed) && tgt.transposed) {
     for (int r = 0; r < numRows; ++r) {
-      int srcOffset = r * stride;
+      int64_t srcOffset = r * stride;
       for (int c = 0; c < numCols; ++c) {
         tgt.data[r + c * tgt.stride] = data[srcOffset + c];
       }
     }
   } else if (transposed && tgt.transposed) {
     for (int c = 0; c < numCols; ++c) {
-      int srcOffset = c * stride;
-      int tgtOffset = c * tgt.stride;
+      int64_t srcOffset = c * stride;
+      int64_t tgtOffset = c * tgt.stride;
       for (int r = 0; r < numRows; ++r) {
         tgt.data[r + tgtOffset] = data[r + srcOffset];
       }
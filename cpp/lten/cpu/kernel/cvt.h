@@ -41,9 +41,9 @@ void cvt(int64_t n, const ElementA *x, int64_t offsetX, ElementC *y, int64_t off
       cvtKernel<ElementA, ElementC, TYPE>(
           ne,
           x,
-          offsetX + i * CvtMinElemPerThread,
+          offsetX + static_cast<int64_t>(i) * CvtMinElemPerThread,
           y,
-          offsetY + i * CvtMinElemPerThread);
+          offsetY + static_cast<int64_t>(i) * CvtMinElemPerThread);
     });
   } else {
     cvtKernel<ElementA, ElementC, TYPE>(n, x, offsetX, y, offsetY);
@@ -238,11 +238,11 @@ void qgemm(const GemmArgs<T, TQ, T> &args) {
         args.C,
         1});
   } else {
-    int numelB = args.K * args.N;
+    int64_t numelB = static_cast<int64_t>(args.K) * args.N;
     lut::c_ptr<T> B = alignedAlloc<T>(numelB);
     cvt<TQ, T, TYPE, MODE>(numelB, args.B, 0, B.get(), 0);
 
-    int ldb = args.transB ? args.K : args.N;
+    int64_t ldb = args.transB ? args.K : args.N;
 
     GemmArgs<T, T, T> gemmArgs{
         args.transA,
@@ -44,6 +44,22 @@ void gemvContigousN(const GemvArgs<ElementA, ElementB, ElementC> &args) {
           args.A,
           m * args.lda);
     }
+  } else if (MODE == Mode::OMP && MP::getNumaDomains().size() > 1) {
+    // static partition of rows among threads, so that each thread reads the rows placed on its
+    // NUMA node (see placeRowsOnNumaNodes()).
+    MP::parallelForEachThread([args](MP::Context ctx) {
+      int begin = static_cast<int>(
+          MP::getPartitionBegin(args.M, ctx.getBlockIdx(), ctx.getNumBlocks()));
+      int end = static_cast<int>(
+          MP::getPartitionBegin(args.M, ctx.getBlockIdx() + 1, ctx.getNumBlocks()));
+      for (int m = begin; m < end; ++m) {
+        args.y[m] += dotKernel<ElementC, ElementB, ElementA, TYPE>(
+            args.N,
+            args.x,
+            args.A,
+            m * args.lda);
+      }
+    });
   } else if (MODE == Mode::OMP) {
     MP::parallelFor(args.M, [args](MP::Context ctx) {
       args.y[ctx.getBlockIdx()] += dotKernel<ElementC, ElementB, ElementA, TYPE>(
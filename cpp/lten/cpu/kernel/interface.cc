@@ -118,11 +118,11 @@ void gemmFloat(
     int N,
     int K,
     const float *A,
-    int lda,
+    int64_t lda,
     const float *B,
-    int ldb,
+    int64_t ldb,
     float *C,
-    int ldc,
+    int64_t ldc,
     Mode mode,
     CpuMathBackend backendType) {
   GemmArgs<float, float, float> args;
@@ -168,11 +168,11 @@ void gemmHalf(
     int N,
     int K,
     const Float16 *A,
-    int lda,
+    int64_t lda,
     const Float16 *B,
-    int ldb,
+    int64_t ldb,
     Float16 *C,
-    int ldc,
+    int64_t ldc,
     [[maybe_unused]] Mode mode,
     CpuMathBackend backendType) {
   [[maybe_unused]] GemmArgs<Float16, Float16, Float16> args;
@@ -202,9 +202,9 @@ void gemmHalf(
 }
 
 void dequantQInt4ToFloat(
-    int n,
+    int64_t n,
     const QInt4x32 *data,
-    int offset,
+    int64_t offset,
     float *tgt,
     Mode mode,
     CpuMathBackend backendType) {
@@ -223,9 +223,9 @@ void dequantQInt4ToFloat(
 }
 
 void quantFloatToQInt4(
-    int n,
+    int64_t n,
     const float *data,
-    int offset,
+    int64_t offset,
     QInt4x32 *tgt,
     Mode mode,
     CpuMathBackend) {
@@ -239,9 +239,9 @@ void quantFloatToQInt4(
 }
 
 void dequantQInt4ToHalf(
-    [[maybe_unused]] int n,
+    [[maybe_unused]] int64_t n,
     [[maybe_unused]] const QInt4x32 *data,
-    [[maybe_unused]] int offset,
+    [[maybe_unused]] int64_t offset,
     [[maybe_unused]] Float16 *tgt,
     [[maybe_unused]] Mode mode,
     [[maybe_unused]] CpuMathBackend backendType) {
@@ -264,10 +264,10 @@ void gemmFloatQInt4(
     int N,
     int K,
     const float *A,
-    int lda,
+    int64_t lda,
     const QInt4x32 *B,
     float *C,
-    int ldc,
+    int64_t ldc,
     Mode mode,
     CpuMathBackend backendType) {
   GemmArgs<float, QInt4x32, float> args;
@@ -316,10 +316,10 @@ void gemmHalfQInt4(
     int N,
     int K,
     const Float16 *A,
-    int lda,
+    int64_t lda,
     const QInt4x32 *B,
     Float16 *C,
-    int ldc,
+    int64_t ldc,
     [[maybe_unused]] Mode mode,
     CpuMathBackend backendType) {
   [[maybe_unused]] GemmArgs<Float16, QInt4x32, Float16> args;
@@ -350,7 +350,12 @@ void gemmHalfQInt4(
   }
 }
 
-void convertHalfToFloat(int n, const Float16 *x, float *y, Mode mode, CpuMathBackend backendType) {
+void convertHalfToFloat(
+    int64_t n,
+    const Float16 *x,
+    float *y,
+    Mode mode,
+    CpuMathBackend backendType) {
   backendType = getCpuMathBackend(backendType);
 
   if (false) {
@@ -368,7 +373,12 @@ void convertHalfToFloat(int n, const Float16 *x, float *y, Mode mode, CpuMathBac
   }
 }
 
-void convertFloatToHalf(int n, const float *x, Float16 *y, Mode mode, CpuMathBackend backendType) {
+void convertFloatToHalf(
+    int64_t n,
+    const float *x,
+    Float16 *y,
+    Mode mode,
+    CpuMathBackend backendType) {
   backendType = getCpuMathBackend(backendType);
 
   if (false) {
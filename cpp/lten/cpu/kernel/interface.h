@@ -57,11 +57,11 @@ void gemmFloat(
     int N,
     int K,
     const float *A,
-    int lda,
+    int64_t lda,
     const float *B,
-    int ldb,
+    int64_t ldb,
     float *C,
-    int ldc,
+    int64_t ldc,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
 
@@ -72,11 +72,11 @@ void gemmHalf(
     int N,
     int K,
     const Float16 *A,
-    int lda,
+    int64_t lda,
     const Float16 *B,
-    int ldb,
+    int64_t ldb,
     Float16 *C,
-    int ldc,
+    int64_t ldc,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
 
@@ -87,33 +87,33 @@ void gemmHalfQInt4(
     int N,
     int K,
     const Float16 *A,
-    int lda,
+    int64_t lda,
     const QInt4x32 *B,
     Float16 *C,
-    int ldc,
+    int64_t ldc,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
 
 void dequantQInt4ToFloat(
-    int n,
+    int64_t n,
     const QInt4x32 *data,
-    int offset,
+    int64_t offset,
     float *tgt,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
 
 void quantFloatToQInt4(
-    int n,
+    int64_t n,
     const float *data,
-    int offset,
+    int64_t offset,
     QInt4x32 *tgt,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
 
 void dequantQInt4ToHalf(
-    int n,
+    int64_t n,
     const QInt4x32 *data,
-    int offset,
+    int64_t offset,
     Float16 *tgt,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
@@ -127,22 +127,22 @@ void gemmFloatQInt4(
     int N,
     int K,
     const float *A,
-    int lda,
+    int64_t lda,
     const QInt4x32 *B,
     float *C,
-    int ldc,
+    int64_t ldc,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
 
 void convertHalfToFloat(
-    int n,
+    int64_t n,
     const Float16 *x,
     float *y,
     Mode mode,
     CpuMathBackend backendType = CpuMathBackend::DEFAULT);
 
 void convertFloatToHalf(
-    int n,
+    int64_t n,
     const float *x,
     Float16 *y,
     Mode mode,
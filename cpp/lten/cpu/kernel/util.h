@@ -35,7 +35,7 @@ namespace kernel {
 
 // copy vector x to y.
 template<typename T>
-void copyVec(int n, const T *x, int incx, T *y, int incy) {
+void copyVec(int n, const T *x, int64_t incx, T *y, int64_t incy) {
   for (int i = 0; i < n; ++i) {
     y[i * incy] = x[i * incx];
   }
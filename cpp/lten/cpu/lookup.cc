@@ -34,18 +34,18 @@ template<typename T>
 Tensor lookupKernel2D(const Tensor &table, const Tensor &indices) {
   CHECK(table.getDim() == 2 && indices.getDim() == 2);
 
-  int vocabSize = table.getShape(0);
-  int d0 = indices.getShape(0);
-  int d1 = indices.getShape(1);
-  int embdDim = table.getShape(1);
+  Tensor::ShapeType vocabSize = table.getShape(0);
+  Tensor::ShapeType d0 = indices.getShape(0);
+  Tensor::ShapeType d1 = indices.getShape(1);
+  Tensor::ShapeType embdDim = table.getShape(1);
   Tensor xC = tensor(lut::makeConstSpan({d0, d1, embdDim}), DType::getType<T>());
 
   TensorAccessor<const T, 2> A = table;
   TensorAccessor<const LongType, 2> B = indices;
   TensorAccessor<T, 3> C = xC;
 
-  for (int i = 0; i < d0; ++i) {
-    for (int j = 0; j < d1; ++j) {
+  for (int64_t i = 0; i < d0; ++i) {
+    for (int64_t j = 0; j < d1; ++j) {
       int64_t index = B[i][j];
       CHECK(index < vocabSize) << "indices out of range";
 
@@ -61,17 +61,17 @@ Tensor lookupQuantizedKernel2D(const Tensor &table, const Tensor &indices) {
   CHECK(table.getDim() == 2 && table.getShape(1) % DType::getType<SrcT>().getGroupSize() == 0);
   const TensorData *embdData = table.getDataObject();
 
-  int vocabSize = table.getShape(0);
-  int d0 = indices.getShape(0);
-  int d1 = indices.getShape(1);
-  int embdDim = table.getShape(1);
+  Tensor::ShapeType vocabSize = table.getShape(0);
+  Tensor::ShapeType d0 = indices.getShape(0);
+  Tensor::ShapeType d1 = indices.getShape(1);
+  Tensor::ShapeType embdDim = table.getShape(1);
   Tensor xC = tensor(lut::makeConstSpan({d0, d1, embdDim}), DType::getType<DestT>());
 
   TensorAccessor<const LongType, 2> B = indices;
   TensorAccessor<DestT, 3> C = xC;
 
-  for (int i = 0; i < d0; ++i) {
-    for (int j = 0; j < d1; ++j) {
+  for (int64_t i = 0; i < d0; ++i) {
+    for (int64_t j = 0; j < d1; ++j) {
       int64_t index = B[i][j];
       CHECK(index < vocabSize) << "indices out of range";
 
@@ -19,6 +19,8 @@
 
 #include "lten/cpu/matmul.h"
 
+#include <limits>
+
 #include "lten/cpu/accessor.h"
 #include "lten/cpu/common.h"
 #include "lten/cpu/kernel/interface.h"
@@ -30,10 +32,10 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-std::vector<int> getBmmOutputShape(const Tensor &A, const Tensor &B) {
+std::vector<Tensor::ShapeType> getBmmOutputShape(const Tensor &A, const Tensor &B) {
   CHECK(A.getDim() >= B.getDim());
   CHECK(A.getDim() > 2 && A.getDim() <= 4 && B.getDim() >= 2);
-  std::vector<int> shape;
+  std::vector<Tensor::ShapeType> shape;
 
   // broadcast B
   int broadcastDims = A.getDim() - B.getDim();
@@ -62,7 +64,7 @@ GEMMArgs generateGemmArgs(const Tensor &A, const Tensor &B, const Tensor &C) {
   CHECK(B.getShape(-1) == C.getShape(-1));
 
   bool transA, transB;
-  int lda, ldb;
+  int64_t lda, ldb;
   if (A.getStride(-1) == 1) {
     transA = false;
     lda = A.getStride(-2);
@@ -83,10 +85,15 @@ GEMMArgs generateGemmArgs(const Tensor &A, const Tensor &B, const Tensor &C) {
     NOT_IMPL();
   }
 
-  int m = A.getShape(-2);
-  int k = A.getShape(-1);
-  int n = B.getShape(-1);
-  int ldc = C.getStride(-2);
+  // the strides are 64-bit, but M, N and K of a single GEMM call are expected to fit in int.
+  CHECK(A.getShape(-2) <= std::numeric_limits<int>::max());
+  CHECK(A.getShape(-1) <= std::numeric_limits<int>::max());
+  CHECK(B.getShape(-1) <= std::numeric_limits<int>::max());
+
+  int m = static_cast<int>(A.getShape(-2));
+  int k = static_cast<int>(A.getShape(-1));
+  int n = static_cast<int>(B.getShape(-1));
+  int64_t ldc = C.getStride(-2);
 
   GEMMArgs gemmArgs;
   gemmArgs.K = k;
@@ -109,11 +116,11 @@ void callGemm(
     int N,
     int K,
     const T *A,
-    int lda,
+    int64_t lda,
     const T *B,
-    int ldb,
+    int64_t ldb,
     T *C,
-    int ldc,
+    int64_t ldc,
     kernel::Mode mode);
 
 template<>
@@ -124,11 +131,11 @@ inline void callGemm<float>(
     int N,
     int K,
     const float *A,
-    int lda,
+    int64_t lda,
     const float *B,
-    int ldb,
+    int64_t ldb,
     float *C,
-    int ldc,
+    int64_t ldc,
     kernel::Mode mode) {
   return kernel::gemmFloat(transA, transB, M, N, K, A, lda, B, ldb, C, ldc, mode);
 }
@@ -141,11 +148,11 @@ inline void callGemm<Float16>(
     int N,
     int K,
     const Float16 *A,
-    int lda,
+    int64_t lda,
     const Float16 *B,
-    int ldb,
+    int64_t ldb,
     Float16 *C,
-    int ldc,
+    int64_t ldc,
     kernel::Mode mode) {
   const kernel::Float16 *xA = reinterpret_cast<const kernel::Float16 *>(A);
   const kernel::Float16 *xB = reinterpret_cast<const kernel::Float16 *>(B);
@@ -179,7 +186,7 @@ Tensor gemm(const Tensor &A, const Tensor &B) {
 
 template<typename T>
 Tensor bmmNx2(const Tensor &A, const Tensor &B) {
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
 
   Tensor xA = A.view({-1, A.getShape(-1)});
   Tensor xC = gemm<T>(xA, B);
@@ -192,7 +199,7 @@ template<typename T>
 Tensor bmm(const Tensor &A, const Tensor &B) {
   Tensor xB = B;
   if (A.getDim() != B.getDim()) xB = expandBatchDims(B, A.getShape());
-  std::vector<int> shapeC = getBmmOutputShape(A, xB);
+  std::vector<Tensor::ShapeType> shapeC = getBmmOutputShape(A, xB);
 
   Tensor C = op::cpu::zeros(shapeC, DType::getType<T>());
 
@@ -206,23 +213,19 @@ Tensor bmm(const Tensor &A, const Tensor &B) {
   CHECK(mA.getLength() == mC.getLength());
   CHECK(mA.getLength() % mB.getLength() == 0);
 
-  const T *const *mAp = mA.getDataPtrList().data();
-  const T *const *mBp = mB.getDataPtrList().data();
-  T *const *mCp = mC.getDataPtrList().data();
-
-  MP::parallelFor(mA.getLength(), [mAp, mBp, mCp, gemmArgs](MP::Context ctx) {
-    int i = ctx.getBlockIdx();
+  MP::parallelFor(mA.getLength(), [&mA, &mB, &mC, gemmArgs](MP::Context ctx) {
+    int64_t i = ctx.getBlockIdx();
     callGemm<T>(
         gemmArgs.transA,
         gemmArgs.transB,
         gemmArgs.M,
         gemmArgs.N,
         gemmArgs.K,
-        mAp[i],
+        mA.getDataPtr(i),
         gemmArgs.lda,
-        mBp[i],
+        mB.getDataPtr(i),
         gemmArgs.ldb,
-        mCp[i],
+        mC.getDataPtr(i),
         gemmArgs.ldc,
         kernel::Mode::SingleThread);
   });
@@ -253,10 +256,10 @@ void callGemmQInt4(
     int N,
     int K,
     const T *A,
-    int lda,
+    int64_t lda,
     const kernel::QInt4x32 *B,
     T *C,
-    int ldc,
+    int64_t ldc,
     kernel::Mode mode);
 
 template<>
@@ -267,10 +270,10 @@ inline void callGemmQInt4<float>(
     int N,
     int K,
     const float *A,
-    int lda,
+    int64_t lda,
     const kernel::QInt4x32 *B,
     float *C,
-    int ldc,
+    int64_t ldc,
     kernel::Mode mode) {
   return kernel::gemmFloatQInt4(transA, transB, M, N, K, A, lda, B, C, ldc, mode);
 }
@@ -283,10 +286,10 @@ inline void callGemmQInt4<Float16>(
     int N,
     int K,
     const Float16 *A,
-    int lda,
+    int64_t lda,
     const kernel::QInt4x32 *B,
     Float16 *C,
-    int ldc,
+    int64_t ldc,
     kernel::Mode mode) {
   const kernel::Float16 *xA = reinterpret_cast<const kernel::Float16 *>(A);
   kernel::Float16 *xC = reinterpret_cast<kernel::Float16 *>(C);
@@ -319,7 +322,7 @@ Tensor gemmQInt4(const Tensor &A, const Tensor &B) {
 
 template<typename T>
 Tensor bmmNx2QInt4(const Tensor &A, const Tensor &B) {
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
 
   Tensor xA = A.view({-1, A.getShape(-1)});
   Tensor xC = gemmQInt4<T>(xA, B);
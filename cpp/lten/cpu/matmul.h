@@ -31,12 +31,12 @@ struct GEMMArgs {
   int M;
   int N;
   int K;
-  int lda;
-  int ldb;
-  int ldc;
+  int64_t lda;
+  int64_t ldb;
+  int64_t ldc;
 };
 
-std::vector<int> getBmmOutputShape(const Tensor &A, const Tensor &B);
+std::vector<Tensor::ShapeType> getBmmOutputShape(const Tensor &A, const Tensor &B);
 
 // generate GEMMArgs from the input tensor A, B and output tensor C. dimensions of A could be
 // greater than 2 (for BMM). throw exception if shape mismatch.
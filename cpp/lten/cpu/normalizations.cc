@@ -49,7 +49,7 @@ Tensor rmsNormKernel(const Tensor &tensor, const Tensor &weight, float eps) {
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
     float sum = 0.0;
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       float va = a[i];
       sum += va * va;
     }
@@ -57,7 +57,7 @@ Tensor rmsNormKernel(const Tensor &tensor, const Tensor &weight, float eps) {
     float rms = std::sqrt(mean + eps);
 
     // compute rms-norm
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       float va = a[i];
       float vw = w[i];
       c[i] = static_cast<T>(va * vw / rms);
@@ -86,14 +86,14 @@ Tensor layerNormKernel(const Tensor &tensor, const Tensor &weight, const Tensor
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
     double sum = 0.0f;
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       sum += a[i];
     }
     double mean = sum / a.getShape(0);
 
     // var (unbiased)
     sum = 0.0;
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       double d = a[i] - mean;
       sum += d * d;
     }
@@ -101,7 +101,7 @@ Tensor layerNormKernel(const Tensor &tensor, const Tensor &weight, const Tensor
     double sd = sqrt(var + eps);
 
     // compute layer-norm
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       float elem = static_cast<float>((a[i] - mean) / sd);
       c[i] = elem * w[i] + b[i];
     }
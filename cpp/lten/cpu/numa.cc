@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/cpu/numa.h"
+
+#include <atomic>
+#include <vector>
+
+#include "lten/mp.h"
+#include "lutil/log.h"
+#include "lutil/numa.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+namespace {
+
+std::atomic<bool> gWarned{false};
+
+bool warnIfFailed(bool success) {
+  if (!success && !gWarned.exchange(true)) {
+    LOG(WARN) << "unable to move memory between NUMA nodes, data stays on the current node.";
+  }
+
+  return success;
+}
+
+}  // namespace
+
+bool placeRowsOnNumaNodes(const Tensor &weight) {
+  const std::vector<MP::NumaDomain> &domains = MP::getNumaDomains();
+  if (domains.size() <= 1) return true;
+
+  const TensorData *data = weight.getDataObject();
+  if (weight.getDevice().getType() != Device::kCpu || weight.getDim() != 2 ||
+      !weight.isContiguous() || weight.getOffset_() != 0 ||
+      weight.getNumEl() != data->getNumEl()) {
+    return false;
+  }
+
+  int64_t numRows = weight.getShape(0);
+  int numThreads = MP::getMaxThreads();
+  bool success = true;
+  for (int i = 0; i < data->getNumSlot(); ++i) {
+    const SlotBase *slot = data->getSlot(i);
+    int64_t sizeInBytes = slot->getSizeInBytes();
+    if (sizeInBytes % numRows != 0) return false;
+
+    int64_t rowBytes = sizeInBytes / numRows;
+    for (const MP::NumaDomain &domain : domains) {
+      int64_t begin = MP::getPartitionBegin(numRows, domain.threadBegin, numThreads);
+      int64_t end = MP::getPartitionBegin(numRows, domain.threadEnd, numThreads);
+      success &= lut::bindMemoryToNode(
+          slot->getRawData() + begin * rowBytes,
+          (end - begin) * rowBytes,
+          domain.nodeId);
+    }
+  }
+
+  return warnIfFailed(success);
+}
+
+bool interleaveOnNumaNodes(const Tensor &tensor) {
+  const std::vector<MP::NumaDomain> &domains = MP::getNumaDomains();
+  if (domains.size() <= 1) return true;
+  if (tensor.getDevice().getType() != Device::kCpu) return false;
+
+  std::vector<int> nodes;
+  for (const MP::NumaDomain &domain : domains) {
+    nodes.push_back(domain.nodeId);
+  }
+
+  const TensorData *data = tensor.getDataObject();
+  bool success = true;
+  for (int i = 0; i < data->getNumSlot(); ++i) {
+    const SlotBase *slot = data->getSlot(i);
+    success &= lut::interleaveMemory(slot->getRawData(), slot->getSizeInBytes(), nodes);
+  }
+
+  return warnIfFailed(success);
+}
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
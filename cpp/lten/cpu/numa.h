@@ -0,0 +1,43 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "lten/tensor.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+/// @brief Move the rows of a 2D weight to the NUMA nodes of the threads computing them in the
+/// NUMA-aware GEMV, where rows are statically partitioned among the worker threads. The page
+/// holding the boundary of two partitions is not bound to either node, it stays on the node of
+/// first touch. It does nothing on single-node machines.
+/// @param weight <dtype>(M, K): the weight. It should be contiguous and own its whole data.
+/// @return false if the weight is not supported or the pages could not be moved.
+bool placeRowsOnNumaNodes(const Tensor &weight);
+
+/// @brief Interleave the pages of a tensor over all the NUMA nodes, for the data accessed by the
+/// threads of all nodes evenly, like the KV cache. It does nothing on single-node machines.
+/// @return false if the pages could not be moved.
+bool interleaveOnNumaNodes(const Tensor &tensor);
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
@@ -0,0 +1,472 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/cpu/paged_attention.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "lten/cpu/kernel/interface.h"
+#include "lten/cpu/tensor.h"
+#include "lten/mp.h"
+#include "lutil/log.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+namespace {
+
+constexpr int kVarlenTileSize = 64;
+
+// Row of keys or values of one (token, head) in the storage type T. Dequantization happens in
+// dot() and axpy(), so the float copy of the whole KV is never created.
+template<typename T>
+struct KVRow;
+
+template<>
+struct KVRow<float> {
+  static float dot(int n, const float *q, const float *k, float /*scale*/, float * /*buffer*/) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+      sum += q[i] * k[i];
+    }
+    return sum;
+  }
+
+  static void axpy(
+      int n,
+      float a,
+      const float *v,
+      float /*scale*/,
+      float *y,
+      float * /*buffer*/) {
+    for (int i = 0; i < n; ++i) {
+      y[i] += a * v[i];
+    }
+  }
+};
+
+// fp16 rows are converted into a small scratch buffer (fits L1) by the F16C/ASIMDHP kernel.
+template<>
+struct KVRow<Float16> {
+  static float dot(int n, const float *q, const Float16 *k, float scale, float *buffer) {
+    kernel::convertHalfToFloat(
+        n,
+        reinterpret_cast<const kernel::Float16 *>(k),
+        buffer,
+        kernel::Mode::OMP);
+    return KVRow<float>::dot(n, q, buffer, scale, nullptr);
+  }
+
+  static void axpy(int n, float a, const Float16 *v, float scale, float *y, float *buffer) {
+    kernel::convertHalfToFloat(
+        n,
+        reinterpret_cast<const kernel::Float16 *>(v),
+        buffer,
+        kernel::Mode::OMP);
+    KVRow<float>::axpy(n, a, buffer, scale, y, nullptr);
+  }
+};
+
+// int8 rows share one scale, it is applied once to the dot product or the axpy coefficient.
+template<>
+struct KVRow<Int8> {
+  static float dot(int n, const float *q, const Int8 *k, float scale, float * /*buffer*/) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+      sum += q[i] * k[i].v;
+    }
+    return sum * scale;
+  }
+
+  static void axpy(int n, float a, const Int8 *v, float scale, float *y, float * /*buffer*/) {
+    float as = a * scale;
+    for (int i = 0; i < n; ++i) {
+      y[i] += as * v[i].v;
+    }
+  }
+};
+
+void quantizeKVInt8(const Tensor &src, Tensor &dest, Tensor &destScale) {
+  int numRows = src.getShape(0) * src.getShape(1);
+  int headDim = src.getShape(2);
+  const float *x = src.getData<float>();
+  Int8 *y = dest.getData<Int8>();
+  float *scale = destScale.getData<float>();
+
+  MP::parallelFor(numRows, [x, y, scale, headDim](MP::Context ctx) {
+    int64_t row = ctx.getBlockIdx();
+    const float *px = x + row * headDim;
+    Int8 *py = y + row * headDim;
+
+    float absMax = 0.0f;
+    for (int i = 0; i < headDim; ++i) {
+      absMax = std::max(absMax, fabsf(px[i]));
+    }
+
+    float s = absMax / 127.0f;
+    float rs = s > 0.0f ? 1.0f / s : 0.0f;
+    for (int i = 0; i < headDim; ++i) {
+      py[i].v = static_cast<int8_t>(lrintf(px[i] * rs));
+    }
+    scale[row] = s;
+  });
+}
+
+void dequantizeKVInt8(const Tensor &src, const Tensor &srcScale, Tensor &dest) {
+  int numRows = src.getShape(0) * src.getShape(1);
+  int headDim = src.getShape(2);
+  const Int8 *x = src.getData<Int8>();
+  const float *scale = srcScale.getData<float>();
+  float *y = dest.getData<float>();
+
+  MP::parallelFor(numRows, [x, y, scale, headDim](MP::Context ctx) {
+    int64_t row = ctx.getBlockIdx();
+    for (int i = 0; i < headDim; ++i) {
+      y[row * headDim + i] = x[row * headDim + i].v * scale[row];
+    }
+  });
+}
+
+// get the first key position visited by the query at position `p`, except the global tokens.
+int getLocalBegin(const PagedKV &kv, int p) {
+  int begin = 0;
+  if (kv.window > 0) begin = std::max(begin, p - kv.window + 1);
+  if (kv.chunkSize > 0) begin = std::max(begin, p / kv.chunkSize * kv.chunkSize);
+
+  return begin;
+}
+
+// attention of query head `h` at position `pos` against the keys and values in `kv`. The scores
+// are computed tile by tile (a tile is the part of a block in range) with the online softmax.
+// `scores` should hold at least kv.blockSize elements and `buffer` headDim elements.
+template<typename T>
+void attentionRow(
+    const PagedKV &kv,
+    int numQHeads,
+    int pos,
+    int h,
+    const float *pq,
+    float *po,
+    float *scores,
+    float *buffer) {
+  int numHeads = kv.k[0].getShape(1);
+  int headDim = kv.k[0].getShape(2);
+  int blockSize = kv.blockSize;
+  int numBlocks = static_cast<int>(kv.k.size());
+  int kvHead = h / (numQHeads / numHeads);
+  float rsqrtD = 1.0f / sqrtf(static_cast<float>(headDim));
+  std::fill(po, po + headDim, 0.0f);
+
+  // position bias of the key at `keyPos`, computed on the fly.
+  float slope = kv.alibiSlopes.empty() ? 0.0f : kv.alibiSlopes[h];
+  const float *relativeBias = kv.relativeBias.empty() ? nullptr : kv.relativeBias.getData<float>();
+  int numBuckets = relativeBias ? kv.relativeBias.getShape(0) : 0;
+  auto getBias = [&](int keyPos) {
+    int distance = pos - keyPos;
+    float bias = -slope * distance;
+    if (relativeBias) {
+      int bucket = getRelativePositionBucket(distance, numBuckets, kv.relativeMaxDistance);
+      bias += relativeBias[bucket * numQHeads + h];
+    }
+    return bias;
+  };
+  bool hasBias = !kv.alibiSlopes.empty() || relativeBias;
+
+  float maxScore = -std::numeric_limits<float>::infinity();
+  float sumExp = 0.0f;
+
+  // visit the keys in [begin, end).
+  auto visit = [&](int begin, int end) {
+    while (begin < end) {
+      int blockIdx = (begin / blockSize) % numBlocks;
+      int offset = begin % blockSize;
+      int n = std::min(blockSize - offset, end - begin);
+      int keyPos = begin;
+      begin += n;
+      const T *pk = kv.k[blockIdx].getData<T>();
+      const T *pv = kv.v[blockIdx].getData<T>();
+      const float *pks = kv.kScale.empty() ? nullptr : kv.kScale[blockIdx].getData<float>();
+      const float *pvs = kv.vScale.empty() ? nullptr : kv.vScale[blockIdx].getData<float>();
+
+      float blockMax = -std::numeric_limits<float>::infinity();
+      for (int j = 0; j < n; ++j) {
+        int64_t row = static_cast<int64_t>(offset + j) * numHeads + kvHead;
+        float s = pks ? pks[row] : 1.0f;
+        scores[j] = rsqrtD * KVRow<T>::dot(headDim, pq, pk + row * headDim, s, buffer);
+        if (hasBias) scores[j] += getBias(keyPos + j);
+        blockMax = std::max(blockMax, scores[j]);
+      }
+
+      // online softmax: rescale the accumulated output once the running max changes.
+      float newMax = std::max(maxScore, blockMax);
+      float correction = expf(maxScore - newMax);
+      sumExp *= correction;
+      for (int d = 0; d < headDim; ++d) {
+        po[d] *= correction;
+      }
+
+      for (int j = 0; j < n; ++j) {
+        int64_t row = static_cast<int64_t>(offset + j) * numHeads + kvHead;
+        float s = pvs ? pvs[row] : 1.0f;
+        float p = expf(scores[j] - newMax);
+        sumExp += p;
+        KVRow<T>::axpy(headDim, p, pv + row * headDim, s, po, buffer);
+      }
+      maxScore = newMax;
+    }
+  };
+
+  int localBegin = getLocalBegin(kv, pos);
+  visit(0, std::min(kv.numGlobalTokens, localBegin));
+  visit(localBegin, pos + 1);
+
+  float rsum = 1.0f / sumExp;
+  for (int d = 0; d < headDim; ++d) {
+    po[d] *= rsum;
+  }
+}
+
+template<typename T>
+Tensor pagedAttentionKernel(const Tensor &q, const PagedKV &kv) {
+  int numQueries = q.getShape(0);
+  int numQHeads = q.getShape(1);
+  int headDim = q.getShape(2);
+  int length = kv.length;
+  CHECK(numQHeads % kv.k[0].getShape(1) == 0);
+  CHECK(numQueries <= length);
+  CHECK(q.getStride(2) == 1);
+
+  int64_t qStride0 = q.getStride(0);
+  int64_t qStride1 = q.getStride(1);
+  const float *qData = q.getData<float>();
+
+  Tensor out = op::cpu::tensor({numQueries, numQHeads, headDim}, DType::kFloat);
+  float *outData = out.getData<float>();
+
+  MP::parallelFor(numQueries * numQHeads, [&](MP::Context ctx) {
+    int i = ctx.getBlockIdx() / numQHeads;
+    int h = ctx.getBlockIdx() % numQHeads;
+
+    // causal: the i-th query is at position length - numQueries + i.
+    int pos = length - numQueries + i;
+    const float *pq = qData + i * qStride0 + h * qStride1;
+    float *po = outData + (static_cast<int64_t>(i) * numQHeads + h) * headDim;
+
+    std::vector<float> scores(kv.blockSize);
+    std::vector<float> buffer(headDim);
+    attentionRow<T>(kv, numQHeads, pos, h, pq, po, scores.data(), buffer.data());
+  });
+
+  return out;
+}
+
+// split the queries [0, costs.size()) into about `numParts` contiguous ranges with nearly equal
+// total cost. Returns the boundaries of the ranges.
+std::vector<int> partitionByCost(lut::Span<const int64_t> costs, int numParts) {
+  int64_t totalCost = 0;
+  for (int64_t cost : costs) totalCost += cost;
+
+  std::vector<int> bounds{0};
+  int64_t target = std::max<int64_t>(1, (totalCost + numParts - 1) / numParts);
+  int64_t acc = 0;
+  for (int i = 0; i < static_cast<int>(costs.size()); ++i) {
+    acc += costs[i];
+    if (acc >= target) {
+      bounds.push_back(i + 1);
+      acc = 0;
+    }
+  }
+  if (bounds.back() != static_cast<int>(costs.size())) bounds.push_back(costs.size());
+
+  return bounds;
+}
+
+}  // namespace
+
+PagedKV::PagedKV()
+    : blockSize(0),
+      length(0),
+      window(0),
+      chunkSize(0),
+      numGlobalTokens(0),
+      relativeMaxDistance(0) {
+}
+
+int getRelativePositionBucket(int distance, int numBuckets, int maxDistance) {
+  int maxExact = numBuckets / 2;
+  if (distance < maxExact) return distance;
+
+  float r = logf(static_cast<float>(distance) / maxExact) /
+            logf(static_cast<float>(maxDistance) / maxExact);
+  int bucket = maxExact + static_cast<int>(r * (numBuckets - maxExact));
+  return std::min(bucket, numBuckets - 1);
+}
+
+void quantizeKV(const Tensor &src, Tensor &dest, Tensor &destScale) {
+  CHECK(src.getDType() == DType::kFloat && src.getDim() == 3 && src.isContiguous());
+  CHECK(dest.getDim() == 3 && dest.isContiguous());
+  CHECK(src.getShape(0) == dest.getShape(0) && src.getShape(1) == dest.getShape(1));
+  CHECK(src.getShape(2) == dest.getShape(2));
+
+  if (dest.getDType() == DType::kInt8) {
+    CHECK(destScale.getDim() == 2 && destScale.isContiguous());
+    quantizeKVInt8(src, dest, destScale);
+  } else if (dest.getDType() == DType::kFloat16) {
+    kernel::convertFloatToHalf(
+        src.getNumEl(),
+        src.getData<float>(),
+        reinterpret_cast<kernel::Float16 *>(dest.getData<Float16>()),
+        kernel::Mode::OMP);
+  } else {
+    NOT_IMPL();
+  }
+}
+
+void dequantizeKV(const Tensor &src, const Tensor &srcScale, Tensor &dest) {
+  CHECK(dest.getDType() == DType::kFloat && dest.getDim() == 3 && dest.isContiguous());
+  CHECK(src.getDim() == 3 && src.isContiguous());
+  CHECK(src.getNumEl() == dest.getNumEl());
+
+  if (src.getDType() == DType::kInt8) {
+    CHECK(srcScale.getDim() == 2 && srcScale.isContiguous());
+    dequantizeKVInt8(src, srcScale, dest);
+  } else if (src.getDType() == DType::kFloat16) {
+    kernel::convertHalfToFloat(
+        src.getNumEl(),
+        reinterpret_cast<const kernel::Float16 *>(src.getData<Float16>()),
+        dest.getData<float>(),
+        kernel::Mode::OMP);
+  } else {
+    NOT_IMPL();
+  }
+}
+
+Tensor pagedAttention(const Tensor &q, const PagedKV &kv) {
+  CHECK(q.getDType() == DType::kFloat && q.getDim() == 3);
+  CHECK(!kv.k.empty() && kv.k.size() == kv.v.size());
+  CHECK(kv.blockSize > 0 && kv.window >= 0 && kv.chunkSize >= 0 && kv.numGlobalTokens >= 0);
+
+  // tokens evicted from the ring buffer should be outside the window of the first query.
+  int capacity = static_cast<int>(kv.k.size()) * kv.blockSize;
+  int firstPos = kv.length - q.getShape(0);
+  CHECK(getLocalBegin(kv, firstPos) >= kv.length - capacity);
+  CHECK(kv.numGlobalTokens == 0 || kv.length <= capacity);
+  CHECK(kv.alibiSlopes.empty() || static_cast<int>(kv.alibiSlopes.size()) == q.getShape(1));
+  if (!kv.relativeBias.empty()) {
+    CHECK(kv.relativeBias.getDType() == DType::kFloat && kv.relativeBias.isContiguous());
+    CHECK(kv.relativeBias.getDim() == 2 && kv.relativeBias.getShape(1) == q.getShape(1));
+    CHECK(kv.relativeBias.getShape(0) >= 2);
+    CHECK(kv.relativeMaxDistance > kv.relativeBias.getShape(0) / 2);
+  }
+
+  DType dtype = kv.k[0].getDType();
+  if (dtype == DType::kFloat) return pagedAttentionKernel<float>(q, kv);
+  if (dtype == DType::kFloat16) return pagedAttentionKernel<Float16>(q, kv);
+  if (dtype == DType::kInt8) {
+    CHECK(kv.kScale.size() == kv.k.size() && kv.vScale.size() == kv.v.size());
+    return pagedAttentionKernel<Int8>(q, kv);
+  }
+
+  NOT_IMPL();
+  return Tensor();
+}
+
+Tensor varlenAttention(
+    const Tensor &q,
+    const Tensor &k,
+    const Tensor &v,
+    const Tensor &cuSeqlensQ,
+    const Tensor &cuSeqlensK) {
+  CHECK(q.getDType() == DType::kFloat && k.getDType() == DType::kFloat);
+  CHECK(v.getDType() == DType::kFloat);
+  CHECK(q.getDim() == 3 && k.getDim() == 3 && v.getDim() == 3);
+  CHECK(k.isContiguous() && v.isContiguous() && q.getStride(2) == 1);
+  CHECK(cuSeqlensQ.getDType() == DType::kLong && cuSeqlensQ.getDim() == 1);
+  CHECK(cuSeqlensK.getDType() == DType::kLong && cuSeqlensK.getDim() == 1);
+  CHECK(cuSeqlensQ.getShape(0) == cuSeqlensK.getShape(0) && cuSeqlensQ.getShape(0) >= 2);
+
+  int numQueries = q.getShape(0);
+  int numQHeads = q.getShape(1);
+  int headDim = q.getShape(2);
+  int numSeqs = cuSeqlensQ.getShape(0) - 1;
+  CHECK(numQHeads % k.getShape(1) == 0 && k.getShape(2) == headDim);
+
+  const LongType *cuQ = cuSeqlensQ.getData<LongType>();
+  const LongType *cuK = cuSeqlensK.getData<LongType>();
+  CHECK(cuQ[0] == 0 && cuQ[numSeqs] == numQueries);
+  CHECK(cuK[0] == 0 && cuK[numSeqs] == k.getShape(0));
+
+  // view of each sequence as a PagedKV with tiles of kVarlenTileSize tokens, and the cost (number
+  // of keys to visit) of each query.
+  std::vector<PagedKV> kvs(numSeqs);
+  std::vector<int> seqOfQuery(numQueries);
+  std::vector<int64_t> costs(numQueries);
+  for (int b = 0; b < numSeqs; ++b) {
+    int lenQ = static_cast<int>(cuQ[b + 1] - cuQ[b]);
+    int lenK = static_cast<int>(cuK[b + 1] - cuK[b]);
+    CHECK(lenQ >= 0 && lenQ <= lenK);
+
+    PagedKV &kv = kvs[b];
+    kv.blockSize = kVarlenTileSize;
+    kv.length = lenK;
+    for (int begin = 0; begin < lenK; begin += kVarlenTileSize) {
+      int end = static_cast<int>(cuK[b]) + std::min(begin + kVarlenTileSize, lenK);
+      kv.k.push_back(k.slice({static_cast<int>(cuK[b]) + begin, end}));
+      kv.v.push_back(v.slice({static_cast<int>(cuK[b]) + begin, end}));
+    }
+
+    // the queries are the last lenQ tokens of the sequence.
+    for (int i = 0; i < lenQ; ++i) {
+      seqOfQuery[cuQ[b] + i] = b;
+      costs[cuQ[b] + i] = lenK - lenQ + i + 1;
+    }
+  }
+
+  Tensor out = op::cpu::tensor({numQueries, numQHeads, headDim}, DType::kFloat);
+  float *outData = out.getData<float>();
+  const float *qData = q.getData<float>();
+  int64_t qStride0 = q.getStride(0);
+  int64_t qStride1 = q.getStride(1);
+
+  // balance the threads by the actual number of keys visited instead of the padded length.
+  std::vector<int> bounds = partitionByCost(lut::makeConstSpan(costs), MP::getMaxThreads() * 4);
+  MP::parallelFor(static_cast<int>(bounds.size()) - 1, [&](MP::Context ctx) {
+    std::vector<float> scores(kVarlenTileSize);
+    std::vector<float> buffer(headDim);
+    for (int i = bounds[ctx.getBlockIdx()]; i < bounds[ctx.getBlockIdx() + 1]; ++i) {
+      int b = seqOfQuery[i];
+      int pos = kvs[b].length - static_cast<int>(cuQ[b + 1] - i);
+      for (int h = 0; h < numQHeads; ++h) {
+        const float *pq = qData + i * qStride0 + h * qStride1;
+        float *po = outData + (static_cast<int64_t>(i) * numQHeads + h) * headDim;
+        attentionRow<float>(kvs[b], numQHeads, pos, h, pq, po, scores.data(), buffer.data());
+      }
+    }
+  });
+
+  return out;
+}
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
@@ -0,0 +1,126 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+#include "lten/tensor.h"
+
+namespace lten {
+namespace op {
+namespace cpu {
+
+/// @brief Keys and values of one layer of a sequence, stored in fixed-size blocks. The tokens of
+/// logical block `b` (tokens [b * blockSize, (b + 1) * blockSize)) are stored in k[b % k.size()],
+/// so the blocks could also be used as a ring buffer as long as the evicted tokens are outside the
+/// attention window.
+struct PagedKV {
+  /// @brief <dtype>(blockSize, numHeads, headDim) for each block. dtype could be float, float16
+  /// or int8.
+  std::vector<Tensor> k;
+  std::vector<Tensor> v;
+
+  /// @brief <float>(blockSize, numHeads) for each block. Only used in int8 storage.
+  std::vector<Tensor> kScale;
+  std::vector<Tensor> vScale;
+
+  int blockSize;
+
+  /// @brief number of tokens in the sequence.
+  int length;
+
+  /// @brief size of sliding window. The query at position p only attends to the keys in
+  /// (p - window, p]. 0 for no limit.
+  int window;
+
+  /// @brief chunk size of the chunked local attention. The query at position p only attends to
+  /// the keys in [p / chunkSize * chunkSize, p]. 0 for no limit.
+  int chunkSize;
+
+  /// @brief number of tokens at the beginning of the sequence that are always attended to, in
+  /// addition to the local window or chunk.
+  int numGlobalTokens;
+
+  /// @brief ALiBi slope of each query head. The bias of the key at position j for the query at
+  /// position p is -slope * (p - j). Empty for no ALiBi bias.
+  std::vector<float> alibiSlopes;
+
+  /// @brief <float>(numBuckets, numQHeads): bias of each relative position bucket (T5 style,
+  /// unidirectional). Empty for no relative position bias.
+  Tensor relativeBias;
+
+  /// @brief distance mapped to the last bucket of relativeBias.
+  int relativeMaxDistance;
+
+  PagedKV();
+};
+
+/// @brief Store the keys or values in float into the storage type of `dest`. For int8 storage,
+/// each (token, head) row is quantized symmetrically with its own scale.
+/// @param src <float>(N, numHeads, headDim): the input.
+/// @param dest <dtype>(N, numHeads, headDim): the storage.
+/// @param destScale <float>(N, numHeads): the scales for int8 storage. Empty for other types.
+void quantizeKV(const Tensor &src, Tensor &dest, Tensor &destScale);
+
+/// @brief Inverse of quantizeKV.
+/// @param src <dtype>(N, numHeads, headDim): the storage.
+/// @param srcScale <float>(N, numHeads): the scales for int8 storage. Empty for other types.
+/// @param dest <float>(N, numHeads, headDim): the output.
+void dequantizeKV(const Tensor &src, const Tensor &srcScale, Tensor &dest);
+
+/// @brief Scaled dot product attention of `q` against the keys and values in blocks. The queries
+/// are the last L tokens of the sequence and the causal mask is applied. Only the keys inside the
+/// window (or chunk) and the global tokens are visited. The position bias is computed inline for
+/// each visited score. Keys and values are dequantized inside the dot product and accumulate
+/// loops, no float copy of them is created.
+/// @param q <float>(L, numQHeads, headDim): the queries. numQHeads should be a multiple of the
+///     number of KV heads.
+/// @param kv the keys and values.
+/// @return <float>(L, numQHeads, headDim): the attention outputs.
+Tensor pagedAttention(const Tensor &q, const PagedKV &kv);
+
+/// @brief Causal attention of variable-length sequences packed without padding. The queries of
+/// sequence b are q[cuSeqlensQ[b]: cuSeqlensQ[b + 1]], they are the last tokens of its keys
+/// k[cuSeqlensK[b]: cuSeqlensK[b + 1]]. Each sequence attends only within itself. The work is
+/// partitioned by the number of keys each query visits.
+/// @param q <float>(totalQ, numQHeads, headDim): the packed queries.
+/// @param k <float>(totalK, numHeads, headDim): the packed keys.
+/// @param v <float>(totalK, numHeads, headDim): the packed values.
+/// @param cuSeqlensQ <long>(numSeqs + 1): the offsets of sequences in q.
+/// @param cuSeqlensK <long>(numSeqs + 1): the offsets of sequences in k and v.
+/// @return <float>(totalQ, numQHeads, headDim): the attention outputs.
+Tensor varlenAttention(
+    const Tensor &q,
+    const Tensor &k,
+    const Tensor &v,
+    const Tensor &cuSeqlensQ,
+    const Tensor &cuSeqlensK);
+
+/// @brief Get the bucket of relative position (T5 style, unidirectional). Half of the buckets are
+/// for the exact distances, the others cover distances up to `maxDistance` logarithmically.
+/// @param distance distance between query and key (query - key), should be >= 0.
+/// @param numBuckets number of buckets.
+/// @param maxDistance the distance mapped to the last bucket.
+/// @return the bucket index.
+int getRelativePositionBucket(int distance, int numBuckets, int maxDistance);
+
+}  // namespace cpu
+}  // namespace op
+}  // namespace lten
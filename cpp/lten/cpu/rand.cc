@@ -36,7 +36,11 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-Tensor randFp32(lut::Span<const int> shape, lut::Random *generator, float min, float max) {
+Tensor randFp32(
+    lut::Span<const Tensor::ShapeType> shape,
+    lut::Random *generator,
+    float min,
+    float max) {
   Tensor x = op::cpu::tensor(shape, DType::kFloat);
   lut::Span<float> tensorData(x.getData<float>(), x.getNumEl());
 
@@ -66,17 +70,30 @@ Tensor randFp32(lut::Span<const int> shape, lut::Random *generator, float min, f
   return x;
 }
 
-Tensor randFp16(lut::Span<const int> shape, lut::Random *generator, float min, float max) {
+Tensor randFp16(
+    lut::Span<const Tensor::ShapeType> shape,
+    lut::Random *generator,
+    float min,
+    float max) {
   Tensor x = randFp32(shape, generator, min, max);
   return castFp32ToFp16(x);
 }
 
-Tensor randQ4(lut::Span<const int> shape, lut::Random *generator, float min, float max) {
+Tensor randQ4(
+    lut::Span<const Tensor::ShapeType> shape,
+    lut::Random *generator,
+    float min,
+    float max) {
   Tensor x = randFp32(shape, generator, min, max);
   return op::cpu::castFp32ToQ4(x);
 }
 
-Tensor rand(lut::Span<const int> shape, DType dtype, lut::Random *generator, float min, float max) {
+Tensor rand(
+    lut::Span<const Tensor::ShapeType> shape,
+    DType dtype,
+    lut::Random *generator,
+    float min,
+    float max) {
   switch (int16_t(dtype)) {
     case DType::kFloat:
       return randFp32(shape, generator, min, max);
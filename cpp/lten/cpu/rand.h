@@ -26,9 +26,22 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-Tensor rand(lut::Span<const int> shape, DType dtype, lut::Random *generator, float min, float max);
-Tensor randFp32(lut::Span<const int> shape, lut::Random *generator, float min, float max);
-Tensor randQ4(lut::Span<const int> shape, lut::Random *generator, float min, float max);
+Tensor rand(
+    lut::Span<const Tensor::ShapeType> shape,
+    DType dtype,
+    lut::Random *generator,
+    float min,
+    float max);
+Tensor randFp32(
+    lut::Span<const Tensor::ShapeType> shape,
+    lut::Random *generator,
+    float min,
+    float max);
+Tensor randQ4(
+    lut::Span<const Tensor::ShapeType> shape,
+    lut::Random *generator,
+    float min,
+    float max);
 
 }  // namespace cpu
 }  // namespace op
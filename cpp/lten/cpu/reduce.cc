@@ -67,7 +67,7 @@ T getReduceInitial() {
 
 template<typename T, ReduceType REDUCE_TYPE>
 Tensor reduceKernel(Tensor A) {
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
   Tensor C = tensor(shape, A.getDType());
 
   TensorList<const T, 1> vA = TensorList<const T, 1>::fromTensor(A);
@@ -79,7 +79,7 @@ Tensor reduceKernel(Tensor A) {
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
     float accumulator = getReduceInitial<T, REDUCE_TYPE>();
-    for (int i = 0; i < a.getShape(0); i++) {
+    for (int64_t i = 0; i < a.getShape(0); i++) {
       if (REDUCE_TYPE == ReduceType::SUM) {
         accumulator += a[i];
       } else if (REDUCE_TYPE == ReduceType::MAX) {
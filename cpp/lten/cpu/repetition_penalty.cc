@@ -43,7 +43,7 @@ void repetitionPenalty2DKernel(Tensor logits, Tensor history, float weight) {
 
     // gather. Avoid the same logit penalizing twice.
     std::vector<T> scores(h.getShape(0));
-    for (int i = 0; i < h.getShape(0); ++i) {
+    for (int64_t i = 0; i < h.getShape(0); ++i) {
       LongType logitsIdx = h[i];
       CHECK(logitsIdx < a.getShape(0));
 
@@ -58,7 +58,7 @@ void repetitionPenalty2DKernel(Tensor logits, Tensor history, float weight) {
     };
 
     // scatter
-    for (int i = 0; i < h.getShape(0); ++i) {
+    for (int64_t i = 0; i < h.getShape(0); ++i) {
       LongType logitsIdx = h[i];
       a[logitsIdx] = scores[i];
     };
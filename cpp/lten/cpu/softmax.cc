@@ -31,12 +31,12 @@ namespace cpu {
 
 template<typename T>
 Tensor softmaxKernel(Tensor A) {
-  Tensor C = tensorLike(A);
+  Tensor C = tensorLikeOrReuse(A);
   TensorList<const T, 1> vA = TensorList<const T, 1>::fromTensor(A);
   TensorList<T, 1> vC = TensorList<T, 1>::fromTensor(C);
   CHECK(vA.getLength() == vC.getLength());
 
-  MP::parallelFor({vA.getLength()}, [&vA, &vC](MP::Context ctx) {
+  MP::parallelFor(vA.getLength(), [&vA, &vC](MP::Context ctx) {
     TensorAccessor<const T, 1> a = vA.getTensor(ctx.getBlockIdx());
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
@@ -44,12 +44,12 @@ Tensor softmaxKernel(Tensor A) {
     std::vector<float> d(a.getShape(0) + 1);
     m[0] = -1e10;
     d[0] = 0;
-    for (int i = 0; i < a.getShape(0); i++) {
+    for (int64_t i = 0; i < a.getShape(0); i++) {
       T x = a[i];
       m[i + 1] = fmaxf(m[i], x);
       d[i + 1] = d[i] * expf(m[i] - m[i + 1]) + expf(x - m[i + 1]);
     }
-    for (int i = 0; i < a.getShape(0); i++) {
+    for (int64_t i = 0; i < a.getShape(0); i++) {
       float x = a[i];
       c[i] = static_cast<T>(expf(x - m[a.getShape(0)]) / d[a.getShape(0)]);
     }
@@ -59,9 +59,9 @@ Tensor softmaxKernel(Tensor A) {
 }
 
 Tensor softmax(Tensor A) {
-  if (A.getDType() == DType::kFloat) return softmaxKernel<float>(A);
+  if (A.getDType() == DType::kFloat) return softmaxKernel<float>(std::move(A));
 #if LUT_CPU_ARCH == LUT_AARCH64
-  if (A.getDType() == DType::kFloat16) return softmaxKernel<Float16>(A);
+  if (A.getDType() == DType::kFloat16) return softmaxKernel<Float16>(std::move(A));
 #endif
 
   NOT_IMPL();
@@ -32,7 +32,7 @@ namespace cpu {
 
 template<typename T>
 Tensor swigluKernel(const Tensor &A) {
-  std::vector<int> shapeC = A.getShape();
+  std::vector<Tensor::ShapeType> shapeC = A.getShape();
   shapeC.back() /= 2;
   Tensor C = tensor(shapeC, DType::getType<T>());
 
@@ -41,12 +41,12 @@ Tensor swigluKernel(const Tensor &A) {
   CHECK(vA.getLength() == vC.getLength());
 
   MP::parallelFor(vA.getLength(), [&vA, &vC](MP::Context ctx) {
-    int j = ctx.getBlockIdx();
+    int64_t j = ctx.getBlockIdx();
     TensorAccessor<const T, 1> a = vA.getTensor(j);
     TensorAccessor<T, 1> c = vC.getTensor(j);
 
-    int n = c.getShape(0);
-    for (int i = 0; i < n; ++i) {
+    int64_t n = c.getShape(0);
+    for (int64_t i = 0; i < n; ++i) {
       T x = a[i];
       x *= 1.0f / (1 + expf(-x));
       x *= a[i + n];
@@ -26,12 +26,12 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-Tensor tensor(lut::Span<const int> shape, DType dtype) {
+Tensor tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype) {
   Tensor tensor;
 
-  auto tensorShape = std::make_shared<TensorShape>(lut::makeConstSpan(shape));
+  TensorShape tensorShape(shape);
 
-  int64_t numel = tensorShape->getNumEl();
+  int64_t numel = tensorShape.getNumEl();
   auto tensorData = CpuTensorData::create(numel, dtype);
 
   return Tensor::create(tensorShape, tensorData);
@@ -41,6 +41,11 @@ Tensor tensorLike(const Tensor &input) {
   return tensor(input.getShape(), input.getDType());
 }
 
+Tensor tensorLikeOrReuse(const Tensor &input) {
+  if (input.isContiguous() && input.isDataExclusive()) return input;
+  return tensorLike(input);
+}
+
 template<typename T>
 void fillZeroKernel(Tensor tensor) {
   // make sure tensor is contiguous.
@@ -68,7 +73,7 @@ void fillZero(Tensor tensor) {
   }
 }
 
-Tensor zeros(lut::Span<const int> shape, DType dtype) {
+Tensor zeros(lut::Span<const Tensor::ShapeType> shape, DType dtype) {
   Tensor x = tensor(shape, dtype);
   fillZero(x);
 
@@ -25,11 +25,17 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-Tensor tensor(lut::Span<const int> shape, DType dtype);
-Tensor zeros(lut::Span<const int> shape, DType dtype);
+Tensor tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype);
+Tensor zeros(lut::Span<const Tensor::ShapeType> shape, DType dtype);
 Tensor causalMask(int length, DType dtype);
 
 Tensor tensorLike(const Tensor &input);
+
+// get the output tensor of an elementwise operator, with the same shape and dtype as `input`. The
+// data of `input` is reused when `input` is contiguous and its data is exclusive. The operator
+// should take `input` by value, so that the data of a tensor still used by the caller is never
+// exclusive here.
+Tensor tensorLikeOrReuse(const Tensor &input);
 Tensor zerosLike(const Tensor &input);
 
 }  // namespace cpu
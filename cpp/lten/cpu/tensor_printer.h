@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <inttypes.h>
+#include <stdio.h>
+
 #include "lten/tensor.h"
 
 namespace lten {
@@ -96,7 +99,7 @@ class TensorPrinter {
     printf(", shape=(");
     for (int d = 0; d < DIM; ++d) {
       if (d) printf(", ");
-      printf("%d", tensor.getShape(d));
+      printf("%" PRId64, tensor.getShape(d));
     }
     printf("), dtype=%s)\n", DType::getType<T>().toString().c_str());
   }
@@ -30,8 +30,8 @@ namespace op {
 namespace cpu {
 
 template<typename T>
-Tensor transformKernel(const Tensor &A, float alpha, float beta) {
-  Tensor C = tensorLike(A);
+Tensor transformKernel(Tensor A, float alpha, float beta) {
+  Tensor C = tensorLikeOrReuse(A);
 
   TensorList<const T, 1> vA = TensorList<const T, 1>::fromTensor(A);
   TensorList<T, 1> vC = TensorList<T, 1>::fromTensor(C);
@@ -41,7 +41,7 @@ Tensor transformKernel(const Tensor &A, float alpha, float beta) {
     TensorAccessor<const T, 1> a = vA.getTensor(ctx.getBlockIdx());
     TensorAccessor<T, 1> c = vC.getTensor(ctx.getBlockIdx());
 
-    for (int i = 0; i < a.getShape(0); ++i) {
+    for (int64_t i = 0; i < a.getShape(0); ++i) {
       c[i] = a[i] * static_cast<T>(alpha) + static_cast<T>(beta);
     }
   });
@@ -49,10 +49,12 @@ Tensor transformKernel(const Tensor &A, float alpha, float beta) {
   return C;
 }
 
-Tensor transform(const Tensor &src, float alpha, float beta) {
-  if (src.getDType() == DType::kFloat) return transformKernel<float>(src, alpha, beta);
+Tensor transform(Tensor src, float alpha, float beta) {
+  if (src.getDType() == DType::kFloat) return transformKernel<float>(std::move(src), alpha, beta);
 #if LUT_CPU_ARCH == LUT_AARCH64
-  if (src.getDType() == DType::kFloat16) return transformKernel<Float16>(src, alpha, beta);
+  if (src.getDType() == DType::kFloat16) {
+    return transformKernel<Float16>(std::move(src), alpha, beta);
+  }
 #endif
 
   NOT_IMPL();
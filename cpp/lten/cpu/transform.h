@@ -26,7 +26,7 @@ namespace op {
 namespace cpu {
 
 // apply C <- alpha * A + beta
-Tensor transform(const Tensor &src, float alpha, float beta);
+Tensor transform(Tensor src, float alpha, float beta);
 
 }  // namespace cpu
 }  // namespace op
@@ -41,7 +41,7 @@ void unfold1DKernel(const Tensor &src, Tensor &dest, int kernelSize, int stride)
     CHECK(vA.getShape(0) / stride == vC.getShape(0));
 
     MP::parallelFor(vC.getShape(0), [&vA, &vC, kernelSize, stride](MP::Context ctx) {
-      int j = ctx.getBlockIdx();
+      int64_t j = ctx.getBlockIdx();
       int kernekIdxBegin = -(kernelSize / 2);
       int kernekIdxEnd = (kernelSize - 1) / 2;
       int numChannels = vA.getShape(1);
@@ -25,91 +25,87 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-std::vector<Tensor::ShapeType> getRealShape(int64_t numEl, lut::Span<const int> viewShape) {
-  std::vector<Tensor::ShapeType> shape{viewShape.begin(), viewShape.end()};
-  auto inferDim = shape.end();
-  auto it = shape.begin();
+TensorShape getRealShape(int64_t numEl, lut::Span<const Tensor::ShapeType> viewShape) {
+  CHECK(viewShape.size() <= TensorShape::MaxDim) << "too many dimensions.";
+
+  Tensor::ShapeType shape[TensorShape::MaxDim];
+  int dim = static_cast<int>(viewShape.size());
+  std::copy(viewShape.begin(), viewShape.end(), shape);
+
+  int inferDim = -1;
   int64_t viewNumEl = 1;
-  for (; it != shape.end(); ++it) {
-    if (*it < 0) {
-      CHECK(inferDim == shape.end()) << "more than 1 inferred dim";
-      inferDim = it;
+  for (int d = 0; d < dim; ++d) {
+    if (shape[d] < 0) {
+      CHECK(inferDim < 0) << "more than 1 inferred dim";
+      inferDim = d;
     } else {
-      viewNumEl *= *it;
+      viewNumEl *= shape[d];
     }
   }
 
   // handle -1 shape
-  if (inferDim != shape.end()) {
+  if (inferDim >= 0) {
     CHECK(numEl % viewNumEl == 0) << "inferred shape is not a integer";
-    *inferDim = static_cast<Tensor::ShapeType>(numEl / viewNumEl);
+    shape[inferDim] = static_cast<Tensor::ShapeType>(numEl / viewNumEl);
   } else {
     CHECK(numEl == viewNumEl) << "invalid view (element number mismatch)";
   }
 
-  return shape;
+  return TensorShape(lut::makeConstSpan(shape, dim));
 }
 
-std::vector<TensorShape::Elem> mergeContigShape(const Tensor &src) {
-  std::vector<TensorShape::Elem> mergedShape;
+TensorShape mergeContigShape(const Tensor &src) {
+  TensorShape::Elem mergedShape[TensorShape::MaxDim];
+  int numMerged = 0;
   for (int d = src.getDim() - 1; d >= 0; --d) {
     CHECK(src.getStride(d) != 0) << "unable to change view of expanded tensor.";
 
-    if (d == src.getDim() - 1) {
-      TensorShape::Elem s;
-      s.shape = src.getShape(d);
-      s.stride = src.getStride(d);
-      mergedShape.push_back(s);
-    } else if (src.getStride(d + 1) * src.getShape(d + 1) == src.getStride(d)) {
+    if (d != src.getDim() - 1 && src.getStride(d + 1) * src.getShape(d + 1) == src.getStride(d)) {
       // this dimension is contiguous.
-      mergedShape.back().shape *= src.getShape(d);
+      mergedShape[numMerged - 1].shape *= src.getShape(d);
     } else {
       TensorShape::Elem s;
       s.shape = src.getShape(d);
       s.stride = src.getStride(d);
-      mergedShape.push_back(s);
+      mergedShape[numMerged++] = s;
     }
   }
 
-  std::reverse(mergedShape.begin(), mergedShape.end());
-  return mergedShape;
+  std::reverse(mergedShape, mergedShape + numMerged);
+  return TensorShape(lut::makeConstSpan(mergedShape, numMerged));
 }
 
-std::vector<TensorShape::Elem> getViewShapeStride(const Tensor &src, lut::Span<const int> view) {
-  std::vector<TensorShape::Elem> mergedShape = mergeContigShape(src);
-  std::vector<TensorShape::Elem> viewShape;
-  auto vi = view.rbegin();
-  for (int64_t d = mergedShape.size() - 1; d >= 0; --d) {
-    TensorShape::Elem ms = mergedShape[d];
-    int numel = 1;
-    while (vi != view.rend() && *vi * numel <= ms.shape) {
-      TensorShape::Elem s;
-      s.shape = *vi;
-      s.stride = numel * ms.stride;
-      viewShape.push_back(s);
+TensorShape getViewShapeStride(const Tensor &src, const TensorShape &view) {
+  TensorShape mergedShape = mergeContigShape(src);
+  lut::Span<const TensorShape::Elem> merged = mergedShape.getData_();
+
+  TensorShape::Elem viewShape[TensorShape::MaxDim];
+  int vi = view.getDim() - 1;
+  for (int d = mergedShape.getDim() - 1; d >= 0; --d) {
+    TensorShape::Elem ms = merged[d];
+    Tensor::ShapeType numel = 1;
+    while (vi >= 0 && view.getShape(vi) * numel <= ms.shape) {
+      viewShape[vi].shape = view.getShape(vi);
+      viewShape[vi].stride = numel * ms.stride;
 
-      numel *= *vi;
-      ++vi;
+      numel *= view.getShape(vi);
+      --vi;
     }
 
     CHECK(numel == ms.shape) << "unable to get view of tensor.";
   }
 
-  std::reverse(viewShape.begin(), viewShape.end());
-  return viewShape;
+  CHECK(vi < 0) << "unable to get view of tensor.";
+  return TensorShape(lut::makeConstSpan(viewShape, view.getDim()));
 }
 
-Tensor view(const Tensor &src, lut::Span<const int> view) {
-  std::vector<Tensor::ShapeType> shape = getRealShape(src.getNumEl(), view);
+Tensor view(const Tensor &src, lut::Span<const Tensor::ShapeType> view) {
+  TensorShape shape = getRealShape(src.getNumEl(), view);
   if (src.isContiguous()) {
-    return Tensor::create(
-        std::make_shared<TensorShape>(shape),
-        src.getDataShared_(),
-        src.getOffset_());
+    return Tensor::create(shape, src.getDataShared_(), src.getOffset_());
   } else {
-    std::vector<TensorShape::Elem> viewShape = getViewShapeStride(src, view);
     return Tensor::create(
-        std::make_shared<TensorShape>(viewShape),
+        getViewShapeStride(src, shape),
         src.getDataShared_(),
         src.getOffset_());
   }
@@ -26,16 +26,16 @@ namespace lten {
 namespace op {
 namespace cpu {
 
-Tensor view(const Tensor &src, lut::Span<const int> view);
+Tensor view(const Tensor &src, lut::Span<const Tensor::ShapeType> view);
 
-// infer the -1 dimension in view.
-std::vector<Tensor::ShapeType> getRealShape(int64_t numEl, lut::Span<const int> view);
+// infer the -1 dimension in view. Returns the contiguous shape of the view.
+TensorShape getRealShape(int64_t numEl, lut::Span<const Tensor::ShapeType> view);
 
 // infer the stride for new view, according to the original stride.
-std::vector<TensorShape::Elem> getViewShapeStride(const Tensor &src, lut::Span<const int> view);
+TensorShape getViewShapeStride(const Tensor &src, const TensorShape &view);
 
 // merge contiguous dimensions in the shape of `src`.
-std::vector<TensorShape::Elem> mergeContigShape(const Tensor &src);
+TensorShape mergeContigShape(const Tensor &src);
 
 }  // namespace cpu
 }  // namespace op
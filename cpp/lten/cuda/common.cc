@@ -39,23 +39,23 @@ PackedSubtensor2DQInt4x32::PackedSubtensor2DQInt4x32(const Tensor &tensor) {
   _data = tensor.getDataObject()->getData<QInt4x32>();
 }
 
-Tensor createCudaTensorHalf(lut::Span<const int> shape) {
-  auto tensorShape = std::make_shared<TensorShape>(shape);
-  auto data = CudaTensorData::create(tensorShape->getNumEl(), DType::kFloat16);
+Tensor createCudaTensorHalf(lut::Span<const Tensor::ShapeType> shape) {
+  TensorShape tensorShape(shape);
+  auto data = CudaTensorData::create(tensorShape.getNumEl(), DType::kFloat16);
 
   return Tensor::create(tensorShape, data);
 }
 
-Tensor createCudaTensorLong(lut::Span<const int> shape) {
-  auto tensorShape = std::make_shared<TensorShape>(shape);
-  auto data = CudaTensorData::create(tensorShape->getNumEl(), DType::kLong);
+Tensor createCudaTensorLong(lut::Span<const Tensor::ShapeType> shape) {
+  TensorShape tensorShape(shape);
+  auto data = CudaTensorData::create(tensorShape.getNumEl(), DType::kLong);
 
   return Tensor::create(tensorShape, data);
 }
 
-Tensor createCudaTensorFloat(lut::Span<const int> shape) {
-  auto tensorShape = std::make_shared<TensorShape>(shape);
-  auto data = CudaTensorData::create(tensorShape->getNumEl(), DType::kFloat);
+Tensor createCudaTensorFloat(lut::Span<const Tensor::ShapeType> shape) {
+  TensorShape tensorShape(shape);
+  auto data = CudaTensorData::create(tensorShape.getNumEl(), DType::kFloat);
 
   return Tensor::create(tensorShape, data);
 }
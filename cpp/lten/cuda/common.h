@@ -97,9 +97,9 @@ lut::c_ptr<T> llynCudaAlloc(int64_t n) {
   return {p, llynCudaFree};
 }
 
-Tensor createCudaTensorHalf(lut::Span<const int> shape);
-Tensor createCudaTensorLong(lut::Span<const int> shape);
-Tensor createCudaTensorFloat(lut::Span<const int> shape);
+Tensor createCudaTensorHalf(lut::Span<const Tensor::ShapeType> shape);
+Tensor createCudaTensorLong(lut::Span<const Tensor::ShapeType> shape);
+Tensor createCudaTensorFloat(lut::Span<const Tensor::ShapeType> shape);
 
 /// @brief Split a index into dim3 object according to the shape info in `size`.
 /// @param index the index to split.
@@ -126,7 +126,7 @@ Tensor CudaOperators::applyRotaryPosEmb(Tensor A, Tensor roPE) {
   return op::cuda::applyRotaryPosEmb(A, roPE);
 }
 
-Tensor CudaOperators::tensor(lut::Span<const int> shape, DType dtype) {
+Tensor CudaOperators::tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype) {
   if (dtype == DType::kFloat16) return createCudaTensorHalf(shape);
 
   NOT_IMPL();
@@ -179,7 +179,7 @@ DType CudaOperators::getDefaultFloatType() {
   return DType::kFloat16;
 }
 
-Tensor CudaOperators::zeros(lut::Span<const int> shape, DType) {
+Tensor CudaOperators::zeros(lut::Span<const Tensor::ShapeType> shape, DType) {
   Tensor tensor = createCudaTensorHalf(shape);
   op::cuda::fill(tensor, 0.0);
 
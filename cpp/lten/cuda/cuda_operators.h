@@ -59,11 +59,11 @@ class CudaOperators : public Operators {
   Tensor softmax(Tensor input) override;
   Tensor sum(Tensor inputs) override;
   Tensor swiglu(Tensor A) override;
-  Tensor tensor(lut::Span<const int> shape, DType dtype) override;
+  Tensor tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype) override;
   Tensor tensorLike(Tensor input) override;
   Tensor to(Device device, Tensor tensor) override;
   Tensor unfold(Tensor input, int kernelSize, int stride) override;
-  Tensor zeros(lut::Span<const int> shape, DType dtype) override;
+  Tensor zeros(lut::Span<const Tensor::ShapeType> shape, DType dtype) override;
 
   DType getDefaultFloatType() override;
 
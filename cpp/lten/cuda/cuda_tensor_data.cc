@@ -24,6 +24,7 @@
 #include "lten/cuda/common.h"
 #include "lten/device.h"
 #include "lten/dtype.h"
+#include "lten/memory_stats.h"
 #include "lutil/error.h"
 #include "lutil/platform.h"
 #include "lutil/span.h"
@@ -73,6 +74,7 @@ std::shared_ptr<TensorData> CudaTensorData::create(
     if (err != cudaSuccess) {
       throw lut::AbortedError(cudaGetErrorString(err));
     }
+    recordTensorDataAlloc(Device::kCuda, size);
 
     tensorData->_slots[tensorData->_numSlot].data = reinterpret_cast<Byte *>(data);
     tensorData->_slots[tensorData->_numSlot].numel = numel;
@@ -87,6 +89,7 @@ std::shared_ptr<TensorData> CudaTensorData::create(
 CudaTensorData::~CudaTensorData() {
   for (int i = 0; i < _numSlot; ++i) {
     if (_slots[i].data) {
+      recordTensorDataFree(Device::kCuda, _slots[i].getSizeInBytes());
       llynCudaFree(_slots[i].data);
       _slots[i].data = nullptr;
     }
@@ -114,7 +114,7 @@ Tensor MatMul::matmulQ4(const Tensor &A, const Tensor &B) {
 }
 
 Tensor MatMul::bmmToGemmQ4(const Tensor &A, const Tensor &B) {
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
 
   Tensor xA = A.view({-1, A.getShape(-1)});
   Tensor xC = gemmQ4(xA, B);
@@ -155,7 +155,7 @@ template<>
 std::vector<const half *> getBatchImpl<1>(const Tensor &A) {
   const half *base = A.getData<half>();
 
-  int stride0 = A.getStride(0);
+  int64_t stride0 = A.getStride(0);
   std::vector<const half *> batch;
   for (int i = 0; i < A.getShape(0); ++i) {
     batch.push_back(base + i * stride0);
@@ -167,8 +167,8 @@ template<>
 std::vector<const half *> getBatchImpl<2>(const Tensor &A) {
   const half *base = A.getData<half>();
 
-  int stride0 = A.getStride(0);
-  int stride1 = A.getStride(1);
+  int64_t stride0 = A.getStride(0);
+  int64_t stride1 = A.getStride(1);
   std::vector<const half *> batch;
   for (int i = 0; i < A.getShape(0); ++i) {
     for (int j = 0; j < A.getShape(1); ++j) {
@@ -186,7 +186,7 @@ std::vector<const half *> MatMul::getBatch(const Tensor &A, int nBatchDim) {
 }
 
 Tensor MatMul::bmmToGemmHalf(const Tensor &A, const Tensor &B) {
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
 
   Tensor xA = A.view({-1, A.getShape(-1)});
   Tensor xC = gemmHalf(xA, B);
@@ -199,7 +199,7 @@ Tensor MatMul::bmmHalf(Tensor A, Tensor B) {
   Tensor xB = B;
   if (A.getDim() != B.getDim()) xB = op::cpu::expandBatchDims(B, A.getShape());
 
-  std::vector<int> shapeC = op::cpu::getBmmOutputShape(A, xB);
+  std::vector<Tensor::ShapeType> shapeC = op::cpu::getBmmOutputShape(A, xB);
   Tensor C = createCudaTensorHalf(shapeC);
 
   int nBatchDim = A.getDim() - 2;
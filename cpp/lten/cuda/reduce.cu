@@ -149,7 +149,7 @@ Tensor reduceHalfToSingle3D(Tensor A, MapReduceType reduceType) {
   CHECK(A.getDType() == DType::kFloat16);
   CHECK(A.getDim() == 3);
 
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
   shape.pop_back();
 
   Tensor C = createCudaTensorFloat(shape);
@@ -209,7 +209,7 @@ Tensor reduceHalf3D(Tensor A, MapReduceType reduceType) {
   CHECK(A.getDType() == DType::kFloat16);
   CHECK(A.getDim() == 3);
 
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
   shape.pop_back();
 
   Tensor C = createCudaTensorHalf(shape);
@@ -85,7 +85,7 @@ Tensor softmaxHalf2D(Tensor A) {
 }
 
 Tensor softmaxHalf4D(Tensor A) {
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
 
   Tensor xA = A.view({-1, A.getShape(2), A.getShape(3)});
   Tensor C = softmaxHalf3D(xA);
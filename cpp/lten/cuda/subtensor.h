@@ -23,6 +23,7 @@
 #include <cuda_runtime.h>
 #include <stdint.h>
 
+#include <limits>
 #include <type_traits>
 
 #include "lten/cuda/cuda_tensor_data.h"
@@ -97,7 +98,7 @@ class PackedSubtensorBase {
     CHECK(tensor.getDim() == DIM);
     _data = tensor.getData<T>();
     for (int i = 0; i < DIM; ++i) {
-      _size[i] = Size{tensor.getShape(i), tensor.getStride(i)};
+      _size[i] = getSize(tensor, i);
     }
   }
 
@@ -105,7 +106,7 @@ class PackedSubtensorBase {
     CHECK(tensor.getDim() == DIM);
     _data = tensor.getData<T>();
     for (int i = 0; i < DIM; ++i) {
-      _size[i] = Size{tensor.getShape(i), tensor.getStride(i)};
+      _size[i] = getSize(tensor, i);
     }
   }
 
@@ -122,6 +123,15 @@ class PackedSubtensorBase {
  protected:
   Size _size[DIM];
   T *_data;
+
+  // the CUDA kernels index with 32-bit integers, so the shape and stride should fit in int32_t.
+  __host__ static Size getSize(const Tensor &tensor, int d) {
+    CHECK(tensor.getShape(d) <= std::numeric_limits<int32_t>::max());
+    CHECK(tensor.getStride(d) <= std::numeric_limits<int32_t>::max());
+    return Size{
+        static_cast<int32_t>(tensor.getShape(d)),
+        static_cast<int32_t>(tensor.getStride(d))};
+  }
 };
 
 template<typename T, int DIM>
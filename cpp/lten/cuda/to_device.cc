@@ -104,8 +104,7 @@ Tensor toDevice(const Tensor &tensor) {
   }
 
   // create dest tesnor.
-  auto shape = std::make_shared<TensorShape>(tensor.getShape());
-  return Tensor::create(shape, destData);
+  return Tensor::create(TensorShape(lut::makeConstSpan(tensor.getShape())), destData);
 }
 
 Tensor toCpu(const Tensor &tensor) {
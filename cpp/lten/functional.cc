@@ -50,26 +50,26 @@ Tensor matmul(Tensor A, Tensor B) {
 }
 
 Tensor mul(Tensor input, float other) {
-  return getOperators(input.getDevice().getType())->mul(input, other);
+  return getOperators(input.getDevice().getType())->mul(std::move(input), other);
 }
 
 Tensor mul(Tensor input, Tensor other) {
-  return getOperators(input.getDevice().getType())->mul(input, other);
+  return getOperators(input.getDevice().getType())->mul(std::move(input), other);
 }
 
 Tensor softmax(Tensor input) {
-  return getOperators(input.getDevice().getType())->softmax(input);
+  return getOperators(input.getDevice().getType())->softmax(std::move(input));
 }
 
 Tensor add(Tensor input, Tensor other) {
-  return getOperators(input.getDevice().getType())->add(input, other);
+  return getOperators(input.getDevice().getType())->add(std::move(input), other);
 }
 
 Tensor gelu(Tensor input) {
-  return getOperators(input.getDevice().getType())->gelu(input);
+  return getOperators(input.getDevice().getType())->gelu(std::move(input));
 }
 
-Tensor tensor(lut::Span<const int> shape, DType dtype, Device device) {
+Tensor tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype, Device device) {
   return getOperators(device.getType())->tensor(shape, dtype);
 }
 
@@ -78,7 +78,7 @@ Tensor tensorLike(Tensor input) {
 }
 
 Tensor rand(
-    lut::Span<const int> shape,
+    lut::Span<const Tensor::ShapeType> shape,
     DType dtype,
     Device device,
     lut::Random *generator,
@@ -87,7 +87,7 @@ Tensor rand(
   return getOperators(device.getType())->rand(shape, dtype, generator, min, max);
 }
 
-Tensor zeros(lut::Span<const int> shape, DType dtype, Device device) {
+Tensor zeros(lut::Span<const Tensor::ShapeType> shape, DType dtype, Device device) {
   return getOperators(device.getType())->zeros(shape, dtype);
 }
 
@@ -115,7 +115,7 @@ Tensor cat(Tensor A, Tensor B, int dim) {
   dim = A.getShape_()->getRealDim(dim);
   CHECK(A.getDim() == B.getDim() && dim < A.getDim());
 
-  std::vector<int> shape = A.getShape();
+  std::vector<Tensor::ShapeType> shape = A.getShape();
   int dA = A.getShape(dim);
   int dB = B.getShape(dim);
   shape[dim] = dA + dB;
@@ -152,6 +152,11 @@ void copy(Tensor src, Tensor dest) {
   }
 }
 
+Tensor varlenAttention(Tensor q, Tensor k, Tensor v, Tensor cuSeqlensQ, Tensor cuSeqlensK) {
+  return getOperators(q.getDevice().getType())
+      ->varlenAttention(q, k, v, cuSeqlensQ, cuSeqlensK);
+}
+
 void repetitionPenalty(Tensor logits, Tensor history, float weight) {
   getOperators(logits.getDevice().getType())->repetitionPenalty(logits, history, weight);
 }
@@ -64,6 +64,11 @@ Tensor rmsNorm(Tensor input, Tensor weight, float eps);
 //   <float>(<batch-dims>, M): matrix multiplication result of A and B.
 Tensor matmul(Tensor A, Tensor B);
 
+// For the element wise operators mul, softmax, add and gelu: when `input` is moved in (or is a
+// temporary), it is contiguous and no other tensor shares its data, the CPU operator writes the
+// output into the data of `input` instead of allocating a new tensor. For example:
+//   x = F::gelu(std::move(x));
+
 // Element wise multiply input and other.
 Tensor mul(Tensor input, float other);
 Tensor mul(Tensor input, Tensor other);
@@ -89,7 +94,10 @@ Tensor gelu(Tensor input);
 //   dtype: data type of the new tensor.
 // Returns:
 //   the tensor with specified shape and dtype.
-Tensor tensor(lut::Span<const int> shape, DType dtype, Device device = Device::getCpu());
+Tensor tensor(
+    lut::Span<const Tensor::ShapeType> shape,
+    DType dtype,
+    Device device = Device::getCpu());
 
 /// @brief Generate a tensor filled with uniform random numbers in range [min, max)
 /// @param shape shape of the tensor to generated.
@@ -100,7 +108,7 @@ Tensor tensor(lut::Span<const int> shape, DType dtype, Device device = Device::g
 /// @param max maximum value for random number generator.
 /// @return Generated random tensor.
 Tensor rand(
-    lut::Span<const int> shape,
+    lut::Span<const Tensor::ShapeType> shape,
     DType dtype,
     Device device = Device::getCpu(),
     lut::Random *generator = nullptr,
@@ -111,7 +119,10 @@ Tensor rand(
 Tensor tensorLike(Tensor input);
 
 // Returns a tensor filled with 0
-Tensor zeros(lut::Span<const int> shape, DType dtype, Device device = Device::getCpu());
+Tensor zeros(
+    lut::Span<const Tensor::ShapeType> shape,
+    DType dtype,
+    Device device = Device::getCpu());
 
 // Return a contiguous in memory tensor containing the same data as input
 Tensor contiguous(Tensor input);
@@ -208,6 +219,20 @@ Tensor unfold(Tensor input, int kernelSize, int stride);
 /// @return <float>(feature_len, FeatDim=80): the logMelSpectrogram feature.
 Tensor logMelSpectrogram(Tensor wave);
 
+/// @brief Causal attention of variable-length sequences packed into one tensor without padding
+/// (like the varlen interface of FlashAttention). The queries of sequence b are
+/// q[cuSeqlensQ[b]: cuSeqlensQ[b + 1]]. They are the last tokens of the sequence whose keys and
+/// values are k[cuSeqlensK[b]: cuSeqlensK[b + 1]]. Each sequence attends only within itself.
+/// For prefill, cuSeqlensQ and cuSeqlensK are the same.
+/// @param q <float>(totalQ, numQHeads, headDim): the packed queries.
+/// @param k <float>(totalK, numHeads, headDim): the packed keys. numQHeads should be a multiple of
+///     numHeads.
+/// @param v <float>(totalK, numHeads, headDim): the packed values.
+/// @param cuSeqlensQ <long>(numSeqs + 1): the cumulative sequence lengths of q, starts with 0.
+/// @param cuSeqlensK <long>(numSeqs + 1): the cumulative sequence lengths of k and v.
+/// @return <float>(totalQ, numQHeads, headDim): the attention outputs.
+Tensor varlenAttention(Tensor q, Tensor k, Tensor v, Tensor cuSeqlensQ, Tensor cuSeqlensK);
+
 /// @brief Apply repetition penalty to the logits tensor according to the history tensor.
 /// @param logits <float>(N, vocab_size): the logits tensor to apply repetition penalty.
 /// @param history <long>(N, hsitory_len): the token history.
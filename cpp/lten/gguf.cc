@@ -0,0 +1,503 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/gguf.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "lten/cpu/arena.h"
+#include "lten/cpu/cpu_tensor_data.h"
+#include "lten/functional.h"
+#include "lten/mp.h"
+#include "lutil/error.h"
+#include "lutil/half.h"
+#include "lutil/mapped_file.h"
+#include "lutil/strings.h"
+
+namespace lten {
+
+namespace {
+
+constexpr uint32_t Magic = 0x46554747;  // "GGUF"
+constexpr int64_t DefaultAlignment = 32;
+
+// limits of the header to reject the corrupted files early.
+constexpr int64_t MaxCount = 1024 * 1024 * 1024;
+constexpr int MaxDim = 4;
+
+// value types of the metadata.
+enum GGUFType : uint32_t {
+  kUInt8 = 0,
+  kInt8 = 1,
+  kUInt16 = 2,
+  kInt16 = 3,
+  kUInt32 = 4,
+  kInt32 = 5,
+  kFloat32 = 6,
+  kBool = 7,
+  kString = 8,
+  kArray = 9,
+  kUInt64 = 10,
+  kInt64 = 11,
+  kFloat64 = 12,
+};
+
+// tensor types of ggml.
+enum GGMLType : uint32_t {
+  kGGMLF32 = 0,
+  kGGMLF16 = 1,
+  kGGMLQ4_0 = 2,
+  kGGMLQ8_0 = 8,
+};
+
+constexpr int GGMLBlockSize = 32;
+
+struct BlockQ4_0 {
+  uint16_t d;
+  uint8_t qs[GGMLBlockSize / 2];
+};
+static_assert(sizeof(BlockQ4_0) == 18, "invalid size of BlockQ4_0");
+
+struct BlockQ8_0 {
+  uint16_t d;
+  int8_t qs[GGMLBlockSize];
+};
+static_assert(sizeof(BlockQ8_0) == 34, "invalid size of BlockQ8_0");
+static_assert(GGMLBlockSize == QInt4x32::GroupSize, "block size mismatch");
+
+// number of blocks converted by a task in the parallel loop.
+constexpr int64_t BlocksPerTask = 4096;
+
+// returns the size in bytes of `numel` elements in `type`, or -1 for the unsupported types.
+int64_t getGGMLSize(uint32_t type, int64_t numel) {
+  switch (type) {
+    case kGGMLF32:
+      return numel * 4;
+    case kGGMLF16:
+      return numel * 2;
+    case kGGMLQ4_0:
+      return numel / GGMLBlockSize * sizeof(BlockQ4_0);
+    case kGGMLQ8_0:
+      return numel / GGMLBlockSize * sizeof(BlockQ8_0);
+    default:
+      return -1;
+  }
+}
+
+// apply `closure(begin, end)` to the ranges of [0, numBlocks) on the worker threads.
+void parallelForBlocks(int64_t numBlocks, std::function<void(int64_t, int64_t)> closure) {
+  int numTasks = static_cast<int>((numBlocks + BlocksPerTask - 1) / BlocksPerTask);
+  MP::parallelFor(numTasks, [numBlocks, &closure](MP::Context ctx) {
+    int64_t begin = ctx.getBlockIdx() * BlocksPerTask;
+    closure(begin, std::min(begin + BlocksPerTask, numBlocks));
+  });
+}
+
+// Q4_0 is (q - 8) * d with the element i and i + 16 in byte i. QInt4x32 is q * scale - zero with
+// the elements 2i and 2i + 1 in byte i.
+void transcodeQ4_0(const BlockQ4_0 *src, QInt4x32 *dest, int64_t numBlocks) {
+  parallelForBlocks(numBlocks, [src, dest](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const uint8_t *qs = src[i].qs;
+      uint8_t *data = dest[i].data;
+      for (int j = 0; j < GGMLBlockSize / 4; ++j) {
+        data[j] = (qs[2 * j] & 0xf) | (qs[2 * j + 1] << 4);
+        data[j + GGMLBlockSize / 4] = (qs[2 * j] >> 4) | (qs[2 * j + 1] & 0xf0);
+      }
+
+      // 8 * d is exact in float16.
+      uint16_t zero = lut::cvtss_sh(8.0f * lut::cvtsh_ss(src[i].d));
+      memcpy(&dest[i].scale, &src[i].d, sizeof(uint16_t));
+      memcpy(&dest[i].zero, &zero, sizeof(uint16_t));
+    }
+  });
+}
+
+void dequantQ8_0(const BlockQ8_0 *src, float *dest, int64_t numBlocks) {
+  parallelForBlocks(numBlocks, [src, dest](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      float d = lut::cvtsh_ss(src[i].d);
+      float *y = dest + i * GGMLBlockSize;
+      for (int j = 0; j < GGMLBlockSize; ++j) {
+        y[j] = d * src[i].qs[j];
+      }
+    }
+  });
+}
+
+// cast between the types that F::cast() supports only through float32.
+Tensor castTensor(Tensor tensor, DType dtype) {
+  if (tensor.getDType() == dtype) return tensor;
+  if (tensor.getDType() != DType::kFloat && dtype != DType::kFloat) {
+    tensor = F::cast(tensor, DType::kFloat);
+  }
+
+  return F::cast(tensor, dtype);
+}
+
+}  // namespace
+
+// parses the header in the mapped file.
+class GGUFFile::Parser {
+ public:
+  Parser(lut::Span<const int8_t> data)
+      : _data(data),
+        _pos(0) {
+  }
+
+  int64_t getPosition() const {
+    return _pos;
+  }
+
+  template<typename T>
+  T readValue() {
+    T value;
+    memcpy(&value, read(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  std::string readString() {
+    uint64_t length = readValue<uint64_t>();
+    if (length > static_cast<uint64_t>(_data.size())) THROW(Aborted, "invalid string in gguf.");
+
+    return std::string(reinterpret_cast<const char *>(read(length)), length);
+  }
+
+  int64_t readCount() {
+    uint64_t count = readValue<uint64_t>();
+    if (count > MaxCount) THROW(Aborted, "invalid count in gguf.");
+
+    return static_cast<int64_t>(count);
+  }
+
+  // get the kind of metadata value with `type`.
+  static ValueKind getKind(uint32_t type) {
+    switch (type) {
+      case kUInt8:
+      case kInt8:
+      case kUInt16:
+      case kInt16:
+      case kUInt32:
+      case kInt32:
+      case kUInt64:
+      case kInt64:
+        return ValueKind::kInt;
+      case kFloat32:
+      case kFloat64:
+        return ValueKind::kFloat;
+      case kBool:
+        return ValueKind::kBool;
+      case kString:
+        return ValueKind::kString;
+      default:
+        THROW(Aborted, lut::sprintf("unsupported value type in gguf: %d", type));
+    }
+  }
+
+  // read a value of metadata with `type` and append it to `value`.
+  void readValue(uint32_t type, Value *value) {
+    switch (type) {
+      case kUInt8:
+        value->ints.push_back(readValue<uint8_t>());
+        break;
+      case kInt8:
+        value->ints.push_back(readValue<int8_t>());
+        break;
+      case kUInt16:
+        value->ints.push_back(readValue<uint16_t>());
+        break;
+      case kInt16:
+        value->ints.push_back(readValue<int16_t>());
+        break;
+      case kUInt32:
+        value->ints.push_back(readValue<uint32_t>());
+        break;
+      case kInt32:
+        value->ints.push_back(readValue<int32_t>());
+        break;
+      case kUInt64:
+        value->ints.push_back(static_cast<int64_t>(readValue<uint64_t>()));
+        break;
+      case kInt64:
+        value->ints.push_back(readValue<int64_t>());
+        break;
+      case kFloat32:
+        value->floats.push_back(readValue<float>());
+        break;
+      case kFloat64:
+        value->floats.push_back(readValue<double>());
+        break;
+      case kBool:
+        value->ints.push_back(readValue<uint8_t>() != 0);
+        break;
+      case kString:
+        value->strings.emplace_back(readString());
+        break;
+      default:
+        THROW(Aborted, lut::sprintf("unsupported value type in gguf: %d", type));
+    }
+  }
+
+ private:
+  lut::Span<const int8_t> _data;
+  int64_t _pos;
+
+  const int8_t *read(int64_t n) {
+    if (n > static_cast<int64_t>(_data.size()) - _pos) THROW(Aborted, "unexpected EOF in gguf.");
+
+    const int8_t *p = _data.data() + _pos;
+    _pos += n;
+    return p;
+  }
+};
+
+GGUFFile::GGUFFile()
+    : _dataOffset(0) {
+}
+
+std::shared_ptr<GGUFFile> GGUFFile::open(const std::string &filename) {
+  std::shared_ptr<GGUFFile> gguf{new GGUFFile()};
+  gguf->_file = lut::MappedFile::open(filename);
+  gguf->parseHeader();
+
+  return gguf;
+}
+
+void GGUFFile::parseHeader() {
+  Parser parser(_file->getData());
+  if (parser.readValue<uint32_t>() != Magic) THROW(Aborted, "invalid gguf file.");
+
+  uint32_t version = parser.readValue<uint32_t>();
+  if (version != 2 && version != 3) {
+    THROW(Aborted, lut::sprintf("unsupported gguf version: %d", version));
+  }
+
+  int64_t numTensors = parser.readCount();
+  int64_t numMetadata = parser.readCount();
+
+  for (int64_t i = 0; i < numMetadata; ++i) {
+    std::string key = parser.readString();
+    uint32_t type = parser.readValue<uint32_t>();
+
+    Value value;
+    value.isArray = type == kArray;
+    if (value.isArray) {
+      uint32_t elemType = parser.readValue<uint32_t>();
+      int64_t length = parser.readCount();
+      if (elemType == kArray) THROW(Aborted, "nested array in gguf is not supported.");
+
+      value.kind = Parser::getKind(elemType);
+      for (int64_t j = 0; j < length; ++j) parser.readValue(elemType, &value);
+    } else {
+      value.kind = Parser::getKind(type);
+      parser.readValue(type, &value);
+    }
+
+    _metadata[key] = std::move(value);
+  }
+
+  for (int64_t i = 0; i < numTensors; ++i) {
+    std::string name = parser.readString();
+    uint32_t numDim = parser.readValue<uint32_t>();
+    if (numDim == 0 || numDim > MaxDim) THROW(Aborted, "invalid tensor rank in gguf.");
+
+    TensorInfo info;
+    int64_t numel = 1;
+    for (uint32_t d = 0; d < numDim; ++d) {
+      uint64_t size = parser.readValue<uint64_t>();
+      if (size == 0 || size > TensorData::MaxNumEl) THROW(Aborted, "invalid shape in gguf.");
+
+      numel *= size;
+      if (numel > TensorData::MaxNumEl) THROW(Aborted, "tensor too big.");
+      info.shape.push_back(static_cast<int64_t>(size));
+    }
+    std::reverse(info.shape.begin(), info.shape.end());
+
+    info.type = parser.readValue<uint32_t>();
+    info.offset = static_cast<int64_t>(parser.readValue<uint64_t>());
+    if (info.offset < 0) THROW(Aborted, "invalid offset in gguf.");
+    if ((info.type == kGGMLQ4_0 || info.type == kGGMLQ8_0) &&
+        info.shape.back() % GGMLBlockSize != 0) {
+      THROW(Aborted, lut::sprintf("invalid shape of quantized tensor %s.", name));
+    }
+
+    _tensors[name] = std::move(info);
+  }
+
+  int64_t fileSize = static_cast<int64_t>(_file->getData().size());
+  int64_t alignment = hasKey("general.alignment") ? getInt("general.alignment") : DefaultAlignment;
+  if (alignment <= 0) THROW(Aborted, "invalid alignment in gguf.");
+
+  // the alignment and offsets are from the file, compare them without overflow. A padding beyond
+  // the end of file leaves no room for the tensor data.
+  int64_t position = parser.getPosition();
+  int64_t padding = (alignment - position % alignment) % alignment;
+  _dataOffset = padding > fileSize - position ? fileSize : position + padding;
+
+  int64_t dataSize = fileSize - _dataOffset;
+  for (const auto &it : _tensors) {
+    const TensorInfo &info = it.second;
+    int64_t numel = 1;
+    for (int64_t size : info.shape) numel *= size;
+
+    int64_t size = getGGMLSize(info.type, numel);
+    if (info.offset > dataSize || (size > 0 && size > dataSize - info.offset)) {
+      THROW(Aborted, lut::sprintf("data of tensor %s out of range.", it.first));
+    }
+  }
+}
+
+std::vector<std::string> GGUFFile::getNames() const {
+  std::vector<std::string> names;
+  for (const auto &it : _tensors) {
+    names.push_back(it.first);
+  }
+
+  return names;
+}
+
+bool GGUFFile::contains(const std::string &name) const {
+  return _tensors.find(name) != _tensors.end();
+}
+
+Tensor GGUFFile::getTensor(const std::string &name, DType dtype) const {
+  auto it = _tensors.find(name);
+  if (it == _tensors.end()) THROW(Aborted, lut::sprintf("tensor \"%s\" not exist in gguf.", name));
+
+  const TensorInfo &info = it->second;
+  std::vector<Tensor::ShapeType> shapeData(info.shape.begin(), info.shape.end());
+  TensorShape shape(lut::makeConstSpan(shapeData));
+  int64_t numel = shape.getNumEl();
+
+  op::cpu::NoArenaScope noArenaScope;
+  const int8_t *data = _file->getData().data() + _dataOffset + info.offset;
+
+  std::shared_ptr<TensorData> tensorData;
+  if (info.type == kGGMLF32 || info.type == kGGMLF16) {
+    DType srcType = info.type == kGGMLF32 ? DType::kFloat : DType::kFloat16;
+    if (reinterpret_cast<uintptr_t>(data) % srcType.getTotalSize(1) == 0) {
+      // holds the mapping until the tensor data is destroyed.
+      std::shared_ptr<lut::MappedFile> file = _file;
+      tensorData = op::cpu::CpuTensorData::createFromPtr(
+          numel,
+          srcType,
+          reinterpret_cast<Byte *>(const_cast<int8_t *>(data)),
+          [file]() {});
+    } else {
+      // the offsets in a valid gguf file are aligned, copy the data for the others.
+      tensorData = op::cpu::CpuTensorData::create(numel, srcType);
+      memcpy(tensorData->getData<void>(), data, srcType.getTotalSize(numel));
+    }
+  } else if (info.type == kGGMLQ4_0) {
+    tensorData = op::cpu::CpuTensorData::create(numel, DType::kQInt4x32);
+    transcodeQ4_0(
+        reinterpret_cast<const BlockQ4_0 *>(data),
+        tensorData->getData<QInt4x32>(),
+        numel / GGMLBlockSize);
+  } else if (info.type == kGGMLQ8_0) {
+    tensorData = op::cpu::CpuTensorData::create(numel, DType::kFloat);
+    dequantQ8_0(
+        reinterpret_cast<const BlockQ8_0 *>(data),
+        tensorData->getData<float>(),
+        numel / GGMLBlockSize);
+  } else {
+    THROW(Aborted, lut::sprintf("unsupported tensor type %d of %s.", info.type, name));
+  }
+
+  Tensor tensor = Tensor::create(shape, tensorData);
+  if (dtype != DType::kUnknown) tensor = castTensor(tensor, dtype);
+
+  return tensor;
+}
+
+std::vector<Tensor> GGUFFile::getTensors(lut::Span<const std::string> names, DType dtype) const {
+  std::vector<Tensor> tensors(names.size());
+
+  // blocks of each tensor are already converted in parallel, load the tensors one by one.
+  for (int i = 0; i < static_cast<int>(names.size()); ++i) {
+    tensors[i] = getTensor(names[i], dtype);
+  }
+
+  return tensors;
+}
+
+std::vector<std::string> GGUFFile::getKeys() const {
+  std::vector<std::string> keys;
+  for (const auto &it : _metadata) {
+    keys.push_back(it.first);
+  }
+
+  return keys;
+}
+
+bool GGUFFile::hasKey(const std::string &key) const {
+  return _metadata.find(key) != _metadata.end();
+}
+
+const GGUFFile::Value &GGUFFile::getValue(const std::string &key, ValueKind kind, bool isArray)
+    const {
+  auto it = _metadata.find(key);
+  if (it == _metadata.end()) THROW(Aborted, lut::sprintf("key \"%s\" not exist in gguf.", key));
+
+  const Value &value = it->second;
+  bool kindMatched = value.kind == kind ||
+                     (kind == ValueKind::kFloat && value.kind == ValueKind::kInt);
+  if (!kindMatched || value.isArray != isArray) {
+    THROW(Aborted, lut::sprintf("unexpected type of key \"%s\" in gguf.", key));
+  }
+
+  return value;
+}
+
+std::string GGUFFile::getString(const std::string &key) const {
+  return getValue(key, ValueKind::kString, false).strings[0];
+}
+
+int64_t GGUFFile::getInt(const std::string &key) const {
+  return getValue(key, ValueKind::kInt, false).ints[0];
+}
+
+bool GGUFFile::getBool(const std::string &key) const {
+  return getValue(key, ValueKind::kBool, false).ints[0] != 0;
+}
+
+double GGUFFile::getFloat(const std::string &key) const {
+  const Value &value = getValue(key, ValueKind::kFloat, false);
+  return value.kind == ValueKind::kInt ? static_cast<double>(value.ints[0]) : value.floats[0];
+}
+
+std::vector<std::string> GGUFFile::getStringArray(const std::string &key) const {
+  return getValue(key, ValueKind::kString, true).strings;
+}
+
+std::vector<int64_t> GGUFFile::getIntArray(const std::string &key) const {
+  return getValue(key, ValueKind::kInt, true).ints;
+}
+
+std::vector<double> GGUFFile::getFloatArray(const std::string &key) const {
+  const Value &value = getValue(key, ValueKind::kFloat, true);
+  if (value.kind == ValueKind::kFloat) return value.floats;
+
+  return std::vector<double>(value.ints.begin(), value.ints.end());
+}
+
+}  // namespace lten
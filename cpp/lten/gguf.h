@@ -0,0 +1,126 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lten/dtype.h"
+#include "lten/tensor.h"
+#include "lutil/span.h"
+
+namespace lut {
+class MappedFile;
+}  // namespace lut
+
+namespace lten {
+
+/// @brief Reader of the GGUF model file, version 2 and 3. The spec is in
+/// https://github.com/ggml-org/ggml/blob/master/docs/gguf.md. The file is mapped into memory and
+/// the tensors are created when they are got.
+///
+///   std::shared_ptr<GGUFFile> gguf = GGUFFile::open("model.Q4_0.gguf");
+///   int64_t numLayers = gguf->getInt("llama.block_count");
+///   Tensor w = gguf->getTensor("blk.0.attn_q.weight");
+///
+/// The tensor types are mapped to lten as:
+///   F32, F16: DType::kFloat and DType::kFloat16, point to the mapped file without copying.
+///   Q4_0: DType::kQInt4x32. The blocks are transcoded on load without any loss, since both of
+///         them are 32 elements with a scale, Q4_0 just has a fixed zero point of 8.
+///   Q8_0: DType::kFloat, dequantized on load.
+/// The shape is in the order of lten, which is the reverse of the `ne` of ggml.
+class GGUFFile {
+ public:
+  /// @brief Open the GGUF file and parse its header. Throw AbortedError if failed.
+  /// @param filename the GGUF file.
+  static std::shared_ptr<GGUFFile> open(const std::string &filename);
+
+  /// @brief Get the names of all tensors in sorted order.
+  std::vector<std::string> getNames() const;
+
+  /// @brief Returns true if tensor `name` exists.
+  bool contains(const std::string &name) const;
+
+  /// @brief Get the tensor `name`. Its data is allocated outside the arena of current thread.
+  /// @param name name of the tensor.
+  /// @param dtype if not DType::kUnknown, the tensor is also converted to `dtype`.
+  /// @return the tensor.
+  Tensor getTensor(const std::string &name, DType dtype = DType::kUnknown) const;
+
+  /// @brief Get the tensors `names`. The blocks of quantized tensors are converted on the worker
+  /// threads.
+  /// @param names names of the tensors.
+  /// @param dtype the same as getTensor().
+  /// @return the tensors in the same order as `names`.
+  std::vector<Tensor> getTensors(
+      lut::Span<const std::string> names,
+      DType dtype = DType::kUnknown) const;
+
+  /// @brief Get the keys of all metadata in sorted order.
+  std::vector<std::string> getKeys() const;
+
+  /// @brief Returns true if metadata `key` exists.
+  bool hasKey(const std::string &key) const;
+
+  // get the metadata `key`. Throw AbortedError if it not exists or has a different type. Integers
+  // of any width are returned as int64_t, and could also be got by getFloat().
+  std::string getString(const std::string &key) const;
+  int64_t getInt(const std::string &key) const;
+  bool getBool(const std::string &key) const;
+  double getFloat(const std::string &key) const;
+  std::vector<std::string> getStringArray(const std::string &key) const;
+  std::vector<int64_t> getIntArray(const std::string &key) const;
+  std::vector<double> getFloatArray(const std::string &key) const;
+
+ private:
+  class Parser;
+
+  enum class ValueKind { kInt, kBool, kFloat, kString };
+
+  struct Value {
+    ValueKind kind;
+    bool isArray;
+    std::vector<int64_t> ints;
+    std::vector<double> floats;
+    std::vector<std::string> strings;
+  };
+
+  struct TensorInfo {
+    std::vector<int64_t> shape;
+    uint32_t type;
+    int64_t offset;
+  };
+
+  std::shared_ptr<lut::MappedFile> _file;
+  std::map<std::string, Value> _metadata;
+  std::map<std::string, TensorInfo> _tensors;
+  int64_t _dataOffset;
+
+  GGUFFile();
+
+  void parseHeader();
+  const Value &getValue(const std::string &key, ValueKind kind, bool isArray) const;
+};
+
+}  // namespace lten
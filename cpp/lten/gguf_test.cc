@@ -0,0 +1,300 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/gguf.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/functional.h"
+#include "lten/test_helper.h"
+#include "lutil/error.h"
+#include "lutil/half.h"
+#include "lutil/random.h"
+
+namespace lten {
+
+namespace {
+
+constexpr int Alignment = 32;
+
+// builder of the GGUF file in test.
+class GGUFBuilder {
+ public:
+  template<typename T>
+  void addValue(const std::string &key, uint32_t type, T value) {
+    appendString(&_metadata, key);
+    appendValue<uint32_t>(&_metadata, type);
+    appendValue<T>(&_metadata, value);
+    ++_numMetadata;
+  }
+
+  void addString(const std::string &key, const std::string &value) {
+    appendString(&_metadata, key);
+    appendValue<uint32_t>(&_metadata, 8);
+    appendString(&_metadata, value);
+    ++_numMetadata;
+  }
+
+  void addStringArray(const std::string &key, const std::vector<std::string> &values) {
+    appendString(&_metadata, key);
+    appendValue<uint32_t>(&_metadata, 9);
+    appendValue<uint32_t>(&_metadata, 8);
+    appendValue<uint64_t>(&_metadata, values.size());
+    for (const std::string &value : values) appendString(&_metadata, value);
+    ++_numMetadata;
+  }
+
+  template<typename T>
+  void addArray(const std::string &key, uint32_t type, const std::vector<T> &values) {
+    appendString(&_metadata, key);
+    appendValue<uint32_t>(&_metadata, 9);
+    appendValue<uint32_t>(&_metadata, type);
+    appendValue<uint64_t>(&_metadata, values.size());
+    for (T value : values) appendValue<T>(&_metadata, value);
+    ++_numMetadata;
+  }
+
+  // `ne` is the shape in the order of ggml.
+  void addTensor(
+      const std::string &name,
+      uint32_t type,
+      std::vector<uint64_t> ne,
+      const void *data,
+      int64_t size) {
+    appendString(&_tensorInfos, name);
+    appendValue<uint32_t>(&_tensorInfos, static_cast<uint32_t>(ne.size()));
+    for (uint64_t n : ne) appendValue<uint64_t>(&_tensorInfos, n);
+    appendValue<uint32_t>(&_tensorInfos, type);
+    appendValue<uint64_t>(&_tensorInfos, _data.size());
+    ++_numTensors;
+
+    _data.append(reinterpret_cast<const char *>(data), size);
+    _data.append((Alignment - _data.size() % Alignment) % Alignment, '\0');
+  }
+
+  void addPadding(int n) {
+    _data.append(n, '\0');
+  }
+
+  std::string build() const {
+    std::string file;
+    appendValue<uint32_t>(&file, 0x46554747);
+    appendValue<uint32_t>(&file, 3);
+    appendValue<uint64_t>(&file, _numTensors);
+    appendValue<uint64_t>(&file, _numMetadata);
+    file += _metadata;
+    file += _tensorInfos;
+    file.append((Alignment - file.size() % Alignment) % Alignment, '\0');
+    file += _data;
+
+    return file;
+  }
+
+ private:
+  std::string _metadata;
+  std::string _tensorInfos;
+  std::string _data;
+  int64_t _numMetadata = 0;
+  int64_t _numTensors = 0;
+
+  template<typename T>
+  static void append(std::string *buffer, T value) {
+    buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  static void appendString(std::string *buffer, const std::string &s) {
+    appendValue<uint64_t>(buffer, s.size());
+    *buffer += s;
+  }
+};
+
+}  // namespace
+
+CATCH_TEST_CASE("test GGUFFile", "[core][gguf]") {
+  lut::Random random(lut::Random::RandMax / 3);
+  constexpr int Rows = 4;
+  constexpr int Cols = 64;
+  constexpr int NumBlocks = Rows * Cols / 32;
+
+  Tensor f32 = F::rand({8, 64}, DType::kFloat, Device::getCpu(), &random);
+  Tensor f16 = F::cast(F::rand({64}, DType::kFloat, Device::getCpu(), &random), DType::kFloat16);
+
+  // Q4_0 blocks, and the float32 they represent.
+  std::vector<uint8_t> q4Data(NumBlocks * 18);
+  random.fillUInt8(lut::makeSpan(q4Data));
+  Tensor q4Ref = F::zeros({Rows, Cols}, DType::kFloat);
+  for (int i = 0; i < NumBlocks; ++i) {
+    uint16_t d = lut::cvtss_sh(0.01f + 0.1f * random.nextFloat());
+    memcpy(q4Data.data() + i * 18, &d, sizeof(d));
+
+    const uint8_t *qs = q4Data.data() + i * 18 + 2;
+    float *y = q4Ref.getData<float>() + i * 32;
+    for (int j = 0; j < 16; ++j) {
+      y[j] = ((qs[j] & 0xf) - 8) * lut::cvtsh_ss(d);
+      y[j + 16] = ((qs[j] >> 4) - 8) * lut::cvtsh_ss(d);
+    }
+  }
+
+  // Q8_0 blocks, and the float32 they represent.
+  std::vector<uint8_t> q8Data(NumBlocks * 34);
+  random.fillUInt8(lut::makeSpan(q8Data));
+  Tensor q8Ref = F::zeros({Rows, Cols}, DType::kFloat);
+  for (int i = 0; i < NumBlocks; ++i) {
+    uint16_t d = lut::cvtss_sh(0.001f + 0.01f * random.nextFloat());
+    memcpy(q8Data.data() + i * 34, &d, sizeof(d));
+
+    const int8_t *qs = reinterpret_cast<const int8_t *>(q8Data.data() + i * 34 + 2);
+    float *y = q8Ref.getData<float>() + i * 32;
+    for (int j = 0; j < 32; ++j) {
+      y[j] = qs[j] * lut::cvtsh_ss(d);
+    }
+  }
+
+  GGUFBuilder builder;
+  builder.addString("general.architecture", "llama");
+  builder.addValue<uint32_t>("general.alignment", 4, Alignment);
+  builder.addValue<uint32_t>("llama.block_count", 4, 2);
+  builder.addValue<float>("llama.rope.freq_base", 6, 10000.0f);
+  builder.addValue<uint8_t>("general.flag", 7, 1);
+  builder.addStringArray("tokenizer.ggml.tokens", {"a", "b", "c"});
+  builder.addArray<float>("tokenizer.ggml.scores", 6, {0.5f, 0.25f, 0.125f});
+  builder.addArray<int32_t>("tokenizer.ggml.empty", 5, {});
+  builder.addTensor("f32", 0, {64, 8}, f32.getData<float>(), 8 * 64 * 4);
+  builder.addTensor("f16", 1, {64}, f16.getData<Float16>(), 64 * 2);
+  builder.addTensor("q4", 2, {Cols, Rows}, q4Data.data(), q4Data.size());
+  builder.addTensor("q8", 8, {Cols, Rows}, q8Data.data(), q8Data.size());
+  builder.addTensor("q4_1", 3, {32}, q4Data.data(), 20);
+
+  // misaligned, it is copied.
+  builder.addPadding(2);
+  builder.addTensor("f32_misaligned", 0, {64}, f32.getData<float>(), 64 * 4);
+
+  std::string filename = getTestFilePath("test.gguf");
+  writeFile(filename, builder.build());
+
+  std::shared_ptr<GGUFFile> gguf = GGUFFile::open(filename);
+
+  // metadata
+  CATCH_REQUIRE(gguf->getString("general.architecture") == "llama");
+  CATCH_REQUIRE(gguf->getInt("llama.block_count") == 2);
+  CATCH_REQUIRE(gguf->getFloat("llama.block_count") == 2.0);
+  CATCH_REQUIRE(gguf->getFloat("llama.rope.freq_base") == 10000.0);
+  CATCH_REQUIRE(gguf->getBool("general.flag"));
+  CATCH_REQUIRE(
+      gguf->getStringArray("tokenizer.ggml.tokens") == std::vector<std::string>{"a", "b", "c"});
+  CATCH_REQUIRE(
+      gguf->getFloatArray("tokenizer.ggml.scores") == std::vector<double>{0.5, 0.25, 0.125});
+  CATCH_REQUIRE(gguf->getIntArray("tokenizer.ggml.empty").empty());
+  CATCH_REQUIRE(gguf->hasKey("general.alignment"));
+  CATCH_REQUIRE(!gguf->hasKey("general.name"));
+  CATCH_REQUIRE_THROWS_AS(gguf->getInt("general.architecture"), lut::AbortedError);
+  CATCH_REQUIRE_THROWS_AS(gguf->getString("general.name"), lut::AbortedError);
+  CATCH_REQUIRE_THROWS_AS(gguf->getIntArray("llama.block_count"), lut::AbortedError);
+
+  // tensors
+  std::vector<std::string> expectedNames = {"f16", "f32", "f32_misaligned", "q4", "q4_1", "q8"};
+  CATCH_REQUIRE(gguf->getNames() == expectedNames);
+
+  Tensor x = gguf->getTensor("f32");
+  CATCH_REQUIRE(x.getShape() == std::vector<Tensor::ShapeType>{8, 64});
+  CATCH_REQUIRE(x.getDataObject()->isExternal());
+  CATCH_REQUIRE(F::allClose(x, f32));
+
+  x = gguf->getTensor("f16");
+  CATCH_REQUIRE(x.getDType() == DType::kFloat16);
+  CATCH_REQUIRE(allCloseAsFloat(x, f16));
+
+  x = gguf->getTensor("f32_misaligned");
+  CATCH_REQUIRE(!x.getDataObject()->isExternal());
+  CATCH_REQUIRE(F::allClose(x, f32.subtensor(0)));
+
+  x = gguf->getTensor("q4");
+  CATCH_REQUIRE(x.getDType() == DType::kQInt4x32);
+  CATCH_REQUIRE(x.getShape() == std::vector<Tensor::ShapeType>{Rows, Cols});
+  CATCH_REQUIRE(F::allClose(F::cast(x, DType::kFloat), q4Ref));
+
+  // the transcoded weight works in matmul.
+  Tensor a = F::rand({3, Cols}, DType::kFloat, Device::getCpu(), &random);
+  Tensor xr = F::matmul(a, q4Ref.transpose(0, 1));
+  CATCH_REQUIRE(F::allClose(F::matmul(a, x.transpose(0, 1)), xr));
+
+  x = gguf->getTensor("q8");
+  CATCH_REQUIRE(x.getDType() == DType::kFloat);
+  CATCH_REQUIRE(F::allClose(x, q8Ref));
+
+  std::vector<std::string> names = {"q4", "f16"};
+  std::vector<Tensor> tensors = gguf->getTensors(names, DType::kFloat);
+  gguf = nullptr;
+  CATCH_REQUIRE(tensors[0].getDType() == DType::kFloat);
+  CATCH_REQUIRE(F::allClose(tensors[0], q4Ref));
+  CATCH_REQUIRE(F::allClose(tensors[1], F::cast(f16, DType::kFloat)));
+
+  gguf = GGUFFile::open(filename);
+  CATCH_REQUIRE_THROWS_AS(gguf->getTensor("q4_1"), lut::AbortedError);
+  CATCH_REQUIRE_THROWS_AS(gguf->getTensor("w"), lut::AbortedError);
+
+  gguf = nullptr;
+  remove(filename.c_str());
+}
+
+CATCH_TEST_CASE("test GGUFFile invalid file", "[core][gguf]") {
+  float data[64] = {0};
+  GGUFBuilder builder;
+  builder.addString("general.architecture", "llama");
+  builder.addTensor("w", 0, {64}, data, sizeof(data));
+  std::string file = builder.build();
+
+  std::string filename = getTestFilePath("test_invalid.gguf");
+
+  // truncated header and data.
+  writeFile(filename, file.substr(0, 40));
+  CATCH_REQUIRE_THROWS_AS(GGUFFile::open(filename), lut::AbortedError);
+  writeFile(filename, file.substr(0, file.size() - 4));
+  CATCH_REQUIRE_THROWS_AS(GGUFFile::open(filename), lut::AbortedError);
+
+  // bad magic number.
+  std::string badMagic = file;
+  badMagic[0] = 'X';
+  writeFile(filename, badMagic);
+  CATCH_REQUIRE_THROWS_AS(GGUFFile::open(filename), lut::AbortedError);
+
+  // offset of "w" overflows when added to the data offset and size.
+  std::string badOffset = file;
+  size_t pos = badOffset.find(std::string("\x01\0\0\0\0\0\0\0w", 9));
+  CATCH_REQUIRE(pos != std::string::npos);
+  int64_t offset = std::numeric_limits<int64_t>::max() - 16;
+  memcpy(&badOffset[pos + 9 + 4 + 8 + 4], &offset, sizeof(offset));
+  writeFile(filename, badOffset);
+  CATCH_REQUIRE_THROWS_AS(GGUFFile::open(filename), lut::AbortedError);
+
+  // alignment beyond the end of file.
+  builder.addValue<uint32_t>("general.alignment", 4, 0x40000000);
+  writeFile(filename, builder.build());
+  CATCH_REQUIRE_THROWS_AS(GGUFFile::open(filename), lut::AbortedError);
+
+  remove(filename.c_str());
+}
+
+}  // namespace lten
@@ -0,0 +1,746 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/kv_cache.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "lten/cpu/arena.h"
+#include "lten/cpu/numa.h"
+#include "lten/cpu/paged_attention.h"
+#include "lten/functional.h"
+#include "lutil/error.h"
+#include "lutil/log.h"
+#include "lutil/strings.h"
+
+namespace lten {
+
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325;
+constexpr uint64_t kFnvPrime = 0x100000001b3;
+
+uint64_t fnv1a(uint64_t hash, const void *data, int64_t size) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+  for (int64_t i = 0; i < size; ++i) {
+    hash ^= p[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+// hash of the prefix ending at a block, chained from the hash of the previous block.
+uint64_t hashBlock(uint64_t prevHash, lut::Span<const LongType> tokens) {
+  uint64_t hash = fnv1a(kFnvOffsetBasis, &prevHash, sizeof(prevHash));
+  return fnv1a(hash, tokens.data(), tokens.size() * sizeof(LongType));
+}
+
+// copy the whole tensor of a block. On CPU F::copy does not support all the storage types.
+void copyBlockTensor(const Tensor &src, Tensor &dest) {
+  if (src.getDevice().getType() == Device::kCpu) {
+    memcpy(dest.getData<void>(), src.getData<void>(), src.getDType().getTotalSize(src.getNumEl()));
+  } else {
+    F::copy(src, dest);
+  }
+}
+
+// write `src` into the block tensor `dest`. Quantize it if `dest` has a different dtype.
+void writeBlock(Tensor src, Tensor dest, Tensor destScale) {
+  if (src.getDType() == dest.getDType()) {
+    F::copy(src, dest);
+    return;
+  }
+
+  // quantize on append.
+  if (dest.getDevice().getType() == Device::kCpu) {
+    if (src.getDType() != DType::kFloat) src = F::cast(src, DType::kFloat);
+    if (dest.getDType() == DType::kFloat) {
+      F::copy(src, dest);
+      return;
+    }
+
+    src = F::contiguous(src);
+    op::cpu::quantizeKV(src, dest, destScale);
+  } else {
+    F::copy(F::cast(src, dest.getDType()), dest);
+  }
+}
+
+// write the keys and values of tokens [begin, begin + k.shape[0]) of a layer into the blocks. The
+// tokens of logical block b are stored in blocks[b % blocks.size()].
+void writeBlocks(
+    lut::Span<const KVBlockPool::BlockPtr> blocks,
+    int blockSize,
+    int layer,
+    int begin,
+    Tensor k,
+    Tensor v) {
+  int end = begin + k.getShape(0);
+  int srcBegin = 0;
+  while (begin < end) {
+    int blockIdx = (begin / blockSize) % static_cast<int>(blocks.size());
+    int blockBegin = begin % blockSize;
+    int n = std::min(end - begin, blockSize - blockBegin);
+
+    const KVBlockPool::BlockPtr &block = blocks[blockIdx];
+    Tensor kScale, vScale;
+    if (!block->kScale.empty()) {
+      kScale = block->kScale.subtensor(layer).slice({blockBegin, blockBegin + n});
+      vScale = block->vScale.subtensor(layer).slice({blockBegin, blockBegin + n});
+    }
+    writeBlock(
+        k.slice({srcBegin, srcBegin + n}),
+        block->k.subtensor(layer).slice({blockBegin, blockBegin + n}),
+        kScale);
+    writeBlock(
+        v.slice({srcBegin, srcBegin + n}),
+        block->v.subtensor(layer).slice({blockBegin, blockBegin + n}),
+        vScale);
+
+    begin += n;
+    srcBegin += n;
+  }
+}
+
+// get the view of a layer in the blocks for op::cpu::pagedAttention.
+op::cpu::PagedKV getPagedKV(
+    lut::Span<const KVBlockPool::BlockPtr> blocks,
+    int blockSize,
+    int layer,
+    int length,
+    const AttentionWindow &window,
+    const AttentionBias &bias) {
+  op::cpu::PagedKV kv;
+  for (const KVBlockPool::BlockPtr &block : blocks) {
+    kv.k.push_back(block->k.subtensor(layer));
+    kv.v.push_back(block->v.subtensor(layer));
+    if (!block->kScale.empty()) {
+      kv.kScale.push_back(block->kScale.subtensor(layer));
+      kv.vScale.push_back(block->vScale.subtensor(layer));
+    }
+  }
+  kv.blockSize = blockSize;
+  kv.length = length;
+  kv.window = window.window;
+  kv.chunkSize = window.chunkSize;
+  kv.numGlobalTokens = window.numGlobalTokens;
+  kv.alibiSlopes = bias.alibiSlopes;
+  kv.relativeBias = bias.relativeBias;
+  kv.relativeMaxDistance = bias.relativeMaxDistance;
+
+  return kv;
+}
+
+// attention on CPU. Queries in other types are computed in float.
+Tensor pagedAttentionCpu(Tensor q, const op::cpu::PagedKV &kv) {
+  DType dtype = q.getDType();
+  if (dtype != DType::kFloat) q = F::cast(q, DType::kFloat);
+  Tensor x = op::cpu::pagedAttention(q, kv);
+  return dtype == DType::kFloat ? x : F::cast(x, dtype);
+}
+
+}  // namespace
+
+KVCacheConfig::KVCacheConfig()
+    : numLayers(0),
+      numHeads(0),
+      headDim(0),
+      blockSize(16),
+      maxBytes(std::numeric_limits<int64_t>::max()),
+      dtype(DType::kFloat),
+      device(Device::getCpu()) {
+}
+
+AttentionWindow::AttentionWindow()
+    : window(0),
+      chunkSize(0),
+      numGlobalTokens(0) {
+}
+
+AttentionBias::AttentionBias()
+    : relativeMaxDistance(0) {
+}
+
+AttentionBias AttentionBias::alibi(int numHeads) {
+  CHECK(numHeads > 0);
+
+  // slopes for the closest power of 2 heads, then interpolate for the remaining heads.
+  int n = 1;
+  while (n * 2 <= numHeads) n *= 2;
+
+  AttentionBias bias;
+  float base = powf(2.0f, -8.0f / n);
+  for (int i = 0; i < n; ++i) {
+    bias.alibiSlopes.push_back(powf(base, static_cast<float>(i + 1)));
+  }
+
+  float extraBase = powf(2.0f, -4.0f / n);
+  for (int i = 0; i < numHeads - n; ++i) {
+    bias.alibiSlopes.push_back(powf(extraBase, static_cast<float>(2 * i + 1)));
+  }
+
+  return bias;
+}
+
+AttentionBias AttentionBias::relativePosition(Tensor table, int maxDistance) {
+  CHECK(table.getDim() == 2);
+  if (table.getDType() != DType::kFloat) table = F::cast(table, DType::kFloat);
+
+  AttentionBias bias;
+  bias.relativeBias = F::contiguous(table);
+  bias.relativeMaxDistance = maxDistance;
+  return bias;
+}
+
+KVCacheStats::KVCacheStats()
+    : numHits(0),
+      numMisses(0),
+      numEvictions(0),
+      numCopyOnWrites(0),
+      numBlocks(0),
+      numBytes(0),
+      numCachedBlocks(0) {
+}
+
+// -----------------------------------------------------------------------------------------------+
+// class KVBlockPool                                                                              |
+// -----------------------------------------------------------------------------------------------+
+
+KVBlockPool::Block::Block()
+    : refCount(0),
+      hashed(false),
+      hash(0),
+      id(0),
+      prevId(0),
+      inLru(false) {
+}
+
+KVBlockPool::KVBlockPool()
+    : _blockBytes(0),
+      _nextBlockId(1) {
+}
+
+std::shared_ptr<KVBlockPool> KVBlockPool::create(const KVCacheConfig &config) {
+  if (config.numLayers <= 0 || config.numHeads <= 0 || config.headDim <= 0) {
+    throw lut::InvalidArgError("KVCacheConfig: invalid shape");
+  }
+  if (config.blockSize <= 0) throw lut::InvalidArgError("KVCacheConfig: invalid blockSize");
+  if (config.dtype != DType::kFloat && config.dtype != DType::kFloat16 &&
+      config.dtype != DType::kInt8) {
+    throw lut::InvalidArgError("KVCacheConfig: unsupported dtype " + config.dtype.toString());
+  }
+  if (config.dtype == DType::kInt8 && config.device.getType() != Device::kCpu) {
+    throw lut::NotImplementedError("KVCacheConfig: int8 storage is only supported on CPU");
+  }
+
+  std::shared_ptr<KVBlockPool> pool{new KVBlockPool()};
+  pool->_config = config;
+
+  pool->_blockBytes = pool->getBytesPerToken() * config.blockSize;
+
+  return pool;
+}
+
+int64_t KVBlockPool::getBytesPerToken() const {
+  int64_t numel = static_cast<int64_t>(_config.numHeads) * _config.headDim;
+  int64_t bytes = _config.dtype.getTotalSize(numel);
+  if (_config.dtype == DType::kInt8) {
+    bytes += DType(DType::kFloat).getTotalSize(_config.numHeads);
+  }
+
+  return 2 * _config.numLayers * bytes;
+}
+
+KVCacheStats KVBlockPool::getStats() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+int64_t KVBlockPool::getBlockBytes() const {
+  return _blockBytes;
+}
+
+void KVBlockPool::clearCache() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  while (evictOneLocked()) {
+  }
+}
+
+bool KVBlockPool::evictOneLocked() {
+  if (_lru.empty()) return false;
+
+  BlockPtr block = _lru.front();
+  _lru.pop_front();
+  CHECK(block->refCount == 0 && block->hashed);
+
+  block->inLru = false;
+  _hashTable.erase(block->hash);
+  block->hashed = false;
+
+  --_stats.numCachedBlocks;
+  --_stats.numBlocks;
+  _stats.numBytes -= _blockBytes;
+  ++_stats.numEvictions;
+
+  return true;
+}
+
+KVBlockPool::BlockPtr KVBlockPool::allocBlockLocked() {
+  while (_stats.numBytes + _blockBytes > _config.maxBytes) {
+    if (!evictOneLocked()) {
+      throw lut::AbortedError(
+          lut::sprintf(
+              "KV cache out of memory: %d bytes in use, budget is %d bytes.",
+              _stats.numBytes,
+              _config.maxBytes));
+    }
+  }
+
+  // blocks outlive the arena scope of the caller and are shared with other sequences, they should
+  // never be promoted.
+  op::cpu::NoArenaScope noArenaScope;
+
+  std::vector<Tensor::ShapeType> shape{
+      _config.numLayers,
+      _config.blockSize,
+      _config.numHeads,
+      _config.headDim};
+  BlockPtr block = std::make_shared<Block>();
+  block->k = F::tensor(shape, _config.dtype, _config.device);
+  block->v = F::tensor(shape, _config.dtype, _config.device);
+  if (_config.dtype == DType::kInt8) {
+    std::vector<Tensor::ShapeType> scaleShape{
+        _config.numLayers,
+        _config.blockSize,
+        _config.numHeads};
+    block->kScale = F::tensor(scaleShape, DType::kFloat, _config.device);
+    block->vScale = F::tensor(scaleShape, DType::kFloat, _config.device);
+  }
+  if (_config.device.getType() == Device::kCpu) {
+    // blocks are read by the threads of all NUMA nodes in attention.
+    op::cpu::interleaveOnNumaNodes(block->k);
+    op::cpu::interleaveOnNumaNodes(block->v);
+  }
+  block->refCount = 1;
+  block->id = _nextBlockId++;
+
+  ++_stats.numBlocks;
+  _stats.numBytes += _blockBytes;
+
+  return block;
+}
+
+KVBlockPool::BlockPtr KVBlockPool::allocBlock() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return allocBlockLocked();
+}
+
+KVBlockPool::BlockPtr KVBlockPool::makeWritable(const BlockPtr &block) {
+  BlockPtr newBlock;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    CHECK(block->refCount > 0);
+    if (block->refCount == 1) {
+      if (block->hashed) {
+        auto it = _hashTable.find(block->hash);
+        if (it != _hashTable.end() && it->second == block) _hashTable.erase(it);
+        block->hashed = false;
+        block->tokens.clear();
+      }
+
+      // the blocks registered after this one must not match it any more.
+      block->id = _nextBlockId++;
+      return block;
+    }
+
+    newBlock = allocBlockLocked();
+    ++_stats.numCopyOnWrites;
+  }
+
+  // `block` is still referenced by the caller, it is safe to copy it without the lock.
+  copyBlockTensor(block->k, newBlock->k);
+  copyBlockTensor(block->v, newBlock->v);
+  if (!block->kScale.empty()) {
+    copyBlockTensor(block->kScale, newBlock->kScale);
+    copyBlockTensor(block->vScale, newBlock->vScale);
+  }
+  unref(block);
+
+  return newBlock;
+}
+
+KVBlockPool::BlockPtr KVBlockPool::lookup(
+    uint64_t hash,
+    const BlockPtr &prev,
+    lut::Span<const LongType> tokens) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto it = _hashTable.find(hash);
+  BlockPtr block = it == _hashTable.end() ? nullptr : it->second;
+  uint64_t prevId = prev ? prev->id : 0;
+  if (!block || block->prevId != prevId ||
+      !std::equal(tokens.begin(), tokens.end(), block->tokens.begin(), block->tokens.end())) {
+    ++_stats.numMisses;
+    return nullptr;
+  }
+
+  if (block->inLru) {
+    CHECK(block->refCount == 0);
+    _lru.erase(block->lruIt);
+    block->inLru = false;
+    --_stats.numCachedBlocks;
+  }
+
+  ++block->refCount;
+  ++_stats.numHits;
+  return block;
+}
+
+void KVBlockPool::registerBlock(
+    const BlockPtr &block,
+    uint64_t hash,
+    const BlockPtr &prev,
+    lut::Span<const LongType> tokens) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  CHECK(block->refCount > 0);
+
+  // the same prefix may be computed by more than one sequence, keep the first one.
+  if (block->hashed || _hashTable.find(hash) != _hashTable.end()) return;
+
+  block->hashed = true;
+  block->hash = hash;
+  block->prevId = prev ? prev->id : 0;
+  block->tokens.assign(tokens.begin(), tokens.end());
+  _hashTable[hash] = block;
+}
+
+void KVBlockPool::ref(const BlockPtr &block) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  CHECK(block->refCount > 0);
+  ++block->refCount;
+}
+
+void KVBlockPool::unref(const BlockPtr &block) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  unrefLocked(block);
+}
+
+void KVBlockPool::unrefLocked(const BlockPtr &block) {
+  CHECK(block->refCount > 0);
+  --block->refCount;
+  if (block->refCount > 0) return;
+
+  if (block->hashed) {
+    // keep it for prefix reuse.
+    block->lruIt = _lru.insert(_lru.end(), block);
+    block->inLru = true;
+    ++_stats.numCachedBlocks;
+  } else {
+    --_stats.numBlocks;
+    _stats.numBytes -= _blockBytes;
+  }
+}
+
+int KVBlockPool::getRefCount(const BlockPtr &block) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return block->refCount;
+}
+
+// -----------------------------------------------------------------------------------------------+
+// class KVSequence                                                                               |
+// -----------------------------------------------------------------------------------------------+
+
+KVSequence::KVSequence(std::shared_ptr<KVBlockPool> pool)
+    : _pool(pool),
+      _length(0),
+      _numReserved(0) {
+  CHECK(_pool);
+}
+
+KVSequence::~KVSequence() {
+  for (const KVBlockPool::BlockPtr &block : _blocks) {
+    _pool->unref(block);
+  }
+  _blocks.clear();
+}
+
+std::unique_ptr<KVSequence> KVSequence::fork() const {
+  CHECK(_numReserved == 0) << "unable to fork a sequence with reserved tokens.";
+
+  std::unique_ptr<KVSequence> seq = std::make_unique<KVSequence>(_pool);
+  for (const KVBlockPool::BlockPtr &block : _blocks) {
+    _pool->ref(block);
+  }
+  seq->_blocks = _blocks;
+  seq->_hashes = _hashes;
+  seq->_tokens = _tokens;
+  seq->_length = _length;
+
+  return seq;
+}
+
+int KVSequence::matchPrefix(lut::Span<const LongType> tokens) {
+  CHECK(_length == 0 && _blocks.empty() && _numReserved == 0);
+  int blockSize = _pool->getConfig().blockSize;
+
+  // leave at least one token for the prefill, since we need the logits of the last token.
+  int numBlocks = (static_cast<int>(tokens.size()) - 1) / blockSize;
+  uint64_t hash = 0;
+  for (int i = 0; i < numBlocks; ++i) {
+    lut::Span<const LongType> blockTokens = tokens.subspan(i * blockSize, blockSize);
+    hash = hashBlock(hash, blockTokens);
+    KVBlockPool::BlockPtr block = _pool->lookup(
+        hash,
+        i == 0 ? nullptr : _blocks[i - 1],
+        blockTokens);
+    if (!block) break;
+
+    _blocks.push_back(block);
+    _hashes.push_back(hash);
+  }
+
+  _length = static_cast<int>(_blocks.size()) * blockSize;
+  _tokens.assign(tokens.begin(), tokens.begin() + _length);
+
+  return _length;
+}
+
+void KVSequence::reserve(int numTokens) {
+  CHECK(_numReserved == 0) << "reserve() called twice without commit().";
+  CHECK(numTokens > 0);
+  int blockSize = _pool->getConfig().blockSize;
+
+  // the partial last block will be written.
+  if (_length % blockSize != 0) {
+    int blockIdx = _length / blockSize;
+    _blocks[blockIdx] = _pool->makeWritable(_blocks[blockIdx]);
+  }
+
+  int numBlocks = (_length + numTokens + blockSize - 1) / blockSize;
+  while (static_cast<int>(_blocks.size()) < numBlocks) {
+    _blocks.push_back(_pool->allocBlock());
+  }
+
+  _numReserved = numTokens;
+}
+
+void KVSequence::write(int layer, Tensor k, Tensor v) {
+  const KVCacheConfig &config = _pool->getConfig();
+  CHECK(layer >= 0 && layer < config.numLayers);
+  k.throwIfInvalidShape({_numReserved, config.numHeads, config.headDim}, "KVSequence::write");
+  v.throwIfInvalidShape({_numReserved, config.numHeads, config.headDim}, "KVSequence::write");
+
+  writeBlocks(_blocks, config.blockSize, layer, _length, k, v);
+}
+
+void KVSequence::commit(lut::Span<const LongType> tokens) {
+  CHECK(static_cast<int>(tokens.size()) == _numReserved);
+  int blockSize = _pool->getConfig().blockSize;
+
+  _tokens.insert(_tokens.end(), tokens.begin(), tokens.end());
+  _length += _numReserved;
+  _numReserved = 0;
+
+  int numFullBlocks = _length / blockSize;
+  for (int i = static_cast<int>(_hashes.size()); i < numFullBlocks; ++i) {
+    uint64_t prevHash = i == 0 ? 0 : _hashes[i - 1];
+    lut::Span<const LongType> blockTokens = lut::makeConstSpan(_tokens).subspan(
+        i * blockSize,
+        blockSize);
+    uint64_t hash = hashBlock(prevHash, blockTokens);
+
+    _pool->registerBlock(_blocks[i], hash, i == 0 ? nullptr : _blocks[i - 1], blockTokens);
+    _hashes.push_back(hash);
+  }
+}
+
+void KVSequence::truncate(int length) {
+  CHECK(_numReserved == 0);
+  CHECK(length >= 0 && length <= _length);
+  int blockSize = _pool->getConfig().blockSize;
+
+  int numBlocks = (length + blockSize - 1) / blockSize;
+  while (static_cast<int>(_blocks.size()) > numBlocks) {
+    _pool->unref(_blocks.back());
+    _blocks.pop_back();
+  }
+
+  _hashes.resize(length / blockSize);
+  _tokens.resize(length);
+  _length = length;
+}
+
+Tensor KVSequence::gather(int layer, bool isKey) const {
+  const KVCacheConfig &config = _pool->getConfig();
+  CHECK(layer >= 0 && layer < config.numLayers);
+  CHECK(_length > 0);
+
+  // quantized storage on CPU is dequantized to float.
+  bool dequant = config.device.getType() == Device::kCpu && config.dtype != DType::kFloat;
+  DType dtype = dequant ? DType(DType::kFloat) : config.dtype;
+
+  Tensor x = F::tensor({_length, config.numHeads, config.headDim}, dtype, config.device);
+  int blockSize = config.blockSize;
+  for (int begin = 0; begin < _length; begin += blockSize) {
+    int n = std::min(_length - begin, blockSize);
+    const KVBlockPool::BlockPtr &block = _blocks[begin / blockSize];
+    Tensor src = isKey ? block->k : block->v;
+    Tensor srcScale = isKey ? block->kScale : block->vScale;
+    if (dequant) {
+      if (!srcScale.empty()) srcScale = srcScale.subtensor(layer).slice({0, n});
+      Tensor dest = x.slice({begin, begin + n});
+      op::cpu::dequantizeKV(src.subtensor(layer).slice({0, n}), srcScale, dest);
+    } else {
+      F::copy(src.subtensor(layer).slice({0, n}), x.slice({begin, begin + n}));
+    }
+  }
+
+  return x;
+}
+
+Tensor KVSequence::getKey(int layer) const {
+  return gather(layer, true);
+}
+
+Tensor KVSequence::getValue(int layer) const {
+  return gather(layer, false);
+}
+
+Tensor KVSequence::attention(
+    int layer,
+    Tensor q,
+    const AttentionWindow &window,
+    const AttentionBias &bias) const {
+  const KVCacheConfig &config = _pool->getConfig();
+  CHECK(layer >= 0 && layer < config.numLayers);
+  CHECK(_numReserved == 0 && _length > 0);
+  CHECK(q.getDim() == 3 && q.getShape(2) == config.headDim);
+
+  if (config.device.getType() == Device::kCpu) {
+    return pagedAttentionCpu(
+        q,
+        getPagedKV(_blocks, config.blockSize, layer, _length, window, bias));
+  }
+
+  // other devices: gather the KV and apply the causal mask for the last L rows.
+  if (q.getShape(1) != config.numHeads) {
+    throw lut::NotImplementedError("KVSequence::attention: grouped query attention on device");
+  }
+  if (window.window > 0 || window.chunkSize > 0) {
+    throw lut::NotImplementedError("KVSequence::attention: local attention on device");
+  }
+  if (!bias.alibiSlopes.empty() || !bias.relativeBias.empty()) {
+    throw lut::NotImplementedError("KVSequence::attention: position bias on device");
+  }
+  int numQueries = q.getShape(0);
+  Tensor mask = F::causalMask(_length, config.device).slice({_length - numQueries, _length});
+  Tensor x = F::attention(
+      q.transpose(0, 1).unsqueeze(0),
+      getKey(layer).transpose(0, 1).unsqueeze(0),
+      getValue(layer).transpose(0, 1).unsqueeze(0),
+      mask);
+
+  return F::contiguous(x.squeeze(0).transpose(0, 1));
+}
+
+// -----------------------------------------------------------------------------------------------+
+// class KVRingBuffer                                                                             |
+// -----------------------------------------------------------------------------------------------+
+
+KVRingBuffer::KVRingBuffer(
+    std::shared_ptr<KVBlockPool> pool,
+    AttentionWindow window,
+    int maxTokensPerStep)
+    : _pool(pool),
+      _window(window),
+      _maxTokensPerStep(maxTokensPerStep),
+      _length(0),
+      _numReserved(0) {
+  CHECK(_pool);
+  if (window.window <= 0 && window.chunkSize <= 0) {
+    throw lut::InvalidArgError("KVRingBuffer: window or chunkSize is required");
+  }
+  if (window.numGlobalTokens != 0) {
+    throw lut::InvalidArgError("KVRingBuffer: global tokens are not supported");
+  }
+  if (maxTokensPerStep <= 0) throw lut::InvalidArgError("KVRingBuffer: invalid maxTokensPerStep");
+
+  // a query attends to at most `span` tokens ending at itself. Besides the tokens of the current
+  // step, the ring keeps span - 1 previous tokens.
+  int span = std::numeric_limits<int>::max();
+  if (window.window > 0) span = std::min(span, window.window);
+  if (window.chunkSize > 0) span = std::min(span, window.chunkSize);
+
+  int blockSize = _pool->getConfig().blockSize;
+  int numBlocks = (span - 1 + maxTokensPerStep + blockSize - 1) / blockSize;
+  for (int i = 0; i < numBlocks; ++i) {
+    _blocks.push_back(_pool->allocBlock());
+  }
+}
+
+KVRingBuffer::~KVRingBuffer() {
+  for (const KVBlockPool::BlockPtr &block : _blocks) {
+    _pool->unref(block);
+  }
+  _blocks.clear();
+}
+
+int KVRingBuffer::getCapacity() const {
+  return static_cast<int>(_blocks.size()) * _pool->getConfig().blockSize;
+}
+
+void KVRingBuffer::reserve(int numTokens) {
+  CHECK(_numReserved == 0) << "reserve() called twice without commit().";
+  CHECK(numTokens > 0 && numTokens <= _maxTokensPerStep);
+  _numReserved = numTokens;
+}
+
+void KVRingBuffer::write(int layer, Tensor k, Tensor v) {
+  const KVCacheConfig &config = _pool->getConfig();
+  CHECK(layer >= 0 && layer < config.numLayers);
+  k.throwIfInvalidShape({_numReserved, config.numHeads, config.headDim}, "KVRingBuffer::write");
+  v.throwIfInvalidShape({_numReserved, config.numHeads, config.headDim}, "KVRingBuffer::write");
+
+  writeBlocks(_blocks, config.blockSize, layer, _length, k, v);
+}
+
+void KVRingBuffer::commit() {
+  _length += _numReserved;
+  _numReserved = 0;
+}
+
+Tensor KVRingBuffer::attention(int layer, Tensor q, const AttentionBias &bias) const {
+  const KVCacheConfig &config = _pool->getConfig();
+  CHECK(layer >= 0 && layer < config.numLayers);
+  CHECK(q.getDim() == 3 && q.getShape(0) == _numReserved && q.getShape(2) == config.headDim);
+  if (config.device.getType() != Device::kCpu) {
+    throw lut::NotImplementedError("KVRingBuffer::attention: only CPU is supported");
+  }
+
+  int length = _length + _numReserved;
+  return pagedAttentionCpu(
+      q,
+      getPagedKV(_blocks, config.blockSize, layer, length, _window, bias));
+}
+
+}  // namespace lten
@@ -0,0 +1,394 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "lten/device.h"
+#include "lten/dtype.h"
+#include "lten/tensor.h"
+#include "lutil/noncopyable.h"
+#include "lutil/span.h"
+
+namespace lten {
+
+/// @brief Options of the KV cache block pool.
+struct KVCacheConfig {
+  int numLayers;
+  int numHeads;
+  int headDim;
+
+  /// @brief number of tokens in each block.
+  int blockSize;
+
+  /// @brief upper bound of the bytes held by the pool, including the blocks that are not
+  /// referenced by any sequence but kept for prefix reuse.
+  int64_t maxBytes;
+
+  /// @brief storage type of K and V. kFloat, kFloat16 or kInt8 (CPU only). In kInt8, each
+  /// (token, head) row is quantized symmetrically with its own float scale when written. The
+  /// keys and values written into the cache are always in float (or the default float type of
+  /// the device) regardless of the storage type.
+  DType dtype;
+  Device device;
+
+  KVCacheConfig();
+};
+
+/// @brief Range of keys attended by each query, in addition to the causal mask. By default (all
+/// zero) each query attends to all the previous tokens.
+struct AttentionWindow {
+  /// @brief sliding window size. The query at position p attends to keys in (p - window, p].
+  int window;
+
+  /// @brief chunk size of the chunked local attention. The query at position p attends to keys
+  /// in [p / chunkSize * chunkSize, p].
+  int chunkSize;
+
+  /// @brief number of tokens from the beginning of the sequence attended by every query.
+  int numGlobalTokens;
+
+  AttentionWindow();
+};
+
+/// @brief Position bias added to the attention scores. It is computed inside the attention kernel
+/// for each visited score, so no (numHeads, L, S) bias tensor is created.
+struct AttentionBias {
+  /// @brief ALiBi slope of each query head. The bias of the key at position j for the query at
+  /// position p is -slope * (p - j). Empty for no ALiBi bias.
+  std::vector<float> alibiSlopes;
+
+  /// @brief <float>(numBuckets, numQHeads): learned bias of each relative position bucket (T5
+  /// style, unidirectional). Empty for no relative position bias.
+  Tensor relativeBias;
+
+  /// @brief distance mapped to the last bucket of relativeBias.
+  int relativeMaxDistance;
+
+  AttentionBias();
+
+  /// @brief Get the ALiBi bias with the slopes from the ALiBi paper for `numHeads` heads.
+  static AttentionBias alibi(int numHeads);
+
+  /// @brief Get the relative position bias with given bucket table.
+  /// @param table <float>(numBuckets, numQHeads): the bias of each bucket.
+  /// @param maxDistance the distance mapped to the last bucket.
+  static AttentionBias relativePosition(Tensor table, int maxDistance);
+};
+
+/// @brief Counters of the KV cache block pool.
+struct KVCacheStats {
+  /// @brief number of full blocks found by the prefix lookup.
+  int64_t numHits;
+
+  /// @brief number of full blocks not found by the prefix lookup.
+  int64_t numMisses;
+
+  /// @brief number of cached blocks dropped by the LRU policy.
+  int64_t numEvictions;
+
+  /// @brief number of blocks copied because of writing into a shared block.
+  int64_t numCopyOnWrites;
+
+  /// @brief number of blocks alive (referenced or cached) and their total size.
+  int64_t numBlocks;
+  int64_t numBytes;
+
+  /// @brief number of blocks with zero reference kept for prefix reuse.
+  int64_t numCachedBlocks;
+
+  KVCacheStats();
+};
+
+/// @brief A pool of fixed-size, reference counted KV cache blocks. Each block stores the keys and
+/// values of `blockSize` tokens for all layers:
+///     K, V: <dtype>(numLayers, blockSize, numHeads, headDim)
+///     KScale, VScale: <float>(numLayers, blockSize, numHeads)  // only in int8 storage.
+/// A full block is identified by the hash of all tokens from the beginning of the sequence to the
+/// end of that block. Since the hash may collide, the block also keeps its own tokens and its
+/// previous block, and both of them are compared in lookup(). Once released by all the sequences,
+/// a full block is kept in the pool as a cached block (in LRU order) so that a new sequence with
+/// the same prefix could reuse it without computing its prefill again. Cached blocks are evicted
+/// once the pool exceeds `maxBytes`.
+///
+/// The pool is thread-safe. It is shared by the KVSequence objects.
+class KVBlockPool : private lut::NonCopyable {
+ public:
+  struct Block;
+  typedef std::shared_ptr<Block> BlockPtr;
+
+  static std::shared_ptr<KVBlockPool> create(const KVCacheConfig &config);
+
+  /// @brief Get the statistics of the pool.
+  KVCacheStats getStats() const;
+
+  /// @brief Get size in bytes of one block.
+  int64_t getBlockBytes() const;
+
+  /// @brief Get size in bytes of the keys and values (including scales) of one token in all
+  /// layers.
+  int64_t getBytesPerToken() const;
+
+  const KVCacheConfig &getConfig() const {
+    return _config;
+  }
+
+  /// @brief Drop all the cached blocks (blocks not referenced by any sequence).
+  void clearCache();
+
+  /// @brief Allocate a new empty block with reference count 1. Evict the cached blocks in LRU
+  /// order if the budget is exceeded. Throw AbortedError if the budget is still not enough.
+  BlockPtr allocBlock();
+
+  /// @brief Get a block that could be written by the caller in place of `block`. If the caller is
+  /// the only owner, the block itself is returned and removed from the prefix table since its
+  /// content will change. Otherwise a copy of the block is returned and the reference to the
+  /// original block is released (copy-on-write).
+  BlockPtr makeWritable(const BlockPtr &block);
+
+  /// @brief Find the full block with given prefix hash, which follows `prev` (nullptr for the
+  /// first block) and stores `tokens`. On hit, the reference count of the block is increased and
+  /// the block is returned. Returns nullptr on miss, including a hash collision.
+  BlockPtr lookup(uint64_t hash, const BlockPtr &prev, lut::Span<const LongType> tokens);
+
+  /// @brief Register a full block with its prefix hash, its previous block (nullptr for the first
+  /// block) and its tokens so that it could be found by lookup().
+  void registerBlock(
+      const BlockPtr &block,
+      uint64_t hash,
+      const BlockPtr &prev,
+      lut::Span<const LongType> tokens);
+
+  /// @brief Increase or decrease the reference count of a block.
+  void ref(const BlockPtr &block);
+  void unref(const BlockPtr &block);
+
+  /// @brief Get reference count of a block.
+  int getRefCount(const BlockPtr &block) const;
+
+ private:
+  typedef std::list<BlockPtr>::iterator LruIterator;
+
+  KVCacheConfig _config;
+  int64_t _blockBytes;
+
+  mutable std::mutex _mutex;
+  uint64_t _nextBlockId;
+  std::unordered_map<uint64_t, BlockPtr> _hashTable;
+  std::list<BlockPtr> _lru;
+  KVCacheStats _stats;
+
+  KVBlockPool();
+
+  // evict the least recently used cached block. Returns false if no cached block exists.
+  bool evictOneLocked();
+  void unrefLocked(const BlockPtr &block);
+  BlockPtr allocBlockLocked();
+};
+
+/// @brief A KV cache block. Fields except the tensors are guarded by the mutex of KVBlockPool.
+struct KVBlockPool::Block {
+  Tensor k;
+  Tensor v;
+  Tensor kScale;
+  Tensor vScale;
+
+  int refCount;
+  bool hashed;
+  uint64_t hash;
+
+  // id changes once the content of block is changed. `prevId` is the id of previous block (0 for
+  // the first block) and `tokens` are the tokens stored in this block. They are valid only when
+  // `hashed` is true.
+  uint64_t id;
+  uint64_t prevId;
+  std::vector<LongType> tokens;
+
+  bool inLru;
+  LruIterator lruIt;
+
+  Block();
+};
+
+/// @brief KV cache of one sequence (session) backed by blocks in a shared KVBlockPool.
+/// Usage:
+///     KVSequence seq(pool);
+///     int numReused = seq.matchPrefix(tokens);
+///     seq.reserve(numNew);
+///     for (int layer ...) seq.write(layer, k, v);  // the keys and values of the new tokens.
+///     seq.commit(newTokens);
+///     Tensor k = seq.getKey(layer);  // <dtype>(length, numHeads, headDim)
+/// A block shared with other sequences is copied before written (copy-on-write).
+class KVSequence : private lut::NonCopyable {
+ public:
+  KVSequence(std::shared_ptr<KVBlockPool> pool);
+  ~KVSequence();
+
+  /// @brief Fork a sequence sharing all the blocks of this sequence.
+  std::unique_ptr<KVSequence> fork() const;
+
+  /// @brief Number of tokens committed in this sequence.
+  int getLength() const {
+    return _length;
+  }
+
+  /// @brief Reuse the cached full blocks matching the prefix of `tokens`. It could only be called
+  /// on an empty sequence.
+  /// @param tokens the token ids of the whole prompt.
+  /// @return number of tokens reused. The prefill of tokens[: n] could be skipped.
+  int matchPrefix(lut::Span<const LongType> tokens);
+
+  /// @brief Prepare blocks for the next `numTokens` tokens. The blocks to write will be copied if
+  /// they are shared with other sequences.
+  void reserve(int numTokens);
+
+  /// @brief Write the keys and values for the reserved tokens of a layer.
+  /// @param layer the layer index.
+  /// @param k <dtype>(numTokens, numHeads, headDim): the keys.
+  /// @param v <dtype>(numTokens, numHeads, headDim): the values.
+  void write(int layer, Tensor k, Tensor v);
+
+  /// @brief Commit the reserved tokens. Full blocks are registered to the pool for prefix reuse.
+  /// @param tokens token ids of the reserved tokens.
+  void commit(lut::Span<const LongType> tokens);
+
+  /// @brief Drop the tokens after `length`. Writing after that will trigger copy-on-write if the
+  /// block is shared.
+  void truncate(int length);
+
+  /// @brief Gather the keys or values of a layer into a contiguous tensor. Quantized storage is
+  /// dequantized to float.
+  /// @param layer the layer index.
+  /// @return <dtype>(length, numHeads, headDim): the keys or values.
+  Tensor getKey(int layer) const;
+  Tensor getValue(int layer) const;
+
+  /// @brief Scaled dot product attention against the keys and values of a layer in this
+  /// sequence. The queries are the last L committed tokens and the causal mask is applied. On CPU
+  /// it reads the blocks directly, only visits the keys inside `window` and dequantizes inside
+  /// the attention loops.
+  /// @param layer the layer index.
+  /// @param q <float>(L, numQHeads, headDim): the queries. numQHeads should be a multiple of
+  ///     numHeads (grouped query attention).
+  /// @param window the sliding window or local chunk of the attention.
+  /// @param bias the position bias.
+  /// @return <float>(L, numQHeads, headDim): the attention outputs.
+  Tensor attention(
+      int layer,
+      Tensor q,
+      const AttentionWindow &window = AttentionWindow(),
+      const AttentionBias &bias = AttentionBias()) const;
+
+  /// @brief Get the pool of the blocks.
+  const std::shared_ptr<KVBlockPool> &getPool() const {
+    return _pool;
+  }
+
+  /// @brief Get the token ids of the committed tokens.
+  lut::Span<const LongType> getTokens() const {
+    return lut::makeConstSpan(_tokens);
+  }
+
+  /// @brief Get the blocks of this sequence.
+  lut::Span<const KVBlockPool::BlockPtr> getBlocks() const {
+    return lut::makeConstSpan(_blocks);
+  }
+
+ private:
+  std::shared_ptr<KVBlockPool> _pool;
+  std::vector<KVBlockPool::BlockPtr> _blocks;
+
+  // prefix hash of each full block.
+  std::vector<uint64_t> _hashes;
+
+  // token ids of the committed tokens, used to compute the hashes of blocks once they are full.
+  std::vector<LongType> _tokens;
+
+  int _length;
+  int _numReserved;
+
+  Tensor gather(int layer, bool isKey) const;
+};
+
+/// @brief KV cache of one sequence for the sliding window or chunked local attention. It keeps
+/// only the tokens that could still be attended to in a ring of blocks, so the memory is bounded
+/// by the window instead of the sequence length. Global tokens are not supported.
+/// Usage:
+///     KVRingBuffer ring(pool, window, maxTokensPerStep);
+///     ring.reserve(numNew);
+///     for (int layer ...) {
+///       ring.write(layer, k, v);
+///       Tensor x = ring.attention(layer, q);
+///     }
+///     ring.commit();
+class KVRingBuffer : private lut::NonCopyable {
+ public:
+  /// @brief Create the ring buffer with blocks from `pool`.
+  /// @param pool the block pool.
+  /// @param window the sliding window or local chunk. numGlobalTokens should be 0.
+  /// @param maxTokensPerStep max number of tokens in one reserve() call.
+  KVRingBuffer(std::shared_ptr<KVBlockPool> pool, AttentionWindow window, int maxTokensPerStep);
+  ~KVRingBuffer();
+
+  /// @brief Number of tokens committed (including the evicted ones).
+  int getLength() const {
+    return _length;
+  }
+
+  /// @brief Number of tokens the ring could hold.
+  int getCapacity() const;
+
+  /// @brief Prepare for the next `numTokens` tokens. The slots of tokens outside the window are
+  /// reused.
+  void reserve(int numTokens);
+
+  /// @brief Write the keys and values for the reserved tokens of a layer.
+  /// @param layer the layer index.
+  /// @param k <dtype>(numTokens, numHeads, headDim): the keys.
+  /// @param v <dtype>(numTokens, numHeads, headDim): the values.
+  void write(int layer, Tensor k, Tensor v);
+
+  /// @brief Commit the reserved tokens.
+  void commit();
+
+  /// @brief Attention of the reserved (and written) tokens against the tokens in window. CPU only.
+  /// @param layer the layer index.
+  /// @param q <float>(numTokens, numQHeads, headDim): the queries.
+  /// @param bias the position bias.
+  /// @return <float>(numTokens, numQHeads, headDim): the attention outputs.
+  Tensor attention(int layer, Tensor q, const AttentionBias &bias = AttentionBias()) const;
+
+ private:
+  std::shared_ptr<KVBlockPool> _pool;
+  std::vector<KVBlockPool::BlockPtr> _blocks;
+  AttentionWindow _window;
+  int _maxTokensPerStep;
+
+  int _length;
+  int _numReserved;
+};
+
+}  // namespace lten
@@ -0,0 +1,513 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/kv_cache.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/arena.h"
+#include "lten/cpu/arena.h"
+#include "lten/functional.h"
+#include "lutil/error.h"
+
+namespace lten {
+
+namespace {
+
+constexpr int kNumLayers = 2;
+constexpr int kNumHeads = 2;
+constexpr int kHeadDim = 8;
+constexpr int kBlockSize = 4;
+
+KVCacheConfig getTestConfig(DType dtype = DType::kFloat) {
+  KVCacheConfig config;
+  config.numLayers = kNumLayers;
+  config.numHeads = kNumHeads;
+  config.headDim = kHeadDim;
+  config.blockSize = kBlockSize;
+  config.dtype = dtype;
+
+  return config;
+}
+
+// forward the tokens[seq.getLength():] into `seq`. The KV of each token is generated from `kv`,
+// which is the reference KV for the whole `tokens`.
+void prefill(KVSequence *seq, lut::Span<const LongType> tokens, Tensor kv) {
+  int begin = seq->getLength();
+  int end = static_cast<int>(tokens.size());
+
+  seq->reserve(end - begin);
+  for (int layer = 0; layer < kNumLayers; ++layer) {
+    Tensor x = kv.subtensor(layer).slice({begin, end});
+    seq->write(layer, x, F::mul(x, 2.0f));
+  }
+  seq->commit(tokens.subspan(begin));
+}
+
+bool checkSequence(const KVSequence &seq, Tensor kv, float atol = 1e-5) {
+  for (int layer = 0; layer < kNumLayers; ++layer) {
+    Tensor x = kv.subtensor(layer).slice({0, seq.getLength()});
+    if (!F::allClose(seq.getKey(layer), x, 1e-3, atol)) return false;
+    if (!F::allClose(seq.getValue(layer), F::mul(x, 2.0f), 1e-3, 2 * atol)) return false;
+  }
+
+  return true;
+}
+
+// float mask of the last `numQueries` queries for local attention, the same as
+// F::causalMask() when `window` is empty.
+Tensor localMask(int numQueries, int length, const AttentionWindow &window) {
+  Tensor mask = F::zeros({numQueries, length}, DType::kFloat);
+  float *data = mask.getData<float>();
+  for (int i = 0; i < numQueries; ++i) {
+    int pos = length - numQueries + i;
+    int begin = 0;
+    if (window.window > 0) begin = std::max(begin, pos - window.window + 1);
+    if (window.chunkSize > 0) begin = std::max(begin, pos / window.chunkSize * window.chunkSize);
+
+    for (int j = 0; j < length; ++j) {
+      bool visible = j <= pos && (j >= begin || j < window.numGlobalTokens);
+      if (!visible) data[i * length + j] = -std::numeric_limits<float>::infinity();
+    }
+  }
+
+  return mask;
+}
+
+// the materialized position bias of head `h` for the last `numQueries` queries.
+Tensor biasMask(int numQueries, int length, const AttentionBias &bias, int h) {
+  Tensor mask = F::zeros({numQueries, length}, DType::kFloat);
+  float *data = mask.getData<float>();
+  for (int i = 0; i < numQueries; ++i) {
+    for (int j = 0; j < length; ++j) {
+      int distance = std::max(length - numQueries + i - j, 0);
+      float b = 0.0f;
+      if (!bias.alibiSlopes.empty()) b -= bias.alibiSlopes[h] * distance;
+      if (!bias.relativeBias.empty()) {
+        int numBuckets = bias.relativeBias.getShape(0);
+        int maxExact = numBuckets / 2;
+        int bucket = distance;
+        if (distance >= maxExact) {
+          double r = log(1.0 * distance / maxExact) /
+                     log(1.0 * bias.relativeMaxDistance / maxExact);
+          bucket = maxExact + static_cast<int>(r * (numBuckets - maxExact));
+          bucket = std::min(bucket, numBuckets - 1);
+        }
+        b += bias.relativeBias.getData<float>()[bucket * bias.relativeBias.getShape(1) + h];
+      }
+      data[i * length + j] = b;
+    }
+  }
+
+  return mask;
+}
+
+// reference of KVSequence::attention() with the fp32 attention. Each query head attends to the
+// KV head of its group.
+Tensor attentionRef(
+    Tensor q,
+    Tensor k,
+    Tensor v,
+    const AttentionWindow &window = {},
+    const AttentionBias &bias = {}) {
+  int numQueries = q.getShape(0);
+  int length = k.getShape(0);
+  int groupSize = q.getShape(1) / k.getShape(1);
+  Tensor mask = localMask(numQueries, length, window);
+
+  Tensor x;
+  for (int h = 0; h < q.getShape(1); ++h) {
+    int kvHead = h / groupSize;
+    Tensor xh = F::attention(
+        q.slice(1, {h, h + 1}).transpose(0, 1).unsqueeze(0),
+        k.slice(1, {kvHead, kvHead + 1}).transpose(0, 1).unsqueeze(0),
+        v.slice(1, {kvHead, kvHead + 1}).transpose(0, 1).unsqueeze(0),
+        F::add(mask, biasMask(numQueries, length, bias, h)));
+    xh = xh.squeeze(0).transpose(0, 1);
+    x = x.empty() ? xh : F::cat(x, xh, 1);
+  }
+
+  return x;
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("test KV cache prefix sharing", "[core][kv_cache]") {
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig());
+  std::vector<LongType> tokens{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  Tensor kv = F::rand({kNumLayers, 10, kNumHeads, kHeadDim}, DType::kFloat);
+
+  KVSequence seq0(pool);
+  CATCH_REQUIRE(seq0.matchPrefix(tokens) == 0);
+  prefill(&seq0, tokens, kv);
+  CATCH_REQUIRE(seq0.getLength() == 10);
+  CATCH_REQUIRE(checkSequence(seq0, kv));
+
+  // two full blocks are shared.
+  KVSequence seq1(pool);
+  CATCH_REQUIRE(seq1.matchPrefix(tokens) == 8);
+  CATCH_REQUIRE(pool->getRefCount(seq1.getBlocks()[0]) == 2);
+  CATCH_REQUIRE(pool->getRefCount(seq1.getBlocks()[1]) == 2);
+  prefill(&seq1, tokens, kv);
+  CATCH_REQUIRE(checkSequence(seq1, kv));
+  CATCH_REQUIRE(pool->getStats().numHits == 2);
+  CATCH_REQUIRE(pool->getStats().numBlocks == 4);
+
+  // diverged at the second block.
+  std::vector<LongType> tokens2{1, 2, 3, 4, 5, 0, 7, 8, 9};
+  KVSequence seq2(pool);
+  CATCH_REQUIRE(seq2.matchPrefix(tokens2) == 4);
+  CATCH_REQUIRE(pool->getStats().numMisses == 2);
+}
+
+CATCH_TEST_CASE("test KV cache in arena scope", "[core][kv_cache]") {
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig());
+  std::vector<LongType> tokens{1, 2, 3, 4, 5};
+  Tensor kv = F::rand({kNumLayers, 5, kNumHeads, kHeadDim}, DType::kFloat);
+
+  // the blocks are never allocated from the arena.
+  KVSequence seq(pool);
+  {
+    ArenaScope scope;
+    prefill(&seq, tokens, kv);
+    CATCH_REQUIRE(seq.getBlocks().size() == 2);
+
+    int64_t usedBytes = scope.getArena()->getUsedBytes();
+    KVBlockPool::BlockPtr block = pool->allocBlock();
+    CATCH_REQUIRE(scope.getArena()->getUsedBytes() == usedBytes);
+    pool->unref(block);
+  }
+
+  CATCH_REQUIRE(checkSequence(seq, kv));
+}
+
+CATCH_TEST_CASE("test KV cache hash collision", "[core][kv_cache]") {
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig());
+  std::vector<LongType> tokens0{1, 2, 3, 4};
+  std::vector<LongType> tokens1{5, 6, 7, 8};
+
+  KVBlockPool::BlockPtr block0 = pool->allocBlock();
+  KVBlockPool::BlockPtr block1 = pool->allocBlock();
+  pool->registerBlock(block0, 1, nullptr, tokens0);
+  pool->registerBlock(block1, 2, block0, tokens1);
+
+  // the same hash with different tokens or a different previous block.
+  CATCH_REQUIRE(pool->lookup(1, nullptr, tokens1) == nullptr);
+  CATCH_REQUIRE(pool->lookup(2, nullptr, tokens1) == nullptr);
+  CATCH_REQUIRE(pool->lookup(2, block1, tokens1) == nullptr);
+  CATCH_REQUIRE(pool->getStats().numMisses == 3);
+
+  KVBlockPool::BlockPtr block = pool->lookup(2, block0, tokens1);
+  CATCH_REQUIRE(block == block1);
+  pool->unref(block);
+
+  // block0 is changed in place, block1 no longer follows it.
+  block0 = pool->makeWritable(block0);
+  CATCH_REQUIRE(pool->lookup(2, block0, tokens1) == nullptr);
+
+  pool->unref(block0);
+  pool->unref(block1);
+}
+
+CATCH_TEST_CASE("test KV cache copy-on-write", "[core][kv_cache]") {
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig());
+  std::vector<LongType> tokens{1, 2, 3, 4, 5, 6};
+  Tensor kv = F::rand({kNumLayers, 8, kNumHeads, kHeadDim}, DType::kFloat);
+  Tensor kv2 = F::rand({kNumLayers, 8, kNumHeads, kHeadDim}, DType::kFloat);
+
+  KVSequence seq0(pool);
+  prefill(&seq0, tokens, kv);
+
+  // fork and diverge inside the shared partial block.
+  std::unique_ptr<KVSequence> seq1 = seq0.fork();
+  KVBlockPool::BlockPtr shared = seq1->getBlocks()[1];
+  CATCH_REQUIRE(pool->getRefCount(shared) == 2);
+
+  std::vector<LongType> tokens1{1, 2, 3, 4, 5, 6, 100, 101};
+  Tensor kv1 = F::cat(kv.slice(1, {0, 6}), kv2.slice(1, {6, 8}), 1);
+  prefill(seq1.get(), tokens1, kv1);
+  CATCH_REQUIRE(seq1->getBlocks()[1] != shared);
+  CATCH_REQUIRE(pool->getRefCount(shared) == 1);
+  CATCH_REQUIRE(pool->getStats().numCopyOnWrites == 1);
+  CATCH_REQUIRE(checkSequence(*seq1, kv1));
+
+  // seq0 is not affected.
+  tokens.push_back(7);
+  tokens.push_back(8);
+  prefill(&seq0, tokens, kv);
+  CATCH_REQUIRE(seq0.getBlocks()[1] == shared);
+  CATCH_REQUIRE(checkSequence(seq0, kv));
+
+  // truncate into a shared full block.
+  std::unique_ptr<KVSequence> seq2 = seq0.fork();
+  seq2->truncate(2);
+  prefill(seq2.get(), tokens1, kv1);
+  CATCH_REQUIRE(checkSequence(*seq2, kv1));
+  CATCH_REQUIRE(checkSequence(seq0, kv));
+  CATCH_REQUIRE(pool->getStats().numCopyOnWrites == 2);
+}
+
+CATCH_TEST_CASE("test KV cache LRU eviction", "[core][kv_cache]") {
+  KVCacheConfig config = getTestConfig();
+  config.maxBytes = KVBlockPool::create(config)->getBlockBytes() * 3;
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(config);
+  Tensor kv = F::rand({kNumLayers, 5, kNumHeads, kHeadDim}, DType::kFloat);
+
+  std::vector<LongType> tokens0{1, 2, 3, 4, 5};
+  std::vector<LongType> tokens1{2, 3, 4, 5, 6};
+  std::vector<LongType> tokens2{3, 4, 5, 6, 7};
+  {
+    KVSequence seq(pool);
+    prefill(&seq, tokens0, kv);
+  }
+  {
+    KVSequence seq(pool);
+    prefill(&seq, tokens1, kv);
+  }
+
+  // only the full blocks are cached.
+  CATCH_REQUIRE(pool->getStats().numCachedBlocks == 2);
+  CATCH_REQUIRE(pool->getStats().numBlocks == 2);
+
+  // touch tokens0, then tokens1 will be the LRU block.
+  {
+    KVSequence seq(pool);
+    CATCH_REQUIRE(seq.matchPrefix(tokens0) == 4);
+  }
+
+  KVSequence seq(pool);
+  prefill(&seq, tokens2, kv);
+  CATCH_REQUIRE(pool->getStats().numEvictions == 1);
+  CATCH_REQUIRE(pool->getStats().numBytes <= config.maxBytes);
+
+  KVSequence seq0(pool);
+  CATCH_REQUIRE(seq0.matchPrefix(tokens0) == 4);
+  KVSequence seq1(pool);
+  CATCH_REQUIRE(seq1.matchPrefix(tokens1) == 0);
+
+  // all the blocks are in use.
+  KVSequence seq3(pool);
+  CATCH_REQUIRE_THROWS_AS(prefill(&seq3, tokens1, kv), lut::AbortedError);
+}
+
+CATCH_TEST_CASE("test KV cache quantized storage", "[core][kv_cache]") {
+  std::vector<LongType> tokens{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  Tensor kv = F::rand({kNumLayers, 10, kNumHeads, kHeadDim}, DType::kFloat);
+
+  int64_t bytesFloat = KVBlockPool::create(getTestConfig())->getBytesPerToken();
+  CATCH_REQUIRE(bytesFloat == 2 * kNumLayers * kNumHeads * kHeadDim * 4);
+
+  // fp16 halves the memory.
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig(DType::kFloat16));
+  CATCH_REQUIRE(pool->getBytesPerToken() * 2 == bytesFloat);
+  {
+    KVSequence seq(pool);
+    prefill(&seq, tokens, kv);
+    CATCH_REQUIRE(checkSequence(seq, kv, 1e-3));
+  }
+
+  // int8 with a float scale per token per head.
+  pool = KVBlockPool::create(getTestConfig(DType::kInt8));
+  CATCH_REQUIRE(pool->getBytesPerToken() == 2 * kNumLayers * kNumHeads * (kHeadDim + 4));
+  CATCH_REQUIRE(pool->getBlockBytes() == pool->getBytesPerToken() * kBlockSize);
+  {
+    KVSequence seq(pool);
+    prefill(&seq, tokens, kv);
+    CATCH_REQUIRE(checkSequence(seq, kv, 1.0f / 127));
+
+    // copy-on-write keeps the scales.
+    std::unique_ptr<KVSequence> seq1 = seq.fork();
+    seq1->truncate(6);
+    prefill(seq1.get(), tokens, kv);
+    CATCH_REQUIRE(pool->getStats().numCopyOnWrites == 1);
+    CATCH_REQUIRE(checkSequence(*seq1, kv, 1.0f / 127));
+  }
+}
+
+CATCH_TEST_CASE("test KV cache attention", "[core][kv_cache]") {
+  constexpr int kNumQHeads = 4;
+  constexpr int kLength = 11;
+  std::vector<LongType> tokens{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  Tensor kv = F::rand({kNumLayers, kLength, kNumHeads, kHeadDim}, DType::kFloat);
+  Tensor q = F::rand({kLength, kNumQHeads, kHeadDim}, DType::kFloat);
+
+  // prefill of the whole sequence, then decoding of the last token.
+  std::vector<float> atols{1e-5, 2e-3, 2e-2};
+  std::vector<DType> dtypes{DType::kFloat, DType::kFloat16, DType::kInt8};
+  for (int i = 0; i < static_cast<int>(dtypes.size()); ++i) {
+    std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig(dtypes[i]));
+    std::vector<LongType> prompt(tokens.begin(), tokens.end() - 1);
+    KVSequence seq(pool);
+    prefill(&seq, prompt, kv);
+
+    for (int layer = 0; layer < kNumLayers; ++layer) {
+      Tensor k = kv.subtensor(layer).slice({0, kLength - 1});
+      Tensor x = seq.attention(layer, q.slice({0, kLength - 1}));
+      Tensor xr = attentionRef(q.slice({0, kLength - 1}), k, F::mul(k, 2.0f));
+      CATCH_REQUIRE(F::allClose(x, xr, 1e-3, atols[i]));
+    }
+
+    prefill(&seq, tokens, kv);
+    for (int layer = 0; layer < kNumLayers; ++layer) {
+      Tensor k = kv.subtensor(layer);
+      Tensor x = seq.attention(layer, q.slice({kLength - 1, kLength}));
+      Tensor xr = attentionRef(q.slice({kLength - 1, kLength}), k, F::mul(k, 2.0f));
+      CATCH_REQUIRE(F::allClose(x, xr, 1e-3, atols[i]));
+    }
+  }
+}
+
+CATCH_TEST_CASE("test KV cache local attention", "[core][kv_cache]") {
+  constexpr int kLength = 13;
+  std::vector<LongType> tokens(kLength);
+  for (int i = 0; i < kLength; ++i) tokens[i] = i + 1;
+  Tensor kv = F::rand({kNumLayers, kLength, kNumHeads, kHeadDim}, DType::kFloat);
+  Tensor q = F::rand({kLength, kNumHeads, kHeadDim}, DType::kFloat);
+
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig());
+  KVSequence seq(pool);
+  prefill(&seq, tokens, kv);
+
+  std::vector<AttentionWindow> windows(5);
+  windows[0].window = 5;
+  windows[1].chunkSize = 4;
+  windows[2].chunkSize = 4;
+  windows[2].numGlobalTokens = 2;
+  windows[3].window = 3;
+  windows[3].numGlobalTokens = 5;
+  windows[4].window = 6;
+  windows[4].chunkSize = 8;
+  for (const AttentionWindow &window : windows) {
+    Tensor k = kv.subtensor(1);
+    Tensor x = seq.attention(1, q, window);
+    Tensor xr = attentionRef(q, k, F::mul(k, 2.0f), window);
+    CATCH_REQUIRE(F::allClose(x, xr));
+  }
+}
+
+CATCH_TEST_CASE("test KV cache ring buffer", "[core][kv_cache]") {
+  constexpr int kLength = 21;
+  constexpr int kMaxTokensPerStep = 3;
+  Tensor kv = F::rand({kNumLayers, kLength, kNumHeads, kHeadDim}, DType::kFloat);
+  Tensor q = F::rand({kLength, kNumHeads, kHeadDim}, DType::kFloat);
+
+  std::vector<AttentionWindow> windows(2);
+  windows[0].window = 5;
+  windows[1].chunkSize = 6;
+  std::vector<DType> dtypes{DType::kFloat, DType::kInt8};
+  std::vector<float> atols{1e-5, 2e-2};
+  for (int i = 0; i < static_cast<int>(dtypes.size()); ++i) {
+    for (const AttentionWindow &window : windows) {
+      std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig(dtypes[i]));
+      KVRingBuffer ring(pool, window, kMaxTokensPerStep);
+      CATCH_REQUIRE(ring.getCapacity() < kLength);
+      CATCH_REQUIRE(pool->getStats().numBlocks * kBlockSize == ring.getCapacity());
+
+      // prefill with the max step, then decode token by token.
+      int begin = 0;
+      while (begin < kLength) {
+        int n = begin == 0 ? kMaxTokensPerStep : 1;
+        ring.reserve(n);
+        for (int layer = 0; layer < kNumLayers; ++layer) {
+          Tensor k = kv.subtensor(layer).slice({begin, begin + n});
+          ring.write(layer, k, F::mul(k, 2.0f));
+
+          Tensor x = ring.attention(layer, q.slice({begin, begin + n}));
+          Tensor kr = kv.subtensor(layer).slice({0, begin + n});
+          Tensor xr = attentionRef(q.slice({begin, begin + n}), kr, F::mul(kr, 2.0f), window);
+          CATCH_REQUIRE(F::allClose(x, xr, 1e-3, atols[i]));
+        }
+        ring.commit();
+        begin += n;
+      }
+      CATCH_REQUIRE(ring.getLength() == kLength);
+    }
+  }
+}
+
+CATCH_TEST_CASE("test KV cache attention bias", "[core][kv_cache]") {
+  constexpr int kNumQHeads = 6;
+  constexpr int kLength = 40;
+  std::vector<LongType> tokens(kLength);
+  for (int i = 0; i < kLength; ++i) tokens[i] = i + 1;
+  Tensor kv = F::rand({kNumLayers, kLength, kNumHeads, kHeadDim}, DType::kFloat);
+  Tensor q = F::rand({kLength, kNumQHeads, kHeadDim}, DType::kFloat);
+
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig());
+  KVSequence seq(pool);
+  prefill(&seq, tokens, kv);
+
+  // slopes for 6 heads: 4 heads from 2^-2 and 2 interpolated heads from 2^-1.
+  AttentionBias alibi = AttentionBias::alibi(kNumQHeads);
+  CATCH_REQUIRE(alibi.alibiSlopes.size() == kNumQHeads);
+  CATCH_REQUIRE(fabs(alibi.alibiSlopes[0] - 0.25f) < 1e-6);
+  CATCH_REQUIRE(fabs(alibi.alibiSlopes[4] - 0.5f) < 1e-6);
+
+  Tensor table = F::rand({8, kNumQHeads}, DType::kFloat);
+  AttentionBias relative = AttentionBias::relativePosition(table, 20);
+  AttentionWindow window;
+  window.window = 16;
+
+  Tensor k = kv.subtensor(0);
+  Tensor v = F::mul(k, 2.0f);
+  CATCH_REQUIRE(F::allClose(seq.attention(0, q, {}, alibi), attentionRef(q, k, v, {}, alibi)));
+  CATCH_REQUIRE(F::allClose(
+      seq.attention(0, q, {}, relative),
+      attentionRef(q, k, v, {}, relative)));
+  CATCH_REQUIRE(F::allClose(
+      seq.attention(0, q, window, alibi),
+      attentionRef(q, k, v, window, alibi)));
+}
+
+CATCH_TEST_CASE("test varlen attention", "[core][attention]") {
+  constexpr int kNumQHeads = 4;
+  std::vector<LongType> seqlensQ{5, 1, 12, 3};
+  std::vector<LongType> seqlensK{5, 9, 12, 70};
+
+  std::vector<LongType> cuQ{0}, cuK{0};
+  for (int b = 0; b < static_cast<int>(seqlensQ.size()); ++b) {
+    cuQ.push_back(cuQ.back() + seqlensQ[b]);
+    cuK.push_back(cuK.back() + seqlensK[b]);
+  }
+
+  int totalQ = static_cast<int>(cuQ.back());
+  int totalK = static_cast<int>(cuK.back());
+  Tensor q = F::rand({totalQ, kNumQHeads, kHeadDim}, DType::kFloat);
+  Tensor k = F::rand({totalK, kNumHeads, kHeadDim}, DType::kFloat);
+  Tensor v = F::rand({totalK, kNumHeads, kHeadDim}, DType::kFloat);
+  Tensor cuSeqlensQ = Tensor::create<LongType>({static_cast<int>(cuQ.size())}, cuQ);
+  Tensor cuSeqlensK = Tensor::create<LongType>({static_cast<int>(cuK.size())}, cuK);
+
+  Tensor x = F::varlenAttention(q, k, v, cuSeqlensQ, cuSeqlensK);
+  for (int b = 0; b < static_cast<int>(seqlensQ.size()); ++b) {
+    int beginQ = static_cast<int>(cuQ[b]), endQ = static_cast<int>(cuQ[b + 1]);
+    int beginK = static_cast<int>(cuK[b]), endK = static_cast<int>(cuK[b + 1]);
+    Tensor xr = attentionRef(
+        q.slice({beginQ, endQ}),
+        k.slice({beginK, endK}),
+        v.slice({beginK, endK}));
+    CATCH_REQUIRE(F::allClose(x.slice({beginQ, endQ}), xr));
+  }
+}
+
+}  // namespace lten
@@ -0,0 +1,210 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/lazy_tensor.h"
+
+#include <condition_variable>
+#include <mutex>
+
+#include "lutil/error.h"
+#include "lutil/log.h"
+#include "lutil/thread_pool.h"
+#include "lutil/zip_file.h"
+
+namespace lten {
+
+// process-wide LRU list of the resident lazy tensors.
+class LazyTensor::Cache {
+ public:
+  static Cache *getInstance();
+
+  std::mutex mutex;
+  std::condition_variable loadedCond;
+
+  // resident tensors, the front is the most recently used one.
+  std::list<LazyTensor *> lru;
+  int64_t residentBytes;
+  int64_t budget;
+
+  Cache();
+
+  // evict the least recently used tensors until the resident bytes is within the budget. `keep`
+  // is never evicted, even if it alone exceeds the budget. Should be called with mutex held.
+  void evict(const LazyTensor *keep);
+
+  // the thread materializing the prefetched tensors, started on the first call.
+  lut::ThreadPool *getPrefetchPool();
+
+ private:
+  std::once_flag _prefetchPoolFlag;
+  std::unique_ptr<lut::ThreadPool> _prefetchPool;
+};
+
+LazyTensor::Cache::Cache()
+    : residentBytes(0),
+      budget(NoLimit) {
+}
+
+LazyTensor::Cache *LazyTensor::Cache::getInstance() {
+  // never destroyed, since the lazy tensors and the prefetch thread may outlive the static
+  // variables at exit.
+  static Cache *cache = new Cache();
+  return cache;
+}
+
+void LazyTensor::Cache::evict(const LazyTensor *keep) {
+  while (residentBytes > budget && !lru.empty() && lru.back() != keep) {
+    LazyTensor *victim = lru.back();
+    lru.pop_back();
+
+    // the data is released here unless it is still held by the tensors from get().
+    victim->_tensor = Tensor();
+    victim->_state = State::kEvicted;
+    residentBytes -= victim->_size;
+  }
+}
+
+lut::ThreadPool *LazyTensor::Cache::getPrefetchPool() {
+  std::call_once(_prefetchPoolFlag, [this]() {
+    _prefetchPool = std::make_unique<lut::ThreadPool>(1);
+    _prefetchPool->start();
+  });
+
+  return _prefetchPool.get();
+}
+
+// -- class LazyTensor ----------
+
+LazyTensor::LazyTensor()
+    : _dtype(DType::kUnknown),
+      _state(State::kEvicted),
+      _size(0) {
+}
+
+LazyTensor::~LazyTensor() {
+  Cache *cache = Cache::getInstance();
+  std::lock_guard<std::mutex> lock(cache->mutex);
+
+  if (_state == State::kResident) {
+    cache->lru.erase(_lruIt);
+    cache->residentBytes -= _size;
+  }
+}
+
+std::shared_ptr<LazyTensor> LazyTensor::create(
+    std::shared_ptr<lut::ZipFile> zipFile,
+    const std::string &name,
+    DType dtype) {
+  CHECK(zipFile);
+
+  std::shared_ptr<LazyTensor> tensor{new LazyTensor()};
+  tensor->_zipFile = zipFile;
+  tensor->_name = name;
+  tensor->_dtype = dtype;
+
+  return tensor;
+}
+
+void LazyTensor::setMemoryBudget(int64_t bytes) {
+  CHECK(bytes >= 0);
+
+  Cache *cache = Cache::getInstance();
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  cache->budget = bytes;
+  cache->evict(nullptr);
+}
+
+int64_t LazyTensor::getMemoryBudget() {
+  Cache *cache = Cache::getInstance();
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  return cache->budget;
+}
+
+int64_t LazyTensor::getResidentBytes() {
+  Cache *cache = Cache::getInstance();
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  return cache->residentBytes;
+}
+
+Tensor LazyTensor::get() {
+  Cache *cache = Cache::getInstance();
+  std::unique_lock<std::mutex> lock(cache->mutex);
+
+  // wait for the loading one in other thread, it may also be evicted again before we wake up.
+  while (_state != State::kEvicted) {
+    if (_state == State::kResident) {
+      cache->lru.splice(cache->lru.begin(), cache->lru, _lruIt);
+      return _tensor;
+    }
+
+    cache->loadedCond.wait(lock);
+  }
+
+  // read the tensor without holding the lock.
+  _state = State::kLoading;
+  lock.unlock();
+
+  Tensor tensor;
+  try {
+    tensor = readTensor(*_zipFile, _name, _dtype);
+  } catch (...) {
+    lock.lock();
+    _state = State::kEvicted;
+    cache->loadedCond.notify_all();
+    throw;
+  }
+
+  lock.lock();
+  _tensor = tensor;
+  _size = tensor.getDType().getTotalSize(tensor.getNumEl());
+  _state = State::kResident;
+  cache->lru.push_front(this);
+  _lruIt = cache->lru.begin();
+  cache->residentBytes += _size;
+  cache->evict(this);
+  cache->loadedCond.notify_all();
+
+  return tensor;
+}
+
+void LazyTensor::prefetch() {
+  Cache *cache = Cache::getInstance();
+  {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (_state != State::kEvicted) return;
+  }
+
+  // the closure holds a reference, so the tensor is alive until the prefetch finished.
+  std::shared_ptr<LazyTensor> self = shared_from_this();
+  cache->getPrefetchPool()->apply([self]() {
+    try {
+      self->get();
+    } catch (const lut::Error &e) {
+      LOG(WARN) << "failed to prefetch tensor " << self->_name << ": " << e.what();
+    }
+  });
+}
+
+bool LazyTensor::isResident() const {
+  Cache *cache = Cache::getInstance();
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  return _state == State::kResident;
+}
+
+}  // namespace lten
@@ -0,0 +1,105 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "lten/dtype.h"
+#include "lten/tensor.h"
+
+namespace lut {
+class ZipFile;
+}  // namespace lut
+
+namespace lten {
+
+/// @brief A weight that stays in the model file until it is used, for hosts that could not keep
+/// all the models resident. It records the location of the tensor at load time, and reads (then
+/// converts to `dtype`, e.g. dequantizes) it on the first get().
+///
+/// The materialized tensors are held by a process-wide cache with a byte budget. Once the budget
+/// is exceeded, the least recently used ones are evicted and will be read again on the next get().
+/// Eviction only drops the reference of the cache, so the Tensor returned by get() stays valid,
+/// hold it while computing with the weight:
+///
+///   Tensor w = weight->get();
+///   nextLayerWeight->prefetch();
+///   x = F::matmul(x, w);
+///
+/// All the methods are thread-safe.
+class LazyTensor : public std::enable_shared_from_this<LazyTensor> {
+ public:
+  static constexpr int64_t NoLimit = INT64_MAX;
+
+  /// @brief Create the lazy tensor of the entry `name` in `zipFile`. Nothing is read here.
+  /// @param zipFile the model file.
+  /// @param name name of the entry, in the format of Tensor::read().
+  /// @param dtype if not DType::kUnknown, the tensor is converted to `dtype` when materialized.
+  static std::shared_ptr<LazyTensor> create(
+      std::shared_ptr<lut::ZipFile> zipFile,
+      const std::string &name,
+      DType dtype = DType::kUnknown);
+
+  /// @brief Set the budget in bytes of the materialized tensors in the process. The least recently
+  /// used tensors are evicted immediately if the new budget is exceeded.
+  static void setMemoryBudget(int64_t bytes);
+  static int64_t getMemoryBudget();
+
+  /// @brief Get the bytes of the tensors currently held by the cache.
+  static int64_t getResidentBytes();
+
+  ~LazyTensor();
+
+  LazyTensor(const LazyTensor &) = delete;
+  LazyTensor &operator=(const LazyTensor &) = delete;
+
+  /// @brief Get the tensor, materialize it if it is not resident. It blocks until the tensor is
+  /// read, including the one being prefetched.
+  Tensor get();
+
+  /// @brief Start materializing the tensor in the background thread, so that the following get()
+  /// does not wait for the disk. It does nothing if the tensor is already resident or loading.
+  void prefetch();
+
+  /// @brief Returns true if the tensor is held by the cache.
+  bool isResident() const;
+
+ private:
+  class Cache;
+  enum class State { kEvicted, kLoading, kResident };
+
+  std::shared_ptr<lut::ZipFile> _zipFile;
+  std::string _name;
+  DType _dtype;
+
+  // fields below are guarded by the mutex of Cache.
+  State _state;
+  Tensor _tensor;
+  int64_t _size;
+  std::list<LazyTensor *>::iterator _lruIt;
+
+  LazyTensor();
+};
+
+}  // namespace lten
@@ -0,0 +1,138 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/lazy_tensor.h"
+
+#include <stdio.h>
+
+#include <chrono>
+#include <thread>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/functional.h"
+#include "lten/test_helper.h"
+#include "lutil/path.h"
+#include "lutil/strings.h"
+#include "lutil/zip_file.h"
+
+namespace lten {
+
+namespace {
+
+constexpr int kNumTensors = 4;
+
+// write the tensors into a zip file and return the file name.
+std::string writeTestZipFile(const std::vector<Tensor> &tensors) {
+  std::string zipData;
+  for (int i = 0; i < static_cast<int>(tensors.size()); ++i) {
+    // misaligned, so the data is read into memory instead of mapped.
+    appendTensorZipEntry(&zipData, lut::sprintf("%d.tensor", i), tensors[i], 4);
+  }
+
+  lut::Path dirname = lut::Path::currentExecutablePath().dirname();
+  std::string filename = (dirname / "test_lazy_tensor.zip").string();
+  writeFile(filename, zipData);
+
+  return filename;
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("test LazyTensor eviction", "[core][lazy_tensor]") {
+  std::vector<Tensor> tensors;
+  for (int i = 0; i < kNumTensors; ++i) tensors.push_back(F::rand({16, 64}, DType::kFloat));
+  std::string filename = writeTestZipFile(tensors);
+  int64_t tensorSize = 16 * 64 * sizeof(float);
+
+  std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(filename);
+  std::vector<std::shared_ptr<LazyTensor>> lazyTensors;
+  for (int i = 0; i < kNumTensors; ++i) {
+    lazyTensors.push_back(LazyTensor::create(zipFile, lut::sprintf("%d.tensor", i)));
+  }
+
+  // nothing is read on create.
+  int64_t residentBytes = LazyTensor::getResidentBytes();
+  CATCH_REQUIRE(!lazyTensors[0]->isResident());
+
+  Tensor w0 = lazyTensors[0]->get();
+  CATCH_REQUIRE(lazyTensors[0]->isResident());
+  CATCH_REQUIRE(F::allClose(w0, tensors[0]));
+  CATCH_REQUIRE(LazyTensor::getResidentBytes() == residentBytes + tensorSize);
+
+  // budget for two tensors.
+  LazyTensor::setMemoryBudget(residentBytes + 2 * tensorSize);
+  lazyTensors[1]->get();
+  lazyTensors[2]->get();
+  CATCH_REQUIRE(!lazyTensors[0]->isResident());
+  CATCH_REQUIRE(lazyTensors[1]->isResident());
+  CATCH_REQUIRE(lazyTensors[2]->isResident());
+
+  // the evicted tensor is still valid for the holder.
+  CATCH_REQUIRE(F::allClose(w0, tensors[0]));
+
+  // the least recently used one is evicted.
+  lazyTensors[1]->get();
+  lazyTensors[3]->get();
+  CATCH_REQUIRE(lazyTensors[1]->isResident());
+  CATCH_REQUIRE(!lazyTensors[2]->isResident());
+  CATCH_REQUIRE(lazyTensors[3]->isResident());
+  CATCH_REQUIRE(LazyTensor::getResidentBytes() == residentBytes + 2 * tensorSize);
+
+  // read again after eviction.
+  CATCH_REQUIRE(F::allClose(lazyTensors[2]->get(), tensors[2]));
+
+  // destroyed tensors are removed from the cache.
+  LazyTensor::setMemoryBudget(LazyTensor::NoLimit);
+  lazyTensors.clear();
+  CATCH_REQUIRE(LazyTensor::getResidentBytes() == residentBytes);
+
+  zipFile = nullptr;
+  remove(filename.c_str());
+}
+
+CATCH_TEST_CASE("test LazyTensor prefetch", "[core][lazy_tensor]") {
+  std::vector<Tensor> tensors;
+  for (int i = 0; i < kNumTensors; ++i) tensors.push_back(F::rand({16, 64}, DType::kFloat));
+  std::string filename = writeTestZipFile(tensors);
+
+  std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(filename);
+  std::shared_ptr<LazyTensor> x = LazyTensor::create(zipFile, "1.tensor", DType::kFloat16);
+
+  x->prefetch();
+  for (int i = 0; i < 1000 && !x->isResident(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CATCH_REQUIRE(x->isResident());
+
+  Tensor w = x->get();
+  CATCH_REQUIRE(w.getDType() == DType::kFloat16);
+  CATCH_REQUIRE(F::allClose(F::cast(w, DType::kFloat), tensors[1], 1e-2));
+
+  // failures in the prefetch thread are dropped, and thrown by get().
+  std::shared_ptr<LazyTensor> missing = LazyTensor::create(zipFile, "missing.tensor");
+  missing->prefetch();
+  CATCH_REQUIRE_THROWS(missing->get());
+
+  x = nullptr;
+  missing = nullptr;
+  zipFile = nullptr;
+  remove(filename.c_str());
+}
+
+}  // namespace lten
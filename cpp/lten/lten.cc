@@ -21,12 +21,22 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
+#include "lten/arena.h"
+#include "lten/checksum.h"
+#include "lten/cpu/cpu_allocator.h"
+#include "lten/cpu/cpu_tensor_data.h"
+#include "lten/cpu/numa.h"
 #include "lten/functional.h"
+#include "lten/memory_stats.h"
 #include "lten/operators.h"
+#include "lten/safetensors.h"
 #include "lten/tensor.h"
 #include "lutil/error.h"
 #include "lutil/strings.h"
@@ -35,6 +45,8 @@ namespace F = lten::F;
 using lten::Device;
 using lten::DType;
 using lten::Tensor;
+using lten::op::cpu::CpuAllocator;
+using lten::op::cpu::HugePagePolicy;
 
 namespace {
 
@@ -122,13 +134,26 @@ int32_t fromDevice(lten::Device device) {
   }
 }
 
-std::vector<int> getShape(int32_t dim, const int64_t *shape) {
-  std::vector<int> lshape(dim);
-  for (int d = 0; d < dim; ++d) {
-    lshape[d] = static_cast<int>(shape[d]);
-  }
+void toLMemoryStats(const lten::MemoryStats &stats, LMemoryStats *lstats) {
+  static_assert(
+      LTEN_MEMORY_HISTOGRAM_SIZE == lten::MemoryStats::NumHistogramBuckets,
+      "histogram size mismatch");
+
+  lstats->live_bytes = stats.liveBytes;
+  lstats->peak_bytes = stats.peakBytes;
+  lstats->num_allocs = stats.numAllocs;
+  lstats->num_frees = stats.numFrees;
+  std::copy(stats.histogram, stats.histogram + LTEN_MEMORY_HISTOGRAM_SIZE, lstats->histogram);
 
-  return lshape;
+  size_t len = std::min(stats.peakScope.size(), size_t(LTEN_MEMORY_SCOPE_NAME_SIZE - 1));
+  memcpy(lstats->peak_scope, stats.peakScope.data(), len);
+  lstats->peak_scope[len] = '\0';
+}
+
+std::vector<lten::Tensor::ShapeType> getShape(int32_t dim, const int64_t *shape) {
+  if (dim < 0 || dim > lten::TensorShape::MaxDim) throw lut::InvalidArgError("dim");
+
+  return std::vector<lten::Tensor::ShapeType>(shape, shape + dim);
 }
 
 int getLtenOpTensorOperandNum(int32_t op) {
@@ -160,6 +185,23 @@ struct LTensor {
   lten::Tensor tensorl;
 };
 
+struct LArenaScope {
+  lten::ArenaScope scope;
+};
+
+struct LMemoryScope {
+  lten::MemoryScope scope;
+
+  LMemoryScope(const std::string &name)
+      : scope(name) {
+  }
+};
+
+struct LSafeTensors {
+  std::shared_ptr<lten::SafeTensors> st;
+  std::vector<std::string> names;
+};
+
 const char *lten_last_error_message() {
   return gErrorMessage;
 }
@@ -183,7 +225,7 @@ LTensor *lten_new_tensor(int32_t dim, const int64_t *shape, int32_t dtype, int32
     lten::DType dtypel = getDType(dtype);
 
     std::unique_ptr<LTensor> tensor = std::make_unique<LTensor>();
-    std::vector<int> shapel = getShape(dim, shape);
+    std::vector<lten::Tensor::ShapeType> shapel = getShape(dim, shape);
     tensor->tensorl = F::tensor(shapel, dtypel, devicel);
 
     return tensor.release();
@@ -193,6 +235,67 @@ LTensor *lten_new_tensor(int32_t dim, const int64_t *shape, int32_t dtype, int32
   }
 }
 
+LTensor *lten_new_tensor_from_ptr(
+    int32_t dim,
+    const int64_t *shape,
+    const int64_t *strides,
+    int32_t dtype,
+    void *ptr,
+    LDeleter deleter,
+    void *ctx) {
+  initLTen();
+
+  try {
+    if (!shape) throw lut::InvalidArgError("shape");
+    if (!ptr) throw lut::InvalidArgError("ptr");
+    lten::DType dtypel = getDType(dtype);
+    if (dtypel.isQuantized()) throw lut::InvalidArgError("dtype");
+
+    std::vector<lten::Tensor::ShapeType> shapel = getShape(dim, shape);
+    std::vector<lten::TensorShape::Elem> elems(dim);
+    int64_t stride = 1;
+    int64_t numel = 1;
+    for (int d = dim - 1; d >= 0; --d) {
+      if (shape[d] <= 0 || shape[d] > lten::TensorData::MaxNumEl) {
+        throw lut::InvalidArgError("shape");
+      }
+      if (strides) stride = strides[d];
+      if (stride < 0 || stride > lten::TensorData::MaxNumEl) {
+        throw lut::InvalidArgError("strides");
+      }
+
+      elems[d].shape = shapel[d];
+      elems[d].stride = stride;
+
+      // number of elements spanned by the tensor. It is checked by division, which never
+      // overflows, before accumulating.
+      if (stride > 0 && shape[d] - 1 > (lten::TensorData::MaxNumEl - numel) / stride) {
+        throw lut::InvalidArgError("the tensor spans too many elements");
+      }
+      numel += (shape[d] - 1) * stride;
+      if (!strides) stride *= shape[d];
+    }
+
+    // nothing should fail after the deleter is attached to the tensor data.
+    lten::TensorShape tensorShape(lut::makeConstSpan(elems));
+    std::unique_ptr<LTensor> tensor = std::make_unique<LTensor>();
+
+    std::function<void()> deleterl;
+    if (deleter) deleterl = [deleter, ptr, ctx]() { deleter(ptr, ctx); };
+    std::shared_ptr<lten::TensorData> data = lten::op::cpu::CpuTensorData::createFromPtr(
+        numel,
+        dtypel,
+        reinterpret_cast<lten::Byte *>(ptr),
+        std::move(deleterl));
+    tensor->tensorl = lten::Tensor::create(tensorShape, data);
+
+    return tensor.release();
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return nullptr;
+  }
+}
+
 int32_t lten_get_dim(LTensor *tensor, int32_t *dim) {
   try {
     if (!tensor) throw lut::InvalidArgError("tensor");
@@ -249,7 +352,7 @@ LTensor *lten_view(LTensor *tensor, int32_t dim, int64_t *shape) {
     if (!shape) throw lut::InvalidArgError("shape");
 
     std::unique_ptr<LTensor> out = std::make_unique<LTensor>();
-    std::vector<int> shapel = getShape(dim, shape);
+    std::vector<lten::Tensor::ShapeType> shapel = getShape(dim, shape);
     out->tensorl = tensor->tensorl.view(shapel);
 
     return out.release();
@@ -279,7 +382,7 @@ LTensor *lten_expand(LTensor *tensor, int32_t dim, int64_t *shape) {
     if (!shape) throw lut::InvalidArgError("shape");
 
     std::unique_ptr<LTensor> out = std::make_unique<LTensor>();
-    std::vector<int> shapel = getShape(dim, shape);
+    std::vector<lten::Tensor::ShapeType> shapel = getShape(dim, shape);
     out->tensorl = tensor->tensorl.expand(shapel);
 
     return out.release();
@@ -296,9 +399,7 @@ LTensor *lten_slice(LTensor *tensor, int32_t dim, int64_t begin, int64_t end) {
     if (end == LTEN_RANGE_NONE) end = lten::None;
 
     std::unique_ptr<LTensor> out = std::make_unique<LTensor>();
-    out->tensorl = tensor->tensorl.slice(
-        dim,
-        std::make_pair<int, int>(static_cast<int>(begin), static_cast<int>(end)));
+    out->tensorl = tensor->tensorl.slice(dim, {begin, end});
 
     return out.release();
   } catch (const lut::Error &e) {
@@ -434,6 +535,259 @@ LTensor *lten_clone(LTensor *tensor) {
   }
 }
 
+int32_t lten_set_huge_page_policy(int32_t policy, int64_t min_size) {
+  try {
+    if (min_size < 0) throw lut::InvalidArgError("min_size");
+    switch (policy) {
+      case LTEN_HUGE_PAGE_DISABLED:
+        CpuAllocator::setHugePagePolicy(HugePagePolicy::kDisabled, min_size);
+        break;
+      case LTEN_HUGE_PAGE_TRANSPARENT:
+        CpuAllocator::setHugePagePolicy(HugePagePolicy::kTransparent, min_size);
+        break;
+      case LTEN_HUGE_PAGE_HUGETLB:
+        CpuAllocator::setHugePagePolicy(HugePagePolicy::kHugeTlb, min_size);
+        break;
+      default:
+        throw lut::InvalidArgError("policy");
+    }
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+int32_t lten_get_num_huge_pages(int64_t *num_pages) {
+  try {
+    if (!num_pages) throw lut::InvalidArgError("num_pages");
+    *num_pages = CpuAllocator::getNumHugePages();
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+int32_t lten_place_numa(LTensor *tensor, int32_t placement) {
+  try {
+    if (!tensor) throw lut::InvalidArgError("tensor");
+
+    bool success;
+    switch (placement) {
+      case LTEN_NUMA_PARTITION_ROWS:
+        success = lten::op::cpu::placeRowsOnNumaNodes(tensor->tensorl);
+        break;
+      case LTEN_NUMA_INTERLEAVE:
+        success = lten::op::cpu::interleaveOnNumaNodes(tensor->tensorl);
+        break;
+      default:
+        throw lut::InvalidArgError("placement");
+    }
+    if (!success) throw lut::AbortedError("unable to place the tensor on NUMA nodes");
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+LArenaScope *lten_enter_arena_scope() {
+  initLTen();
+
+  try {
+    return new LArenaScope();
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return nullptr;
+  }
+}
+
+int32_t lten_exit_arena_scope(LArenaScope *scope) {
+  try {
+    if (!scope) throw lut::InvalidArgError("scope");
+    if (!scope->scope.isInnermost()) throw lut::InvalidArgError("scope is not the innermost one");
+    delete scope;
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+int32_t lten_get_memory_stats(int32_t device, LMemoryStats *stats) {
+  try {
+    if (!stats) throw lut::InvalidArgError("stats");
+    toLMemoryStats(lten::getMemoryStats(getDevice(device).getType()), stats);
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+int32_t lten_reset_peak_memory_stats(int32_t device) {
+  try {
+    lten::resetPeakMemoryStats(getDevice(device).getType());
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+LMemoryScope *lten_enter_memory_scope(const char *name) {
+  initLTen();
+
+  try {
+    if (!name) throw lut::InvalidArgError("name");
+    return new LMemoryScope(name);
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return nullptr;
+  }
+}
+
+int32_t lten_get_memory_scope_stats(LMemoryScope *scope, int32_t device, LMemoryStats *stats) {
+  try {
+    if (!scope) throw lut::InvalidArgError("scope");
+    if (!stats) throw lut::InvalidArgError("stats");
+    toLMemoryStats(scope->scope.getStats(getDevice(device).getType()), stats);
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+int32_t lten_exit_memory_scope(LMemoryScope *scope) {
+  try {
+    if (!scope) throw lut::InvalidArgError("scope");
+    if (!scope->scope.isInnermost()) throw lut::InvalidArgError("scope is not the innermost one");
+    delete scope;
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+LSafeTensors *lten_open_safetensors(const char *filename) {
+  initLTen();
+
+  try {
+    if (!filename) throw lut::InvalidArgError("filename");
+
+    std::unique_ptr<LSafeTensors> st = std::make_unique<LSafeTensors>();
+    st->st = lten::SafeTensors::open(filename);
+    st->names = st->st->getNames();
+
+    return st.release();
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return nullptr;
+  }
+}
+
+int32_t lten_destroy_safetensors(LSafeTensors *st) {
+  try {
+    delete st;
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+int32_t lten_safetensors_get_num_tensors(LSafeTensors *st, int32_t *num_tensors) {
+  try {
+    if (!st) throw lut::InvalidArgError("st");
+    if (!num_tensors) throw lut::InvalidArgError("num_tensors");
+    *num_tensors = static_cast<int32_t>(st->names.size());
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+const char *lten_safetensors_get_name(LSafeTensors *st, int32_t index) {
+  try {
+    if (!st) throw lut::InvalidArgError("st");
+    if (index < 0 || index >= static_cast<int32_t>(st->names.size())) {
+      throw lut::InvalidArgError("index");
+    }
+
+    return st->names[index].c_str();
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return nullptr;
+  }
+}
+
+int32_t lten_safetensors_get_tensors(
+    LSafeTensors *st,
+    int32_t num_tensors,
+    const char *const *names,
+    int32_t dtype,
+    LTensor **tensors) {
+  try {
+    if (!st) throw lut::InvalidArgError("st");
+    if (num_tensors < 0) throw lut::InvalidArgError("num_tensors");
+    if (num_tensors && (!names || !tensors)) throw lut::InvalidArgError("names or tensors");
+
+    std::vector<std::string> namesl;
+    for (int32_t i = 0; i < num_tensors; ++i) {
+      if (!names[i]) throw lut::InvalidArgError("names");
+      namesl.emplace_back(names[i]);
+    }
+
+    DType dtypel = dtype ? getDType(dtype) : DType(DType::kUnknown);
+    std::vector<Tensor> tensorsl = st->st->getTensors(namesl, dtypel);
+
+    std::vector<std::unique_ptr<LTensor>> ltensors;
+    for (Tensor &tensorl : tensorsl) {
+      ltensors.emplace_back(std::make_unique<LTensor>());
+      ltensors.back()->tensorl = std::move(tensorl);
+    }
+    for (int32_t i = 0; i < num_tensors; ++i) {
+      tensors[i] = ltensors[i].release();
+    }
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
+int32_t lten_verify_model(const char *filename, int32_t use_cache, LVerifyResult *result) {
+  initLTen();
+
+  try {
+    if (!filename) throw lut::InvalidArgError("filename");
+    if (!result) throw lut::InvalidArgError("result");
+
+    lten::VerifyResult resultl = lten::verifyModel(filename, use_cache != 0);
+    result->num_verified = resultl.numVerified;
+    result->num_unchecked = resultl.numUnchecked;
+    result->cached = resultl.cached ? 1 : 0;
+
+    return 0;
+  } catch (const lut::Error &e) {
+    llmSetErrorMessage(e.what());
+    return static_cast<int32_t>(e.getCode());
+  }
+}
+
 LTensor *lten_apply_operator(
     LTensor *targ0,
     LTensor *targ1,
@@ -445,56 +799,65 @@ LTensor *lten_apply_operator(
     float farg1,
     int32_t op) {
   try {
+    bool moveTarg0 = (op & LTEN_OP_FLAG_MOVE_TARG0) != 0;
+    op &= ~LTEN_OP_FLAG_MOVE_TARG0;
+
     int numOperands = getLtenOpTensorOperandNum(op);
     if (numOperands >= 1 && !targ0) throw lut::InvalidArgError("targ0");
     if (numOperands >= 2 && !targ1) throw lut::InvalidArgError("targ1");
     if (numOperands >= 3 && !targ2) throw lut::InvalidArgError("targ2");
     if (numOperands >= 4 && !targ3) throw lut::InvalidArgError("targ3");
 
+    // targ0 is still read as another operand.
+    if (targ0 == targ1 || targ0 == targ2 || targ0 == targ3) moveTarg0 = false;
+
+    Tensor a0;
+    if (targ0) a0 = moveTarg0 ? std::move(targ0->tensorl) : targ0->tensorl;
+
     Tensor c;
     int iiarg0 = static_cast<int>(iarg0);
     switch (op) {
       case LTEN_OP_ADD:
-        c = F::add(targ0->tensorl, targ1->tensorl);
+        c = F::add(std::move(a0), targ1->tensorl);
         break;
       case LTEN_OP_MUL:
-        c = F::mul(targ0->tensorl, targ1->tensorl);
+        c = F::mul(std::move(a0), targ1->tensorl);
         break;
       case LTEN_OP_ROPE:
-        c = F::applyRotaryPosEmb(targ0->tensorl, targ1->tensorl);
+        c = F::applyRotaryPosEmb(std::move(a0), targ1->tensorl);
         break;
       case LTEN_OP_SOFTMAX:
-        c = F::softmax(targ0->tensorl);
+        c = F::softmax(std::move(a0));
         break;
       case LTEN_OP_GELU:
-        c = F::gelu(targ0->tensorl);
+        c = F::gelu(std::move(a0));
         break;
       case LTEN_OP_SWIGLU:
-        c = F::swiglu(targ0->tensorl);
+        c = F::swiglu(std::move(a0));
         break;
       case LTEN_OP_CONTIGUOUS:
-        c = F::contiguous(targ0->tensorl);
+        c = F::contiguous(std::move(a0));
         break;
       case LTEN_OP_SUM:
-        c = F::sum(targ0->tensorl, iiarg0);
+        c = F::sum(std::move(a0), iiarg0);
         break;
       case LTEN_OP_MAX:
-        c = F::max(targ0->tensorl, iiarg0);
+        c = F::max(std::move(a0), iiarg0);
         break;
       case LTEN_OP_MATMUL:
-        c = F::matmul(targ0->tensorl, targ1->tensorl);
+        c = F::matmul(std::move(a0), targ1->tensorl);
         break;
       case LTEN_OP_LOOKUP:
-        c = F::lookup(targ0->tensorl, targ1->tensorl);
+        c = F::lookup(std::move(a0), targ1->tensorl);
         break;
       case LTEN_OP_SCALAR_MUL:
-        c = F::mul(targ0->tensorl, farg0);
+        c = F::mul(std::move(a0), farg0);
         break;
       case LTEN_OP_LAYER_NORM:
-        c = F::layerNorm(targ0->tensorl, targ1->tensorl, targ2->tensorl, farg0);
+        c = F::layerNorm(std::move(a0), targ1->tensorl, targ2->tensorl, farg0);
         break;
       case LTEN_OP_RMS_NORM:
-        c = F::rmsNorm(targ0->tensorl, targ1->tensorl, farg0);
+        c = F::rmsNorm(std::move(a0), targ1->tensorl, farg0);
         break;
       default:
         throw lut::InvalidArgError(lut::sprintf("unsupported binary operator: %d", op));
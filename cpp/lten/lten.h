@@ -28,6 +28,13 @@ extern "C" {
 #endif  // __cplusplus
 
 typedef struct LTensor LTensor;
+typedef struct LArenaScope LArenaScope;
+typedef struct LMemoryScope LMemoryScope;
+typedef struct LSafeTensors LSafeTensors;
+
+/// @brief Releases the external memory `ptr` of a tensor, `ctx` is the context pointer passed to
+/// lten_new_tensor_from_ptr().
+typedef void (*LDeleter)(void *ptr, void *ctx);
 
 #define LTEN_ERR_INVALID_ARG 1
 
@@ -43,6 +50,42 @@ typedef struct LTensor LTensor;
 
 #define LTEN_RANGE_NONE -0x1000000000000000
 
+#define LTEN_HUGE_PAGE_DISABLED 0
+#define LTEN_HUGE_PAGE_TRANSPARENT 1
+#define LTEN_HUGE_PAGE_HUGETLB 2
+
+#define LTEN_NUMA_PARTITION_ROWS 1
+#define LTEN_NUMA_INTERLEAVE 2
+
+#define LTEN_MEMORY_HISTOGRAM_SIZE 16
+#define LTEN_MEMORY_SCOPE_NAME_SIZE 64
+
+/// @brief Memory counters of the tensor data. Bucket i of histogram counts the buffers with size in
+/// [2^i MB, 2^(i+1) MB), the last bucket also counts all the larger ones. peak_scope is the name
+/// of the innermost memory scope when peak_bytes was reached (truncated, always null-terminated).
+typedef struct LMemoryStats {
+  int64_t live_bytes;
+  int64_t peak_bytes;
+  int64_t num_allocs;
+  int64_t num_frees;
+  int64_t histogram[LTEN_MEMORY_HISTOGRAM_SIZE];
+  char peak_scope[LTEN_MEMORY_SCOPE_NAME_SIZE];
+} LMemoryStats;
+
+/// @brief Result of lten_verify_model(). num_verified is the number of tensor slots whose CRC-32C
+/// matched, num_unchecked is the number of slots without checksum. cached is 1 if the file was not
+/// read since its sidecar shows it was verified before.
+typedef struct LVerifyResult {
+  int64_t num_verified;
+  int64_t num_unchecked;
+  int32_t cached;
+} LVerifyResult;
+
+// OR-ed into the `op` of lten_apply_operator() to move the tensor of `targ0` into the operator.
+// `targ0` becomes empty and should only be destroyed. Element wise operators reuse the data as the
+// output when no other tensor shares it.
+#define LTEN_OP_FLAG_MOVE_TARG0 0x10000
+
 enum LynnOperator {
   LTEN_OP_ADD = 0,
   LTEN_OP_MUL = 1,
@@ -64,6 +107,19 @@ const char *lten_last_error_message();
 int32_t lten_destroy_tensor(LTensor *tensor);
 LTensor *lten_new_tensor(int32_t dim, const int64_t *shape, int32_t dtype, int32_t device);
 
+/// @brief Create a CPU tensor that borrows the external memory `ptr` without copying. `strides`
+/// is in number of elements, NULL for a contiguous tensor. Quantized dtypes are not supported.
+/// When the last tensor sharing the memory is destroyed, `deleter(ptr, ctx)` is called, if it is
+/// not NULL. The memory must stay valid until then. On failure, the deleter is not called.
+LTensor *lten_new_tensor_from_ptr(
+    int32_t dim,
+    const int64_t *shape,
+    const int64_t *strides,
+    int32_t dtype,
+    void *ptr,
+    LDeleter deleter,
+    void *ctx);
+
 int32_t lten_get_dim(LTensor *tensor, int32_t *dim);
 int32_t lten_get_shape(LTensor *tensor, int32_t dim, int64_t *size);
 int32_t lten_get_dtype(LTensor *tensor, int32_t *dtype);
@@ -84,6 +140,64 @@ int32_t lten_copy(LTensor *dest, LTensor *src);
 int32_t lten_fill_float(LTensor *tensor, float value);
 int32_t lten_print(LTensor *tensor);
 
+/// @brief Set the huge page policy (LTEN_HUGE_PAGE_*) of the CPU buffers not smaller than
+/// `min_size` bytes, like weights and KV cache blocks. Should be called before loading the model.
+/// Huge pages are disabled by default.
+int32_t lten_set_huge_page_policy(int32_t policy, int64_t min_size);
+
+/// @brief Get the number of huge pages: the reserved ones held by the CPU allocator plus the
+/// transparent huge pages of the whole process (not only the allocator).
+int32_t lten_get_num_huge_pages(int64_t *num_pages);
+
+/// @brief Place the data of a CPU tensor on the NUMA nodes. LTEN_NUMA_PARTITION_ROWS moves the rows
+/// of a 2D weight to the nodes of the threads computing them in GEMV, LTEN_NUMA_INTERLEAVE
+/// interleaves the pages over all nodes. It does nothing on single-node machines.
+int32_t lten_place_numa(LTensor *tensor, int32_t placement);
+
+/// @brief Enter an arena scope in current thread. CPU tensors created until the scope exits are
+/// allocated from a bump-pointer arena. Tensors still alive when the scope exits are promoted to
+/// regular memory. Scopes must be exited in the same thread and in reverse order of entering.
+LArenaScope *lten_enter_arena_scope();
+int32_t lten_exit_arena_scope(LArenaScope *scope);
+
+/// @brief Get the global memory counters of tensor data on `device`. The peak could be reset to
+/// the current live bytes by lten_reset_peak_memory_stats().
+int32_t lten_get_memory_stats(int32_t device, LMemoryStats *stats);
+int32_t lten_reset_peak_memory_stats(int32_t device);
+
+/// @brief Enter a named memory scope in current thread. Buffers allocated and freed by the thread
+/// until the scope exits are also counted in the scope. Scopes must be exited in the same thread
+/// and in reverse order of entering.
+LMemoryScope *lten_enter_memory_scope(const char *name);
+int32_t lten_get_memory_scope_stats(LMemoryScope *scope, int32_t device, LMemoryStats *stats);
+int32_t lten_exit_memory_scope(LMemoryScope *scope);
+
+/// @brief Open a safetensors file. The file is mapped and the tensors point into the mapping
+/// without copying, the mapping is kept alive by them after lten_destroy_safetensors().
+LSafeTensors *lten_open_safetensors(const char *filename);
+int32_t lten_destroy_safetensors(LSafeTensors *st);
+
+/// @brief Get the number of tensors and the name of tensor `index` in sorted order. The name is
+/// valid until `st` is destroyed.
+int32_t lten_safetensors_get_num_tensors(LSafeTensors *st, int32_t *num_tensors);
+const char *lten_safetensors_get_name(LSafeTensors *st, int32_t index);
+
+/// @brief Load the `num_tensors` tensors `names` concurrently into `tensors`. If `dtype` is not 0,
+/// the float tensors are converted to `dtype` (LTEN_DTYPE_FLOAT or LTEN_DTYPE_FLOAT16). BF16
+/// tensors are always converted, to float if `dtype` is 0. On failure, no tensor is returned.
+int32_t lten_safetensors_get_tensors(
+    LSafeTensors *st,
+    int32_t num_tensors,
+    const char *const *names,
+    int32_t dtype,
+    LTensor **tensors);
+
+/// @brief Verify the CRC-32C checksums of all the tensors in model file (zip) `filename` before
+/// loading it. If `use_cache` is not 0, a file recorded as verified in its sidecar
+/// "<filename>.verified" is skipped, and a newly verified file is recorded. Fails with the error
+/// message of the first corrupted tensor.
+int32_t lten_verify_model(const char *filename, int32_t use_cache, LVerifyResult *result);
+
 LTensor *lten_apply_operator(
     LTensor *targ0,
     LTensor *targ1,
@@ -0,0 +1,173 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/memory_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "lutil/error.h"
+#include "lutil/log.h"
+
+namespace lten {
+
+namespace {
+
+struct DeviceCounters {
+  std::atomic<int64_t> liveBytes;
+  std::atomic<int64_t> peakBytes;
+  std::atomic<int64_t> numAllocs;
+  std::atomic<int64_t> numFrees;
+  std::atomic<int64_t> histogram[MemoryStats::NumHistogramBuckets];
+
+  std::mutex peakScopeMutex;
+  std::string peakScope;
+
+  DeviceCounters()
+      : liveBytes(0),
+        peakBytes(0),
+        numAllocs(0),
+        numFrees(0) {
+    for (std::atomic<int64_t> &count : histogram) {
+      count.store(0);
+    }
+  }
+};
+
+// never destroyed since tensors may be destroyed after the static destructors.
+DeviceCounters *getDeviceCounters(Device::Type deviceType) {
+  static DeviceCounters *counters = new DeviceCounters[Device::NumDeviceType];
+
+  CHECK(deviceType >= 0 && deviceType < Device::NumDeviceType);
+  return &counters[deviceType];
+}
+
+thread_local MemoryScope *gCurrentScope = nullptr;
+
+}  // namespace
+
+MemoryStats::MemoryStats()
+    : liveBytes(0),
+      peakBytes(0),
+      numAllocs(0),
+      numFrees(0) {
+  std::fill(histogram, histogram + NumHistogramBuckets, 0);
+}
+
+int MemoryStats::getHistogramBucket(int64_t size) {
+  if (size < MinHistogramSize) return -1;
+
+  int bucket = 0;
+  for (int64_t n = size / MinHistogramSize; n > 1 && bucket < NumHistogramBuckets - 1; n /= 2) {
+    ++bucket;
+  }
+
+  return bucket;
+}
+
+MemoryStats getMemoryStats(Device::Type deviceType) {
+  DeviceCounters *counters = getDeviceCounters(deviceType);
+
+  MemoryStats stats;
+  stats.liveBytes = counters->liveBytes.load();
+  stats.peakBytes = counters->peakBytes.load();
+  stats.numAllocs = counters->numAllocs.load();
+  stats.numFrees = counters->numFrees.load();
+  for (int i = 0; i < MemoryStats::NumHistogramBuckets; ++i) {
+    stats.histogram[i] = counters->histogram[i].load();
+  }
+
+  std::lock_guard<std::mutex> lock(counters->peakScopeMutex);
+  stats.peakScope = counters->peakScope;
+
+  return stats;
+}
+
+void resetPeakMemoryStats(Device::Type deviceType) {
+  DeviceCounters *counters = getDeviceCounters(deviceType);
+  counters->peakBytes.store(counters->liveBytes.load());
+
+  std::lock_guard<std::mutex> lock(counters->peakScopeMutex);
+  counters->peakScope.clear();
+}
+
+void recordTensorDataAlloc(Device::Type deviceType, int64_t size) {
+  DeviceCounters *counters = getDeviceCounters(deviceType);
+  int bucket = MemoryStats::getHistogramBucket(size);
+
+  counters->numAllocs.fetch_add(1);
+  if (bucket >= 0) counters->histogram[bucket].fetch_add(1);
+
+  int64_t liveBytes = counters->liveBytes.fetch_add(size) + size;
+  int64_t peakBytes = counters->peakBytes.load();
+  while (liveBytes > peakBytes) {
+    if (counters->peakBytes.compare_exchange_weak(peakBytes, liveBytes)) {
+      std::lock_guard<std::mutex> lock(counters->peakScopeMutex);
+      counters->peakScope = gCurrentScope ? gCurrentScope->getName() : "";
+      break;
+    }
+  }
+
+  for (MemoryScope *scope = gCurrentScope; scope; scope = scope->_parent) {
+    MemoryStats &stats = scope->_stats[deviceType];
+    ++stats.numAllocs;
+    if (bucket >= 0) ++stats.histogram[bucket];
+
+    stats.liveBytes += size;
+    stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes);
+  }
+}
+
+void recordTensorDataFree(Device::Type deviceType, int64_t size) {
+  DeviceCounters *counters = getDeviceCounters(deviceType);
+  counters->numFrees.fetch_add(1);
+  counters->liveBytes.fetch_sub(size);
+
+  for (MemoryScope *scope = gCurrentScope; scope; scope = scope->_parent) {
+    MemoryStats &stats = scope->_stats[deviceType];
+    ++stats.numFrees;
+    stats.liveBytes -= size;
+  }
+}
+
+MemoryScope::MemoryScope(const std::string &name)
+    : _name(name),
+      _parent(gCurrentScope) {
+  gCurrentScope = this;
+}
+
+MemoryScope::~MemoryScope() {
+  if (!isInnermost()) {
+    LOG(ERROR) << "MemoryScope is not destroyed in the reverse order of creation.";
+  }
+
+  gCurrentScope = _parent;
+}
+
+const MemoryStats &MemoryScope::getStats(Device::Type deviceType) const {
+  CHECK(deviceType >= 0 && deviceType < Device::NumDeviceType);
+  return _stats[deviceType];
+}
+
+bool MemoryScope::isInnermost() const {
+  return gCurrentScope == this;
+}
+
+}  // namespace lten
@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+#include "lten/device.h"
+
+namespace lten {
+
+/// @brief Memory counters of the tensor data on one device.
+struct MemoryStats {
+  static constexpr int NumHistogramBuckets = 16;
+  static constexpr int64_t MinHistogramSize = 1048576;
+
+  /// @brief bytes of the tensor data currently alive.
+  int64_t liveBytes;
+
+  /// @brief the maximum of liveBytes since the start or the last resetPeakMemoryStats().
+  int64_t peakBytes;
+
+  /// @brief number of buffers allocated and freed, one for each slot of the tensor data.
+  int64_t numAllocs;
+  int64_t numFrees;
+
+  /// @brief histogram of the large allocations. Bucket i counts the buffers with size in
+  /// [MinHistogramSize * 2^i, MinHistogramSize * 2^(i+1)), the last bucket also counts all the
+  /// larger ones. Allocations smaller than MinHistogramSize are not counted.
+  int64_t histogram[NumHistogramBuckets];
+
+  /// @brief name of the innermost MemoryScope when peakBytes was reached, empty if there was no
+  /// scope. Not used in the stats of scopes.
+  std::string peakScope;
+
+  MemoryStats();
+
+  /// @brief Get the histogram bucket of an allocation of `size` bytes, -1 if not counted.
+  static int getHistogramBucket(int64_t size);
+};
+
+/// @brief Get the global memory counters of tensor data on device `deviceType`.
+MemoryStats getMemoryStats(Device::Type deviceType);
+
+/// @brief Reset the peak bytes of device `deviceType` to its current live bytes.
+void resetPeakMemoryStats(Device::Type deviceType);
+
+/// @brief Account a buffer of `size` bytes allocated or freed. Called by the TensorData
+/// implementations for each slot.
+void recordTensorDataAlloc(Device::Type deviceType, int64_t size);
+void recordTensorDataFree(Device::Type deviceType, int64_t size);
+
+/// @brief RAII scope that counts the buffers allocated and freed by current thread while it
+/// is alive, e.g. in a forward step or a layer. Scopes could be nested, an allocation is counted
+/// in all the active scopes of the thread. The name of the innermost scope is recorded with the
+/// global peak, so the scope that caused it could be found.
+class MemoryScope {
+ public:
+  MemoryScope(const std::string &name);
+  ~MemoryScope();
+
+  MemoryScope(const MemoryScope &) = delete;
+  MemoryScope &operator=(const MemoryScope &) = delete;
+
+  const std::string &getName() const {
+    return _name;
+  }
+
+  /// @brief Get the counters of this scope. liveBytes is the net bytes allocated in scope (could
+  /// be negative), peakBytes is the maximum of it.
+  const MemoryStats &getStats(Device::Type deviceType) const;
+
+  /// @brief Returns true if this is the innermost scope of current thread.
+  bool isInnermost() const;
+
+ private:
+  std::string _name;
+  MemoryStats _stats[Device::NumDeviceType];
+  MemoryScope *_parent;
+
+  friend void recordTensorDataAlloc(Device::Type deviceType, int64_t size);
+  friend void recordTensorDataFree(Device::Type deviceType, int64_t size);
+};
+
+}  // namespace lten
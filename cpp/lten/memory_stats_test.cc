@@ -0,0 +1,94 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/memory_stats.h"
+
+#include <thread>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "lten/arena.h"
+#include "lten/functional.h"
+
+namespace lten {
+
+CATCH_TEST_CASE("test MemoryStats histogram bucket", "[core][memory_stats]") {
+  constexpr int64_t MB = MemoryStats::MinHistogramSize;
+  CATCH_REQUIRE(MemoryStats::getHistogramBucket(MB - 1) == -1);
+  CATCH_REQUIRE(MemoryStats::getHistogramBucket(MB) == 0);
+  CATCH_REQUIRE(MemoryStats::getHistogramBucket(2 * MB - 1) == 0);
+  CATCH_REQUIRE(MemoryStats::getHistogramBucket(2 * MB) == 1);
+  CATCH_REQUIRE(MemoryStats::getHistogramBucket(5 * MB) == 2);
+  CATCH_REQUIRE(MemoryStats::getHistogramBucket(MB << 20) == MemoryStats::NumHistogramBuckets - 1);
+}
+
+CATCH_TEST_CASE("test MemoryScope", "[core][memory_stats]") {
+  Tensor x = F::zeros({16, 16}, DType::kFloat);
+
+  MemoryScope scope("outer");
+  const MemoryStats &stats = scope.getStats(Device::kCpu);
+  {
+    MemoryScope inner("inner");
+    Tensor y = F::zeros({512, 1024}, DType::kFloat);
+    CATCH_REQUIRE(inner.isInnermost());
+    CATCH_REQUIRE(!scope.isInnermost());
+    CATCH_REQUIRE(inner.getStats(Device::kCpu).liveBytes == 2 * 1048576);
+    CATCH_REQUIRE(inner.getStats(Device::kCpu).histogram[1] == 1);
+  }
+  CATCH_REQUIRE(scope.isInnermost());
+  CATCH_REQUIRE(stats.numAllocs == 1);
+  CATCH_REQUIRE(stats.numFrees == 1);
+  CATCH_REQUIRE(stats.liveBytes == 0);
+  CATCH_REQUIRE(stats.peakBytes == 2 * 1048576);
+
+  // free of the tensor created outside the scope.
+  x = Tensor();
+  CATCH_REQUIRE(stats.liveBytes == -16 * 16 * 4);
+
+  // allocations in other threads are not counted.
+  std::thread thread([]() { Tensor z = F::zeros({16, 16}, DType::kFloat); });
+  thread.join();
+  CATCH_REQUIRE(stats.numAllocs == 1);
+}
+
+CATCH_TEST_CASE("test global memory stats", "[core][memory_stats]") {
+  MemoryStats stats0 = getMemoryStats(Device::kCpu);
+  resetPeakMemoryStats(Device::kCpu);
+  {
+    MemoryScope scope("step");
+    Tensor x = F::zeros({1024, 1024}, DType::kFloat);
+    MemoryStats stats = getMemoryStats(Device::kCpu);
+    CATCH_REQUIRE(stats.liveBytes - stats0.liveBytes == 4 * 1048576);
+    CATCH_REQUIRE(stats.peakBytes == stats.liveBytes);
+    CATCH_REQUIRE(stats.peakScope == "step");
+    CATCH_REQUIRE(stats.histogram[2] - stats0.histogram[2] == 1);
+  }
+
+  // arena-backed tensor data is also counted.
+  {
+    ArenaScope arenaScope;
+    Tensor x = F::zeros({16, 16}, DType::kFloat);
+  }
+
+  MemoryStats stats = getMemoryStats(Device::kCpu);
+  CATCH_REQUIRE(stats.liveBytes == stats0.liveBytes);
+  CATCH_REQUIRE(stats.numAllocs - stats0.numAllocs == 2);
+  CATCH_REQUIRE(stats.numFrees - stats0.numFrees == 2);
+}
+
+}  // namespace lten
@@ -20,6 +20,101 @@
 #include "lten/mp.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
+#include <mutex>
 
-namespace lten {}  // namespace lten
+#include "lutil/log.h"
+#include "lutil/numa.h"
+#include "lutil/strings.h"
+
+namespace lten {
+
+namespace {
+
+std::vector<MP::NumaDomain> gNumaDomains;
+
+}  // namespace
+
+const std::vector<MP::NumaDomain> &MP::getNumaDomains() {
+  return gNumaDomains;
+}
+
+void MP::parallelForOrThrow(int64_t numBlocks, std::function<void(Context)> closure) {
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  parallelFor(numBlocks, [&closure, &errorMutex, &error](Context ctx) {
+    try {
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (error) return;
+      }
+
+      closure(ctx);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) error = std::current_exception();
+    }
+  });
+
+  if (error) std::rethrow_exception(error);
+}
+
+void MP::initNuma() {
+  int numThreads = getMaxThreads();
+  const std::vector<lut::NumaNode> &nodes = lut::getNumaNodes();
+  gNumaDomains = {NumaDomain{nodes.front().id, 0, numThreads}};
+  if (nodes.size() <= 1) return;
+
+  // number of threads of each node is proportional to its number of CPUs.
+  int64_t numCpus = 0;
+  for (const lut::NumaNode &node : nodes) {
+    numCpus += node.cpus.size();
+  }
+
+  std::vector<NumaDomain> domains;
+  int64_t cumCpus = 0;
+  for (const lut::NumaNode &node : nodes) {
+    NumaDomain domain;
+    domain.nodeId = node.id;
+    domain.threadBegin = static_cast<int>(numThreads * cumCpus / numCpus);
+    cumCpus += node.cpus.size();
+    domain.threadEnd = static_cast<int>(numThreads * cumCpus / numCpus);
+
+    if (domain.threadBegin == domain.threadEnd) {
+      LOG(INFO) << "too few threads for " << nodes.size() << " NUMA nodes, binding disabled.";
+      return;
+    }
+    domains.push_back(domain);
+  }
+
+  // thread 0 is the calling thread of the application, it is left unbound and keeps the CPU
+  // affinity of the application.
+  std::atomic<int> numFailed{0};
+  parallelForEachThread([&domains, &nodes, &numFailed](Context ctx) {
+    int threadIdx = ctx.getBlockIdx();
+    if (threadIdx == 0) return;
+
+    for (int i = 0; i < static_cast<int>(domains.size()); ++i) {
+      if (threadIdx >= domains[i].threadBegin && threadIdx < domains[i].threadEnd) {
+        if (!lut::bindCurrentThreadToCpus(nodes[i].cpus)) numFailed.fetch_add(1);
+      }
+    }
+  });
+  if (numFailed.load()) {
+    LOG(WARN) << "unable to bind threads to NUMA nodes, thread binding disabled.";
+    return;
+  }
+
+  gNumaDomains = domains;
+  for (const NumaDomain &domain : domains) {
+    LOG(INFO) << lut::sprintf(
+        "NUMA node %d: threads [%d, %d)",
+        domain.nodeId,
+        domain.threadBegin,
+        domain.threadEnd);
+  }
+}
+
+}  // namespace lten
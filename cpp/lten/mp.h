@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <functional>
+#include <vector>
 
 namespace lten {
 
@@ -28,32 +31,65 @@ class MP {
  public:
   class Partition;
   class Context;
+  struct NumaDomain;
 
   static void init();
   static void destroy();
   static int getMaxThreads();
 
+  /// @brief Get the NUMA domains of the worker threads. On multi-node machines, worker threads are
+  /// split into contiguous ranges, one for each node, and bound to the CPUs of that node. On
+  /// single-node machines, or when the binding failed, there is only one domain with all threads.
+  static const std::vector<NumaDomain> &getNumaDomains();
+
+  /// @brief apply the closure exactly once in each worker thread. The block index in context is
+  /// the thread index, so the work could be partitioned statically, like the rows placed on the
+  /// NUMA node of the thread.
+  static void parallelForEachThread(std::function<void(Context)> closure);
+
+  /// @brief Split [0, n) into `numBlocks` contiguous ranges of nearly equal size and get the
+  /// begin of range `blockIdx`.
+  static int64_t getPartitionBegin(int64_t n, int64_t blockIdx, int64_t numBlocks) {
+    return n * blockIdx / numBlocks;
+  }
+
   /// @brief split range into N parts and apply each part in the closure. N is the number of
   /// workers in the thread pool.
   /// @param numBlocks number of blocks.
   /// @param closure the closure. Since we need to invoke the closure multiple times, we use it
   /// by value here.
-  static void parallelFor(int numBlocks, std::function<void(Context)> closure);
+  static void parallelFor(int64_t numBlocks, std::function<void(Context)> closure);
+
+  /// @brief The same as parallelFor(), but the closure may throw. Exceptions never escape from the
+  /// worker threads: after the first one, the remaining blocks are skipped, then it is rethrown in
+  /// the calling thread.
+  static void parallelForOrThrow(int64_t numBlocks, std::function<void(Context)> closure);
+
+ private:
+  // split the threads into NUMA domains and bind them.
+  static void initNuma();
+};
+
+/// @brief Worker threads [threadBegin, threadEnd) running on NUMA node `nodeId`.
+struct MP::NumaDomain {
+  int nodeId;
+  int threadBegin;
+  int threadEnd;
 };
 
 /// @brief Store a partition info for a parallelFor function call.
 class MP::Context {
  public:
-  Context(int blockIdx, int numBlocks, int attachedThreadIdx)
+  Context(int64_t blockIdx, int64_t numBlocks, int attachedThreadIdx)
       : _blockIdx(blockIdx),
         _numBlocks(numBlocks),
         _attachedThreadIdx(attachedThreadIdx) {
   }
 
-  int getBlockIdx() const {
+  int64_t getBlockIdx() const {
     return _blockIdx;
   }
-  int getNumBlocks() const {
+  int64_t getNumBlocks() const {
     return _numBlocks;
   }
   int getAttachedThreadIdx() const {
@@ -61,8 +97,8 @@ class MP::Context {
   }
 
  private:
-  int _blockIdx;
-  int _numBlocks;
+  int64_t _blockIdx;
+  int64_t _numBlocks;
   int _attachedThreadIdx;
 };
 
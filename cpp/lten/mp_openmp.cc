@@ -34,6 +34,7 @@ namespace lten {
 
 void MP::init() {
   LOG(INFO) << "OMP max_threads = " << omp_get_max_threads();
+  initNuma();
 }
 
 void MP::destroy() {
@@ -43,11 +44,19 @@ int MP::getMaxThreads() {
   return omp_get_max_threads();
 }
 
-void MP::parallelFor(int numBlocks, std::function<void(Context)> closure) {
+void MP::parallelFor(int64_t numBlocks, std::function<void(Context)> closure) {
 #pragma omp parallel for num_threads(getMaxThreads()) schedule(dynamic, 1)
-  for (int i = 0; i < numBlocks; ++i) {
+  for (int64_t i = 0; i < numBlocks; ++i) {
     closure(Context(i, numBlocks, omp_get_thread_num()));
   }
 }
 
+void MP::parallelForEachThread(std::function<void(Context)> closure) {
+#pragma omp parallel num_threads(getMaxThreads())
+  {
+    int threadIdx = omp_get_thread_num();
+    closure(Context(threadIdx, omp_get_num_threads(), threadIdx));
+  }
+}
+
 }  // namespace lten
@@ -49,14 +49,14 @@ int MP::getMaxThreads() {
   return gThreadPoolMP->getNumThreads();
 }
 
-void MP::parallelFor2(int numBlocks, std::function<void(Context)> closure) {
+void MP::parallelFor2(int64_t numBlocks, std::function<void(Context)> closure) {
   CHECK(gThreadPoolMP) << "call MP::parallelFor() before MP::init()";
   int n = gThreadPoolMP->getNumThreads();
 
   std::atomic<int> numDone{0};
   for (int i = 0; i < n; ++i) {
     gThreadPoolMP->apply([numBlocks, closure, i, n, &numDone]() {
-      for (int j = i; j < numBlocks; j += n) {
+      for (int64_t j = i; j < numBlocks; j += n) {
         closure(Context(j, numBlocks, lut::ThreadPool::getThreadId()));
       }
       numDone.fetch_add(1);
@@ -79,7 +79,7 @@ OperatorTester OperatorTester::withTol(float rtol, float atol) {
   return tester;
 }
 
-bool OperatorTester::testToDevice(std::initializer_list<int> shape) {
+bool OperatorTester::testToDevice(std::initializer_list<Tensor::ShapeType> shape) {
   lut::Random random(MagicNumber);
   Tensor xr = F::rand(shape, DType::kFloat, Device::getCpu(), &random);
   Tensor x = _op->to(_testDevice, xr);
@@ -88,7 +88,7 @@ bool OperatorTester::testToDevice(std::initializer_list<int> shape) {
   return F::allClose(x, xr, _rtol);
 }
 
-bool OperatorTester::testCast(std::initializer_list<int> shape) {
+bool OperatorTester::testCast(std::initializer_list<Tensor::ShapeType> shape) {
   lut::Random random(MagicNumber);
   Tensor xr = F::rand(shape, DType::kFloat, Device::getCpu(), &random);
   Tensor x = _op->to(_testDevice, xr);
@@ -99,7 +99,7 @@ bool OperatorTester::testCast(std::initializer_list<int> shape) {
   return F::allClose(x, xr);
 }
 
-bool OperatorTester::testCopy(std::initializer_list<int> shape, bool transpose) {
+bool OperatorTester::testCopy(std::initializer_list<Tensor::ShapeType> shape, bool transpose) {
   lut::Random random(MagicNumber);
   Tensor tensor = F::rand(shape, DType::kFloat, Device::getCpu(), &random);
   Tensor x = _op->to(_testDevice, tensor);
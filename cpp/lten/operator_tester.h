@@ -27,7 +27,7 @@ namespace lten {
 
 class OperatorTester {
  public:
-  using ShapeType = std::initializer_list<int>;
+  using ShapeType = std::initializer_list<Tensor::ShapeType>;
 
   static constexpr uint32_t MagicNumber = 0x33;
   enum class OperatorType { Add, Mul, Softmax, Swiglu, Gelu };
@@ -40,9 +40,9 @@ class OperatorTester {
   OperatorTester withPrintBenchmarkInfo(bool isPrint);
   OperatorTester withTol(float rtol = 1e-4, float atol = 1e-5);
 
-  LUT_CHECK_RETURN bool testToDevice(std::initializer_list<int> shape);
-  LUT_CHECK_RETURN bool testCast(std::initializer_list<int> shape);
-  LUT_CHECK_RETURN bool testCopy(std::initializer_list<int> shape, bool transpose);
+  LUT_CHECK_RETURN bool testToDevice(std::initializer_list<Tensor::ShapeType> shape);
+  LUT_CHECK_RETURN bool testCast(std::initializer_list<Tensor::ShapeType> shape);
+  LUT_CHECK_RETURN bool testCopy(std::initializer_list<Tensor::ShapeType> shape, bool transpose);
   LUT_CHECK_RETURN bool testCopyLongType();
   LUT_CHECK_RETURN bool testCopy5D();
   LUT_CHECK_RETURN bool testLookup();
@@ -73,7 +73,7 @@ Tensor Operators::add(Tensor, Tensor) {
   NOT_IMPL();
 }
 
-Tensor Operators::tensor(lut::Span<const int>, DType) {
+Tensor Operators::tensor(lut::Span<const Tensor::ShapeType>, DType) {
   NOT_IMPL();
 }
 
@@ -81,7 +81,7 @@ Tensor Operators::tensorLike(Tensor) {
   NOT_IMPL();
 }
 
-Tensor Operators::zeros(lut::Span<const int>, DType) {
+Tensor Operators::zeros(lut::Span<const Tensor::ShapeType>, DType) {
   NOT_IMPL();
 }
 
@@ -145,7 +145,11 @@ Tensor Operators::logMelSpectrogram(Tensor) {
   NOT_IMPL();
 }
 
-Tensor Operators::rand(lut::Span<const int>, DType, lut::Random *, float, float) {
+Tensor Operators::varlenAttention(Tensor, Tensor, Tensor, Tensor, Tensor) {
+  NOT_IMPL();
+}
+
+Tensor Operators::rand(lut::Span<const Tensor::ShapeType>, DType, lut::Random *, float, float) {
   NOT_IMPL();
 }
 
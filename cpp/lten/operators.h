@@ -46,9 +46,9 @@ class Operators {
   virtual Tensor melFbank(Tensor input);
   virtual Tensor gelu(Tensor input);
   virtual void fill(Tensor input, float value);
-  virtual Tensor tensor(lut::Span<const int> shape, DType dtype);
+  virtual Tensor tensor(lut::Span<const Tensor::ShapeType> shape, DType dtype);
   virtual Tensor tensorLike(Tensor input);
-  virtual Tensor zeros(lut::Span<const int> shape, DType dtype);
+  virtual Tensor zeros(lut::Span<const Tensor::ShapeType> shape, DType dtype);
   virtual bool allClose(Tensor A, Tensor B, float rtol, float atol);
   virtual void print(Tensor tensor);
   virtual Tensor causalMask(int max_len);
@@ -60,8 +60,14 @@ class Operators {
   virtual void repetitionPenalty(Tensor logits, Tensor history, float weight);
   virtual Tensor cast(Tensor tensor, DType dtype);
   virtual Tensor logMelSpectrogram(Tensor wave);
+  virtual Tensor varlenAttention(
+      Tensor q,
+      Tensor k,
+      Tensor v,
+      Tensor cuSeqlensQ,
+      Tensor cuSeqlensK);
   virtual Tensor rand(
-      lut::Span<const int> shape,
+      lut::Span<const Tensor::ShapeType> shape,
       DType dtype,
       lut::Random *generator,
       float min,
@@ -0,0 +1,186 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/repack.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "lten/cpu/cpu_allocator.h"
+#include "lten/cpu/cpu_tensor_data.h"
+#include "lten/functional.h"
+#include "lten/tensor.h"
+#include "lutil/crc32.h"
+#include "lutil/error.h"
+#include "lutil/log.h"
+#include "lutil/reader.h"
+#include "lutil/strings.h"
+#include "lutil/zip_file.h"
+#include "lutil/zip_writer.h"
+
+namespace lten {
+
+namespace {
+
+constexpr int64_t CopyChunkSize = 1024 * 1024;
+
+template<typename T>
+void appendValue(std::string *buffer, T value) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+lut::Span<const int8_t> toSpan(const std::string &s) {
+  return lut::makeConstSpan(reinterpret_cast<const int8_t *>(s.data()), s.size());
+}
+
+bool isTensorEntry(const lut::ZipFile &zipFile, const std::string &name) {
+  if (zipFile.getFileSize(name) < 4) return false;
+  return zipFile.open(name)->readString(4) == "tnsr";
+}
+
+// only the weights of linear layers are converted, the 1D ones (biases, norms) are kept in float.
+bool shouldConvert(const Tensor &tensor, DType weightType) {
+  if (weightType == DType::kUnknown || tensor.getDType() == weightType) return false;
+  if (tensor.getDim() != 2 || !tensor.getDType().isFloat()) return false;
+
+  if (weightType.isQuantized()) {
+    return tensor.getShape(1) % weightType.getGroupSize() == 0;
+  } else {
+    return weightType.isFloat();
+  }
+}
+
+Tensor convert(Tensor tensor, DType weightType) {
+  // cast to quantized types is only implemented from float32.
+  if (weightType.isQuantized() && tensor.getDType() != DType::kFloat) {
+    tensor = F::cast(tensor, DType::kFloat);
+  }
+
+  return F::cast(tensor, weightType);
+}
+
+// write the entry in the format of Tensor::read(). The data of slot 0 is aligned to `alignment`.
+void writeTensorEntry(
+    lut::ZipWriter *writer,
+    const std::string &name,
+    const Tensor &tensor,
+    int alignment,
+    bool checksum) {
+  CHECK(tensor.isContiguous());
+  const TensorData *data = tensor.getDataObject();
+
+  std::string header = "tnsr";
+  appendValue<int16_t>(&header, static_cast<int16_t>(tensor.getDim()));
+  for (int d = 0; d < tensor.getDim(); ++d) {
+    if (tensor.getShape(d) > INT32_MAX) THROW(Aborted, "tensor too big.");
+    appendValue<int32_t>(&header, static_cast<int32_t>(tensor.getShape(d)));
+  }
+  header += "tdat";
+  appendValue<int32_t>(&header, data->getNumSlot());
+
+  // slot header: int16 dtype and int64 numel. Slot footer: int16 magic number and the optional
+  // uint32 checksum.
+  constexpr int64_t SlotHeaderSize = 10;
+  int64_t footerSize = checksum ? 6 : 2;
+  int64_t size = static_cast<int64_t>(header.size());
+  for (int i = 0; i < data->getNumSlot(); ++i) {
+    size += SlotHeaderSize + data->getSlot(i)->getSizeInBytes() + footerSize;
+  }
+
+  writer->beginEntry(name, size, static_cast<int64_t>(header.size()) + SlotHeaderSize, alignment);
+  writer->write(toSpan(header));
+  for (int i = 0; i < data->getNumSlot(); ++i) {
+    const SlotBase *slot = data->getSlot(i);
+
+    std::string slotHeader;
+    appendValue<int16_t>(&slotHeader, slot->getDType());
+    appendValue<int64_t>(&slotHeader, slot->getNumEl());
+    writer->write(toSpan(slotHeader));
+    lut::Span<const int8_t> slotData = lut::makeConstSpan(
+        reinterpret_cast<const int8_t *>(slot->getRawData()),
+        slot->getSizeInBytes());
+    writer->write(slotData);
+
+    std::string footer;
+    if (checksum) {
+      appendValue<int16_t>(&footer, op::cpu::CpuTensorData::SlotMagicCrc32c);
+      appendValue<uint32_t>(&footer, lut::crc32c(slotData));
+    } else {
+      appendValue<int16_t>(&footer, op::cpu::CpuTensorData::SlotMagic);
+    }
+    writer->write(toSpan(footer));
+  }
+  writer->endEntry();
+}
+
+void copyEntry(lut::ZipWriter *writer, const lut::ZipFile &zipFile, const std::string &name) {
+  int64_t size = zipFile.getFileSize(name);
+  std::shared_ptr<lut::Reader> reader = zipFile.open(name);
+  std::vector<int8_t> buffer(std::min(size, CopyChunkSize));
+
+  writer->beginEntry(name, size);
+  for (int64_t pos = 0; pos < size; pos += CopyChunkSize) {
+    lut::Span<int8_t> chunk = lut::makeSpan(buffer).subspan(0, std::min(CopyChunkSize, size - pos));
+    reader->readSpan(chunk);
+    writer->write(lut::makeConstSpan(chunk.data(), chunk.size()));
+  }
+  writer->endEntry();
+}
+
+}  // namespace
+
+void repackModel(
+    const std::string &input,
+    const std::string &output,
+    const RepackOptions &options) {
+  constexpr int MinAlignment = static_cast<int>(op::cpu::CpuAllocator::Alignment);
+  constexpr int MaxAlignment = 4096;
+  if (options.alignment <= 0 || options.alignment % MinAlignment != 0 ||
+      options.alignment > MaxAlignment) {
+    THROW(
+        Aborted,
+        lut::sprintf(
+            "alignment should be a multiple of %d and not larger than %d, but got %d.",
+            MinAlignment,
+            MaxAlignment,
+            options.alignment));
+  }
+
+  std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(input);
+  std::unique_ptr<lut::ZipWriter> writer = lut::ZipWriter::create(output);
+  for (const std::string &name : zipFile->getList()) {
+    if (!isTensorEntry(*zipFile, name)) {
+      copyEntry(writer.get(), *zipFile, name);
+      continue;
+    }
+
+    Tensor tensor = readTensor(*zipFile, name);
+    if (shouldConvert(tensor, options.weightType)) {
+      LOG(INFO) << "convert " << name << " from " << tensor.getDType().toString() << " to "
+                << options.weightType.toString();
+      tensor = convert(tensor, options.weightType);
+    }
+    writeTensorEntry(writer.get(), name, tensor, options.alignment, options.checksum);
+  }
+
+  writer->close();
+}
+
+}  // namespace lten
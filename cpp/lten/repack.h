@@ -0,0 +1,54 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <string>
+
+#include "lten/dtype.h"
+
+namespace lten {
+
+/// @brief Options of repackModel().
+struct RepackOptions {
+  /// @brief If not DType::kUnknown, the 2D float weights are converted (e.g. quantized to
+  /// DType::kQInt4x32) offline, so no conversion is needed at load time.
+  DType weightType = DType::kUnknown;
+
+  /// @brief Alignment in bytes of the tensor data in the output file. It should be a multiple of
+  /// the CPU allocator alignment, then the loader maps the data in place instead of copying it. At
+  /// most 4096 (a page), since the padding is stored in the 16-bit extra field of zip entries.
+  int alignment = 64;
+
+  /// @brief If true, the data of each tensor slot is followed by its CRC-32C, which is checked by
+  /// verifyModel(). Loaders older than the checksum footer could not read such files.
+  bool checksum = true;
+};
+
+/// @brief Rewrite the model file (zip) `input` into `output` in the layout that the CPU backend
+/// loads without any work: the tensor data is stored in its final dtype and aligned in the file,
+/// so Tensor::read() points to the mapped file directly. The entries other than tensors are
+/// copied as-is. Without `options.checksum`, the output file is readable by any version of the
+/// loader.
+/// @param input the input model file.
+/// @param output the output model file.
+/// @param options the repack options.
+void repackModel(const std::string &input, const std::string &output, const RepackOptions &options);
+
+}  // namespace lten
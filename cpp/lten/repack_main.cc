@@ -0,0 +1,85 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// lten_repack: rewrite a model file into the layout loaded in place by the CPU backend. Example:
+//   lten_repack -i model.llmpkg -o model.q4.llmpkg -dtype q4
+
+#include <stdio.h>
+
+#include <string>
+
+#include "lten/dtype.h"
+#include "lten/operators.h"
+#include "lten/repack.h"
+#include "lutil/error.h"
+#include "lutil/flags.h"
+#include "lutil/strings.h"
+
+namespace {
+
+lten::DType parseDType(const std::string &name) {
+  if (name.empty()) return lten::DType::kUnknown;
+  if (name == "q4") return lten::DType::kQInt4x32;
+  if (name == "float16") return lten::DType::kFloat16;
+  if (name == "float32") return lten::DType::kFloat;
+
+  throw lut::InvalidArgError(lut::sprintf("unsupported dtype: %s", name));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string inputFile;
+  std::string outputFile;
+  std::string dtype;
+  std::string alignment = "64";
+  std::string checksum = "crc32c";
+
+  lut::Flags flags("Usage: lten_repack -i <input> -o <output> [-dtype q4|float16|float32]");
+  flags.define("-i", &inputFile, "the input model file.");
+  flags.define("-o", &outputFile, "the output model file.");
+  flags.define("-dtype", &dtype, "convert the 2D float weights to this type. Keep it if empty.");
+  flags.define("-align", &alignment, "alignment in bytes of the tensor data, up to 4096.");
+  flags.define("-checksum", &checksum, "checksum of the tensor data: crc32c (default) or none.");
+
+  try {
+    flags.parse(argc - 1, argv + 1);
+    if (inputFile.empty() || outputFile.empty()) {
+      flags.printUsage();
+      return 1;
+    }
+
+    lten::RepackOptions options;
+    options.weightType = parseDType(dtype);
+    options.alignment = lut::parseInt(alignment);
+    if (checksum != "crc32c" && checksum != "none") {
+      throw lut::InvalidArgError(lut::sprintf("unsupported checksum: %s", checksum));
+    }
+    options.checksum = checksum == "crc32c";
+
+    lten::initOperators();
+    lten::repackModel(inputFile, outputFile, options);
+    lten::destroyOperators();
+  } catch (const lut::Error &e) {
+    fprintf(stderr, "error: %s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/repack.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/functional.h"
+#include "lten/test_helper.h"
+#include "lutil/error.h"
+#include "lutil/path.h"
+#include "lutil/reader.h"
+#include "lutil/zip_file.h"
+
+namespace lten {
+
+namespace {
+
+const char *ConfigData = "[model]\ntype=test\n";
+
+template<typename T>
+void appendValue(std::string *buffer, T value) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// append a stored zip entry without extra field.
+void appendZipEntry(std::string *buffer, const std::string &name, const std::string &data) {
+  appendValue<uint32_t>(buffer, 0x04034b50);
+  appendValue<uint16_t>(buffer, 10);  // version
+  appendValue<uint16_t>(buffer, 0);   // flag
+  appendValue<uint16_t>(buffer, 0);   // compression
+  appendValue<uint32_t>(buffer, 0);   // last modify time and date
+  appendValue<uint32_t>(buffer, 0);   // crc32
+  appendValue<uint32_t>(buffer, static_cast<uint32_t>(data.size()));
+  appendValue<uint32_t>(buffer, static_cast<uint32_t>(data.size()));
+  appendValue<uint16_t>(buffer, static_cast<uint16_t>(name.size()));
+  appendValue<uint16_t>(buffer, 0);
+  *buffer += name;
+  *buffer += data;
+}
+
+bool isBitwiseEqual(Tensor a, Tensor b) {
+  if (a.getDType() != b.getDType() || a.getShape() != b.getShape()) return false;
+
+  const SlotBase *slotA = a.getDataObject()->getSlot(0);
+  const SlotBase *slotB = b.getDataObject()->getSlot(0);
+  return slotA->getSizeInBytes() == slotB->getSizeInBytes() &&
+         memcmp(slotA->getRawData(), slotB->getRawData(), slotA->getSizeInBytes()) == 0;
+}
+
+Tensor readFromFile(const lut::ZipFile &zipFile, const std::string &name) {
+  Tensor tensor = readTensor(zipFile, name);
+
+  // the repacked tensors are mapped in place.
+  CATCH_REQUIRE(tensor.getDataObject()->isExternal());
+  return tensor;
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("test repack model", "[core][repack]") {
+  lut::Path dirname = lut::Path::currentExecutablePath().dirname();
+  std::string inputFile = (dirname / "test_repack_in.zip").string();
+  std::string outputFile = (dirname / "test_repack_out.zip").string();
+
+  // the linear weight, and the one could not be quantized by groups of 32.
+  Tensor w = F::rand({16, 64}, DType::kFloat);
+  Tensor b = F::rand({8, 20}, DType::kFloat);
+
+  // misaligned in the input file.
+  std::string zipData;
+  appendTensorZipEntry(&zipData, "w.tensor", w, 4);
+  appendZipEntry(&zipData, "config.ini", ConfigData);
+  appendTensorZipEntry(&zipData, "b.tensor", b, 12);
+  writeFile(inputFile, zipData);
+
+  CATCH_SECTION("keep dtype") {
+    repackModel(inputFile, outputFile, RepackOptions());
+
+    std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(outputFile);
+    CATCH_REQUIRE(isBitwiseEqual(readFromFile(*zipFile, "w.tensor"), w));
+    CATCH_REQUIRE(isBitwiseEqual(readFromFile(*zipFile, "b.tensor"), b));
+
+    std::shared_ptr<lut::Reader> reader = zipFile->open("config.ini");
+    CATCH_REQUIRE(zipFile->getFileSize("config.ini") == static_cast<int64_t>(strlen(ConfigData)));
+    CATCH_REQUIRE(reader->readString(strlen(ConfigData)) == ConfigData);
+  }
+
+  CATCH_SECTION("quantize to q4") {
+    RepackOptions options;
+    options.weightType = DType::kQInt4x32;
+    options.alignment = 128;
+    repackModel(inputFile, outputFile, options);
+
+    std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(outputFile);
+    Tensor qw = readFromFile(*zipFile, "w.tensor");
+    CATCH_REQUIRE(qw.getDType() == DType::kQInt4x32);
+    CATCH_REQUIRE(isBitwiseEqual(qw, F::cast(w, DType::kQInt4x32)));
+    CATCH_REQUIRE(isBitwiseEqual(readFromFile(*zipFile, "b.tensor"), b));
+
+    // repacking the repacked file changes nothing.
+    std::string outputFile2 = (dirname / "test_repack_out2.zip").string();
+    repackModel(outputFile, outputFile2, options);
+    zipFile = lut::ZipFile::fromFile(outputFile2);
+    CATCH_REQUIRE(isBitwiseEqual(readFromFile(*zipFile, "w.tensor"), qw));
+  }
+
+  CATCH_SECTION("invalid alignment") {
+    RepackOptions options;
+    options.alignment = 48;
+    CATCH_REQUIRE_THROWS_AS(repackModel(inputFile, outputFile, options), lut::AbortedError);
+
+    options.alignment = 65536;
+    CATCH_REQUIRE_THROWS_AS(repackModel(inputFile, outputFile, options), lut::AbortedError);
+  }
+}
+
+}  // namespace lten
@@ -0,0 +1,222 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/safetensors.h"
+
+#include <string.h>
+
+#include "lten/cpu/arena.h"
+#include "lten/cpu/cpu_tensor_data.h"
+#include "lten/functional.h"
+#include "lten/mp.h"
+#include "lutil/error.h"
+#include "lutil/mapped_file.h"
+#include "lutil/strings.h"
+#include "nlohmann/json.hpp"
+
+namespace lten {
+
+namespace {
+
+// the header is a JSON string, limit its size to reject the corrupted files early.
+constexpr int64_t MaxHeaderSize = 100 * 1024 * 1024;
+
+// returns DType::kUnknown for the BF16 and unsupported dtypes.
+DType getDType(const std::string &name) {
+  if (name == "F32") return DType::kFloat;
+  if (name == "F16") return DType::kFloat16;
+  if (name == "I64") return DType::kLong;
+  if (name == "I8") return DType::kInt8;
+  if (name == "U8") return DType::kUInt8;
+
+  return DType::kUnknown;
+}
+
+// returns 0 for the unknown dtypes, like the FP8 ones. They are rejected in getTensor().
+int getElementSize(const std::string &name) {
+  if (name == "F64" || name == "I64" || name == "U64") return 8;
+  if (name == "F32" || name == "I32" || name == "U32") return 4;
+  if (name == "F16" || name == "BF16" || name == "I16" || name == "U16") return 2;
+  if (name == "I8" || name == "U8" || name == "BOOL") return 1;
+
+  return 0;
+}
+
+// bfloat16 is the upper half of float32.
+Tensor bfloat16ToFloat(const TensorShape &shape, const uint16_t *data) {
+  int64_t numel = shape.getNumEl();
+  std::shared_ptr<TensorData> tensorData = op::cpu::CpuTensorData::create(numel, DType::kFloat);
+
+  float *dest = tensorData->getData<float>();
+  for (int64_t i = 0; i < numel; ++i) {
+    uint32_t bits = static_cast<uint32_t>(data[i]) << 16;
+    memcpy(&dest[i], &bits, sizeof(float));
+  }
+
+  return Tensor::create(shape, tensorData);
+}
+
+}  // namespace
+
+SafeTensors::SafeTensors()
+    : _dataOffset(0) {
+}
+
+std::shared_ptr<SafeTensors> SafeTensors::open(const std::string &filename) {
+  std::shared_ptr<SafeTensors> st{new SafeTensors()};
+  st->_file = lut::MappedFile::open(filename);
+
+  // 8 bytes of little-endian header size, the header, then the data.
+  lut::Span<const int8_t> data = st->_file->getData();
+  uint64_t headerSize = 0;
+  if (data.size() < sizeof(headerSize)) THROW(Aborted, "invalid safetensors file.");
+  memcpy(&headerSize, data.data(), sizeof(headerSize));
+
+  int64_t fileSize = static_cast<int64_t>(data.size());
+  if (headerSize > MaxHeaderSize || 8 + static_cast<int64_t>(headerSize) > fileSize) {
+    THROW(Aborted, "invalid header size of safetensors file.");
+  }
+
+  st->_dataOffset = 8 + headerSize;
+  st->parseHeader(std::string(reinterpret_cast<const char *>(data.data()) + 8, headerSize));
+  for (const auto &it : st->_tensors) {
+    if (st->_dataOffset + it.second.end > fileSize) {
+      THROW(Aborted, lut::sprintf("data of tensor %s out of range.", it.first));
+    }
+  }
+
+  return st;
+}
+
+void SafeTensors::parseHeader(const std::string &header) {
+  try {
+    nlohmann::json json = nlohmann::json::parse(header);
+    if (!json.is_object()) THROW(Aborted, "invalid safetensors header.");
+
+    for (auto it = json.begin(); it != json.end(); ++it) {
+      if (it.key() == "__metadata__") continue;
+
+      const nlohmann::json &value = it.value();
+      TensorInfo info;
+      info.dtype = value.at("dtype").get<std::string>();
+      info.shape = value.at("shape").get<std::vector<int64_t>>();
+
+      std::vector<int64_t> offsets = value.at("data_offsets").get<std::vector<int64_t>>();
+      if (offsets.size() != 2) THROW(Aborted, "invalid data_offsets.");
+      info.begin = offsets[0];
+      info.end = offsets[1];
+
+      int64_t numel = 1;
+      for (int64_t size : info.shape) {
+        if (size < 0 || size > TensorData::MaxNumEl) THROW(Aborted, "invalid shape.");
+        numel *= size;
+        if (numel > TensorData::MaxNumEl) THROW(Aborted, "tensor too big.");
+      }
+      int elementSize = getElementSize(info.dtype);
+      if (info.begin < 0 || info.end < info.begin ||
+          (elementSize && info.end - info.begin != numel * elementSize)) {
+        THROW(Aborted, lut::sprintf("tensor %s size mismatch.", it.key()));
+      }
+
+      _tensors[it.key()] = std::move(info);
+    }
+  } catch (const nlohmann::json::exception &e) {
+    THROW(Aborted, lut::sprintf("failed to parse safetensors header: %s", e.what()));
+  }
+}
+
+std::vector<std::string> SafeTensors::getNames() const {
+  std::vector<std::string> names;
+  for (const auto &it : _tensors) {
+    names.push_back(it.first);
+  }
+
+  return names;
+}
+
+bool SafeTensors::contains(const std::string &name) const {
+  return _tensors.find(name) != _tensors.end();
+}
+
+Tensor SafeTensors::getTensor(const std::string &name, DType dtype) const {
+  if (dtype != DType::kUnknown && !dtype.isFloat()) {
+    THROW(Aborted, lut::sprintf("unsupported dtype to convert: %s", dtype.toString()));
+  }
+
+  auto it = _tensors.find(name);
+  if (it == _tensors.end()) {
+    THROW(Aborted, lut::sprintf("tensor \"%s\" not exist in safetensors.", name));
+  }
+
+  const TensorInfo &info = it->second;
+  if (info.begin == info.end) THROW(Aborted, lut::sprintf("tensor %s is empty.", name));
+
+  // scalars are loaded as 1D tensors.
+  std::vector<Tensor::ShapeType> shapeData(info.shape.begin(), info.shape.end());
+  if (shapeData.empty()) shapeData.push_back(1);
+  if (shapeData.size() > TensorShape::MaxDim) THROW(Aborted, "too many dimensions.");
+  TensorShape shape(lut::makeConstSpan(shapeData));
+
+  op::cpu::NoArenaScope noArenaScope;
+  const int8_t *data = _file->getData().data() + _dataOffset + info.begin;
+
+  Tensor tensor;
+  DType srcType = getDType(info.dtype);
+  if (info.dtype == "BF16") {
+    tensor = bfloat16ToFloat(shape, reinterpret_cast<const uint16_t *>(data));
+  } else if (srcType == DType::kUnknown) {
+    THROW(Aborted, lut::sprintf("unsupported dtype in safetensors: %s", info.dtype));
+  } else if (reinterpret_cast<uintptr_t>(data) % getElementSize(info.dtype) == 0) {
+    // holds the mapping until the tensor data is destroyed.
+    std::shared_ptr<lut::MappedFile> file = _file;
+    std::shared_ptr<TensorData> tensorData = op::cpu::CpuTensorData::createFromPtr(
+        shape.getNumEl(),
+        srcType,
+        reinterpret_cast<Byte *>(const_cast<int8_t *>(data)),
+        [file]() {});
+    tensor = Tensor::create(shape, tensorData);
+  } else {
+    // the offsets in a valid safetensors file are aligned, copy the data for the others.
+    std::shared_ptr<TensorData> tensorData = op::cpu::CpuTensorData::create(
+        shape.getNumEl(),
+        srcType);
+    memcpy(tensorData->getData<void>(), data, info.end - info.begin);
+    tensor = Tensor::create(shape, tensorData);
+  }
+
+  if (dtype != DType::kUnknown && tensor.getDType().isFloat() && tensor.getDType() != dtype) {
+    tensor = F::cast(tensor, dtype);
+  }
+
+  return tensor;
+}
+
+std::vector<Tensor> SafeTensors::getTensors(
+    lut::Span<const std::string> names,
+    DType dtype) const {
+  std::vector<Tensor> tensors(names.size());
+  MP::parallelForOrThrow(names.size(), [this, names, dtype, &tensors](MP::Context ctx) {
+    int64_t i = ctx.getBlockIdx();
+    tensors[i] = getTensor(names[i], dtype);
+  });
+
+  return tensors;
+}
+
+}  // namespace lten
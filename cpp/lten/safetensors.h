@@ -0,0 +1,94 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lten/dtype.h"
+#include "lten/tensor.h"
+#include "lutil/span.h"
+
+namespace lut {
+class MappedFile;
+}  // namespace lut
+
+namespace lten {
+
+/// @brief Reader of the safetensors file (https://github.com/huggingface/safetensors). The file is
+/// mapped into memory and the tensors point to the mapping directly, so no data is read or copied
+/// until it is accessed. The mapping is kept alive by the tensors, it is safe to destroy the
+/// SafeTensors object after getting them.
+///
+///   std::shared_ptr<SafeTensors> st = SafeTensors::open("model.safetensors");
+///   Tensor w = st->getTensor("model.embed_tokens.weight");
+///
+/// F32, F16, I64, I8 and U8 tensors are zero-copy. BF16 tensors have no counterpart in DType,
+/// they are converted to float (or `dtype`) when loading.
+class SafeTensors {
+ public:
+  /// @brief Open the safetensors file and parse its header. Throw AbortedError if failed.
+  /// @param filename the safetensors file.
+  static std::shared_ptr<SafeTensors> open(const std::string &filename);
+
+  /// @brief Get the names of all tensors in sorted order.
+  std::vector<std::string> getNames() const;
+
+  /// @brief Returns true if tensor `name` exists.
+  bool contains(const std::string &name) const;
+
+  /// @brief Get the tensor `name`. Its data is allocated outside the arena of current thread.
+  /// @param name name of the tensor.
+  /// @param dtype if not DType::kUnknown, the float tensors are converted to `dtype` (float or
+  /// float16) when loading. The integer tensors are kept as-is.
+  /// @return the tensor.
+  Tensor getTensor(const std::string &name, DType dtype = DType::kUnknown) const;
+
+  /// @brief Get the tensors `names` concurrently on the worker threads, it is faster than
+  /// getTensor() one by one when the tensors are converted.
+  /// @param names names of the tensors.
+  /// @param dtype the same as getTensor().
+  /// @return the tensors in the same order as `names`.
+  std::vector<Tensor> getTensors(
+      lut::Span<const std::string> names,
+      DType dtype = DType::kUnknown) const;
+
+ private:
+  struct TensorInfo {
+    std::string dtype;
+    std::vector<int64_t> shape;
+    int64_t begin;
+    int64_t end;
+  };
+
+  std::shared_ptr<lut::MappedFile> _file;
+  std::map<std::string, TensorInfo> _tensors;
+  int64_t _dataOffset;
+
+  SafeTensors();
+
+  void parseHeader(const std::string &header);
+};
+
+}  // namespace lten
@@ -0,0 +1,181 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/safetensors.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/functional.h"
+#include "lten/test_helper.h"
+#include "lutil/error.h"
+#include "lutil/strings.h"
+
+namespace lten {
+
+namespace {
+
+// builder of the safetensors file in test.
+class SafeTensorsBuilder {
+ public:
+  void add(
+      const std::string &name,
+      const std::string &dtype,
+      Tensor::ShapeType rows,
+      Tensor::ShapeType cols,
+      const void *data,
+      int64_t size) {
+    if (!_header.empty()) _header += ",";
+    _header += lut::sprintf(
+        "\"%s\":{\"dtype\":\"%s\",\"shape\":[%d,%d],\"data_offsets\":[%d,%d]}",
+        name,
+        dtype,
+        rows,
+        cols,
+        _data.size(),
+        _data.size() + size);
+    _data.append(reinterpret_cast<const char *>(data), size);
+  }
+
+  void addPadding(int n) {
+    _data.append(n, '\0');
+  }
+
+  std::string build() const {
+    // the header is padded with spaces to 8 bytes, like the files from huggingface.
+    std::string header = "{\"__metadata__\":{\"format\":\"pt\"}," + _header + "}";
+    header.append((8 - header.size() % 8) % 8, ' ');
+
+    std::string file;
+    appendValue<uint64_t>(&file, header.size());
+    file += header;
+    file += _data;
+    return file;
+  }
+
+ private:
+  std::string _header;
+  std::string _data;
+};
+
+}  // namespace
+
+CATCH_TEST_CASE("test SafeTensors", "[core][safetensors]") {
+  Tensor a = F::rand({16, 32}, DType::kFloat);
+  Tensor b = F::cast(F::rand({8, 16}, DType::kFloat), DType::kFloat16);
+  Tensor c = F::rand({4, 8}, DType::kFloat);
+  Tensor d = F::rand({4, 8}, DType::kFloat);
+
+  // bfloat16 of `c` and the float32 it represents.
+  std::vector<uint16_t> cBf16;
+  Tensor cRef = F::tensorLike(c);
+  for (int64_t i = 0; i < c.getNumEl(); ++i) {
+    uint32_t bits;
+    memcpy(&bits, c.getData<float>() + i, sizeof(float));
+    cBf16.push_back(static_cast<uint16_t>(bits >> 16));
+
+    bits = static_cast<uint32_t>(cBf16.back()) << 16;
+    memcpy(cRef.getData<float>() + i, &bits, sizeof(float));
+  }
+
+  SafeTensorsBuilder builder;
+  builder.add("a", "F32", 16, 32, a.getData<float>(), 16 * 32 * 4);
+  builder.add("b", "F16", 8, 16, b.getData<Float16>(), 8 * 16 * 2);
+  builder.add("c", "BF16", 4, 8, cBf16.data(), 4 * 8 * 2);
+
+  // misaligned, it is copied.
+  builder.addPadding(2);
+  builder.add("d", "F32", 4, 8, d.getData<float>(), 4 * 8 * 4);
+  builder.add("e", "F8_E4M3", 4, 8, cBf16.data(), 4 * 8);
+
+  std::string filename = getTestFilePath("test.safetensors");
+  writeFile(filename, builder.build());
+
+  std::shared_ptr<SafeTensors> st = SafeTensors::open(filename);
+  CATCH_REQUIRE(st->getNames() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+  CATCH_REQUIRE(st->contains("a"));
+  CATCH_REQUIRE(!st->contains("f"));
+
+  Tensor x = st->getTensor("a");
+  CATCH_REQUIRE(x.getDataObject()->isExternal());
+  CATCH_REQUIRE(F::allClose(x, a));
+
+  x = st->getTensor("b");
+  CATCH_REQUIRE(x.getDType() == DType::kFloat16);
+  CATCH_REQUIRE(x.getDataObject()->isExternal());
+  CATCH_REQUIRE(allCloseAsFloat(x, b));
+
+  x = st->getTensor("c");
+  CATCH_REQUIRE(x.getDType() == DType::kFloat);
+  CATCH_REQUIRE(F::allClose(x, cRef));
+
+  x = st->getTensor("d");
+  CATCH_REQUIRE(!x.getDataObject()->isExternal());
+  CATCH_REQUIRE(F::allClose(x, d));
+
+  // cast on load, and the tensors outlive the SafeTensors object.
+  std::vector<std::string> names = {"a", "b", "c"};
+  std::vector<Tensor> tensors = st->getTensors(names, DType::kFloat16);
+  st = nullptr;
+  CATCH_REQUIRE(tensors[0].getDType() == DType::kFloat16);
+  CATCH_REQUIRE(allCloseAsFloat(tensors[0], a));
+  CATCH_REQUIRE(tensors[1].getDataObject()->isExternal());
+  CATCH_REQUIRE(allCloseAsFloat(tensors[1], b));
+  CATCH_REQUIRE(allCloseAsFloat(tensors[2], cRef));
+
+  st = SafeTensors::open(filename);
+  CATCH_REQUIRE_THROWS_AS(st->getTensor("e"), lut::AbortedError);
+  CATCH_REQUIRE_THROWS_AS(st->getTensor("f"), lut::AbortedError);
+  CATCH_REQUIRE_THROWS_AS(st->getTensor("a", DType::kQInt4x32), lut::AbortedError);
+  CATCH_REQUIRE_THROWS_AS(st->getTensors(names, DType::kQInt4x32), lut::AbortedError);
+
+  st = nullptr;
+  remove(filename.c_str());
+}
+
+CATCH_TEST_CASE("test SafeTensors invalid file", "[core][safetensors]") {
+  std::string filename = getTestFilePath("test_invalid.safetensors");
+
+  float data[4] = {0};
+  SafeTensorsBuilder builder;
+  builder.add("a", "F32", 2, 2, data, sizeof(data));
+  std::string file = builder.build();
+
+  // truncated data.
+  writeFile(filename, file.substr(0, file.size() - 4));
+  CATCH_REQUIRE_THROWS_AS(SafeTensors::open(filename), lut::AbortedError);
+
+  // invalid header.
+  std::string invalidHeader = file;
+  invalidHeader[8] = '[';
+  writeFile(filename, invalidHeader);
+  CATCH_REQUIRE_THROWS_AS(SafeTensors::open(filename), lut::AbortedError);
+
+  // header size out of range.
+  writeFile(filename, file.substr(0, 12));
+  CATCH_REQUIRE_THROWS_AS(SafeTensors::open(filename), lut::AbortedError);
+
+  remove(filename.c_str());
+}
+
+}  // namespace lten
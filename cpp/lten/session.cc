@@ -0,0 +1,289 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/session.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lten/cpu/cpu_tensor_data.h"
+#include "lten/cpu/paged_attention.h"
+#include "lten/functional.h"
+#include "lutil/error.h"
+#include "lutil/mapped_file.h"
+#include "lutil/noncopyable.h"
+#include "lutil/strings.h"
+
+namespace lten {
+
+namespace {
+
+constexpr uint32_t Magic = 0x5353544c;  // "LTSS"
+constexpr uint32_t Version = 1;
+constexpr int64_t Alignment = 64;
+
+// limit of the length and history to reject the corrupted files early.
+constexpr int64_t MaxLength = 1024 * 1024 * 1024;
+
+// fixed header of the snapshot file.
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  int32_t numLayers;
+  int32_t numHeads;
+  int32_t headDim;
+  int32_t dtype;
+  int64_t length;
+  int64_t numHistory;
+  uint64_t rngState;
+};
+
+static_assert(sizeof(Header) == 48, "invalid size of Header");
+
+int64_t alignUp(int64_t size) {
+  return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+// writes the 64-byte aligned sections of a snapshot file one after another.
+class SectionWriter : private lut::NonCopyable {
+ public:
+  SectionWriter(const std::string &filename)
+      : _fp(nullptr),
+        _pos(0) {
+    _fp = fopen(filename.c_str(), "wb");
+    if (!_fp) THROW(Aborted, lut::sprintf("unable to open file %s", filename));
+  }
+
+  ~SectionWriter() {
+    if (_fp) {
+      fclose(_fp);
+      _fp = nullptr;
+    }
+  }
+
+  // write `size` bytes of `data` and the padding after it.
+  void writeSection(const void *data, int64_t size) {
+    static const char padding[Alignment] = {0};
+    write(data, size);
+    write(padding, alignUp(_pos) - _pos);
+  }
+
+  void close() {
+    int ret = fclose(_fp);
+    _fp = nullptr;
+    if (ret != 0) THROW(Aborted, "failed to close file.");
+  }
+
+ private:
+  FILE *_fp;
+  int64_t _pos;
+
+  void write(const void *data, int64_t size) {
+    if (size == 0) return;
+    if (fwrite(data, size, 1, _fp) != 1) THROW(Aborted, "failed to write file.");
+    _pos += size;
+  }
+};
+
+// write the keys or values <float>(length, numHeads, headDim) of a layer in `dtype`.
+void writeKV(SectionWriter *writer, Tensor x, DType dtype) {
+  x = F::to(Device::getCpu(), x);
+  if (x.getDType() != DType::kFloat) x = F::cast(x, DType::kFloat);
+  x = F::contiguous(x);
+
+  if (dtype == DType::kInt8) {
+    Tensor q = F::tensor(x.getShape(), DType::kInt8);
+    Tensor scale = F::tensor({x.getShape(0), x.getShape(1)}, DType::kFloat);
+    op::cpu::quantizeKV(x, q, scale);
+
+    writer->writeSection(q.getData<Int8>(), q.getNumEl());
+    writer->writeSection(scale.getData<float>(), scale.getNumEl() * sizeof(float));
+  } else {
+    if (dtype != DType::kFloat) x = F::cast(x, dtype);
+    writer->writeSection(x.getData<void>(), dtype.getTotalSize(x.getNumEl()));
+  }
+}
+
+// reads the sections of a mapped snapshot file. The tensors returned are views of the mapped data
+// and hold the mapping until they are destroyed.
+class SectionReader {
+ public:
+  SectionReader(std::shared_ptr<lut::MappedFile> file, int64_t offset)
+      : _file(file),
+        _offset(offset) {
+  }
+
+  template<typename T>
+  lut::Span<const T> readSpan(int64_t numel) {
+    const int8_t *data = readSection(numel * sizeof(T));
+    return lut::Span<const T>(reinterpret_cast<const T *>(data), numel);
+  }
+
+  Tensor readTensor(lut::Span<const Tensor::ShapeType> shape, DType dtype) {
+    TensorShape tensorShape(shape);
+    int64_t numel = tensorShape.getNumEl();
+    const int8_t *data = readSection(dtype.getTotalSize(numel));
+
+    std::shared_ptr<lut::MappedFile> file = _file;
+    std::shared_ptr<TensorData> tensorData = op::cpu::CpuTensorData::createFromPtr(
+        numel,
+        dtype,
+        reinterpret_cast<Byte *>(const_cast<int8_t *>(data)),
+        [file]() {});
+    return Tensor::create(tensorShape, tensorData);
+  }
+
+ private:
+  std::shared_ptr<lut::MappedFile> _file;
+  int64_t _offset;
+
+  const int8_t *readSection(int64_t size) {
+    lut::Span<const int8_t> data = _file->getData();
+    if (_offset + size > static_cast<int64_t>(data.size())) {
+      THROW(Aborted, "unexpected EOF in session file.");
+    }
+
+    const int8_t *p = data.data() + _offset;
+    _offset += alignUp(size);
+    return p;
+  }
+};
+
+// read the keys or values of a layer and convert them into the type accepted by
+// KVSequence::write(). Only the tokens in [begin, length) are converted.
+Tensor readKV(SectionReader *reader, const Header &header, int begin, Device device) {
+  int length = static_cast<int>(header.length);
+  std::vector<Tensor::ShapeType> shape{length, header.numHeads, header.headDim};
+  DType dtype(static_cast<int16_t>(header.dtype));
+
+  Tensor x = reader->readTensor(shape, dtype);
+  x = x.slice({begin, length});
+  if (dtype == DType::kInt8) {
+    Tensor scale = reader->readTensor({length, header.numHeads}, DType::kFloat);
+    scale = scale.slice({begin, length});
+
+    Tensor q = x;
+    x = F::tensor(q.getShape(), DType::kFloat);
+    op::cpu::dequantizeKV(q, scale, x);
+  }
+
+  if (device.getType() != Device::kCpu) x = F::to(device, x);
+  return x;
+}
+
+}  // namespace
+
+SamplerState::SamplerState()
+    : rngState(0) {
+}
+
+void saveSession(
+    const std::string &filename,
+    const KVSequence &seq,
+    const SamplerState &sampler,
+    DType dtype) {
+  const KVCacheConfig &config = seq.getPool()->getConfig();
+  if (dtype == DType::kUnknown) dtype = config.dtype;
+  if (dtype != DType::kFloat && dtype != DType::kFloat16 && dtype != DType::kInt8) {
+    THROW(Aborted, lut::sprintf("unsupported dtype in session file: %s", dtype.toString()));
+  }
+
+  Header header;
+  memset(&header, 0, sizeof(Header));
+  header.magic = Magic;
+  header.version = Version;
+  header.numLayers = config.numLayers;
+  header.numHeads = config.numHeads;
+  header.headDim = config.headDim;
+  header.dtype = static_cast<int16_t>(dtype);
+  header.length = seq.getLength();
+  header.numHistory = static_cast<int64_t>(sampler.history.size());
+  header.rngState = sampler.rngState;
+
+  SectionWriter writer(filename);
+  writer.writeSection(&header, sizeof(Header));
+  writer.writeSection(seq.getTokens().data(), header.length * sizeof(LongType));
+  writer.writeSection(sampler.history.data(), header.numHistory * sizeof(LongType));
+
+  // the keys and values are gathered one layer at a time to bound the memory.
+  for (int layer = 0; layer < config.numLayers && header.length > 0; ++layer) {
+    writeKV(&writer, seq.getKey(layer), dtype);
+    writeKV(&writer, seq.getValue(layer), dtype);
+  }
+
+  writer.close();
+}
+
+std::unique_ptr<KVSequence> loadSession(
+    const std::string &filename,
+    std::shared_ptr<KVBlockPool> pool,
+    SamplerState *sampler) {
+  std::shared_ptr<lut::MappedFile> file = lut::MappedFile::open(filename);
+  lut::Span<const int8_t> data = file->getData();
+  if (data.size() < sizeof(Header)) THROW(Aborted, "invalid session file.");
+
+  Header header;
+  memcpy(&header, data.data(), sizeof(Header));
+  if (header.magic != Magic) THROW(Aborted, "invalid session file.");
+  if (header.version != Version) {
+    THROW(Aborted, lut::sprintf("unsupported session file version: %d", header.version));
+  }
+
+  DType dtype(static_cast<int16_t>(header.dtype));
+  if (dtype != DType::kFloat && dtype != DType::kFloat16 && dtype != DType::kInt8) {
+    THROW(Aborted, "invalid dtype in session file.");
+  }
+  if (header.length < 0 || header.length > MaxLength || header.numHistory < 0 ||
+      header.numHistory > MaxLength) {
+    THROW(Aborted, "invalid session file.");
+  }
+
+  const KVCacheConfig &config = pool->getConfig();
+  if (header.numLayers != config.numLayers || header.numHeads != config.numHeads ||
+      header.headDim != config.headDim) {
+    THROW(Aborted, "session file does not match the KV cache config.");
+  }
+
+  SectionReader reader(file, alignUp(sizeof(Header)));
+  lut::Span<const LongType> tokens = reader.readSpan<LongType>(header.length);
+  lut::Span<const LongType> history = reader.readSpan<LongType>(header.numHistory);
+  if (sampler) {
+    sampler->rngState = header.rngState;
+    sampler->history.assign(history.begin(), history.end());
+  }
+
+  std::unique_ptr<KVSequence> seq = std::make_unique<KVSequence>(pool);
+  int length = static_cast<int>(header.length);
+  if (length == 0) return seq;
+
+  // the blocks found in the prefix cache are not written again. matchPrefix() always leaves at
+  // least one token to write.
+  int numReused = seq->matchPrefix(tokens);
+  seq->reserve(length - numReused);
+  for (int layer = 0; layer < config.numLayers; ++layer) {
+    Tensor k = readKV(&reader, header, numReused, config.device);
+    Tensor v = readKV(&reader, header, numReused, config.device);
+    seq->write(layer, k, v);
+  }
+  seq->commit(tokens.subspan(numReused));
+
+  return seq;
+}
+
+}  // namespace lten
@@ -0,0 +1,78 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lten/dtype.h"
+#include "lten/kv_cache.h"
+
+namespace lten {
+
+/// @brief State of the sampler kept in a session snapshot.
+struct SamplerState {
+  /// @brief state of the random number generator, from lut::Random::getState(). Restore it with
+  /// lut::Random::reset().
+  uint64_t rngState;
+
+  /// @brief the recent token ids used by the repetition penalty.
+  std::vector<LongType> history;
+
+  SamplerState();
+};
+
+/// @brief Save the tokens, the keys and values of all layers and the sampler state of a session
+/// into `filename`, so that a resumed session could skip the prefill of the whole conversation.
+/// The file is a fixed header followed by 64-byte aligned sections: tokens, history and then the
+/// keys and values of each layer:
+///     K: <dtype>(length, numHeads, headDim)
+///     KScale: <float>(length, numHeads)  // only in int8.
+///     V: <dtype>(length, numHeads, headDim)
+///     VScale: <float>(length, numHeads)  // only in int8.
+/// It is independent of the block size of the pool.
+/// @param filename the output file.
+/// @param seq the KV cache of the session. It should have no reserved tokens.
+/// @param sampler the sampler state.
+/// @param dtype storage type of the keys and values in file: kFloat, kFloat16 or kInt8 (each
+///     (token, head) row quantized with its own scale). kUnknown for the storage type of the pool.
+void saveSession(
+    const std::string &filename,
+    const KVSequence &seq,
+    const SamplerState &sampler,
+    DType dtype = DType::kUnknown);
+
+/// @brief Restore a session saved by saveSession() into a new sequence of `pool`. The file is
+/// mapped and read sequentially once; the leading full blocks found in the prefix cache of the pool
+/// are reused instead of copied. numLayers, numHeads and headDim of the pool should match the
+/// file. Throws AbortedError if the file is invalid.
+/// @param filename the snapshot file.
+/// @param pool the block pool of the new sequence.
+/// @param sampler output the sampler state. Could be nullptr.
+/// @return the restored sequence.
+std::unique_ptr<KVSequence> loadSession(
+    const std::string &filename,
+    std::shared_ptr<KVBlockPool> pool,
+    SamplerState *sampler = nullptr);
+
+}  // namespace lten
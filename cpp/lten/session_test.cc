@@ -0,0 +1,180 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lten/session.h"
+
+#include <string>
+#include <vector>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/functional.h"
+#include "lten/test_helper.h"
+#include "lutil/error.h"
+#include "lutil/mapped_file.h"
+#include "lutil/path.h"
+#include "lutil/random.h"
+
+namespace lten {
+
+namespace {
+
+constexpr int kNumLayers = 2;
+constexpr int kNumHeads = 2;
+constexpr int kHeadDim = 8;
+
+KVCacheConfig getTestConfig(int blockSize, DType dtype = DType::kFloat) {
+  KVCacheConfig config;
+  config.numLayers = kNumLayers;
+  config.numHeads = kNumHeads;
+  config.headDim = kHeadDim;
+  config.blockSize = blockSize;
+  config.dtype = dtype;
+
+  return config;
+}
+
+// forward `tokens` into an empty `seq`. The KV of the tokens is `kv` and `kv * 2`.
+void prefill(KVSequence *seq, lut::Span<const LongType> tokens, Tensor kv) {
+  seq->reserve(static_cast<int>(tokens.size()));
+  for (int layer = 0; layer < kNumLayers; ++layer) {
+    Tensor x = kv.subtensor(layer);
+    seq->write(layer, x, F::mul(x, 2.0f));
+  }
+  seq->commit(tokens);
+}
+
+bool checkSequence(const KVSequence &seq, Tensor kv, float atol = 1e-5) {
+  for (int layer = 0; layer < kNumLayers; ++layer) {
+    Tensor x = kv.subtensor(layer);
+    if (!F::allClose(seq.getKey(layer), x, 1e-3, atol)) return false;
+    if (!F::allClose(seq.getValue(layer), F::mul(x, 2.0f), 1e-3, 2 * atol)) return false;
+  }
+
+  return true;
+}
+
+std::string getTestFilename() {
+  lut::Path dirname = lut::Path::currentExecutablePath().dirname();
+  return (dirname / "test.session").string();
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("test session save and load", "[core][session]") {
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig(4));
+  std::vector<LongType> tokens{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  Tensor kv = F::rand({kNumLayers, 10, kNumHeads, kHeadDim}, DType::kFloat);
+
+  KVSequence seq(pool);
+  prefill(&seq, tokens, kv);
+
+  lut::Random random(1234);
+  random.nextInt();
+  SamplerState sampler;
+  sampler.rngState = random.getState();
+  sampler.history = {3, 5, 7};
+  std::string filename = getTestFilename();
+  saveSession(filename, seq, sampler);
+
+  // restores into a pool with another block size.
+  std::shared_ptr<KVBlockPool> pool2 = KVBlockPool::create(getTestConfig(8));
+  SamplerState sampler2;
+  std::unique_ptr<KVSequence> seq2 = loadSession(filename, pool2, &sampler2);
+  CATCH_REQUIRE(seq2->getLength() == 10);
+  CATCH_REQUIRE(std::vector<LongType>(seq2->getTokens().begin(), seq2->getTokens().end()) ==
+                tokens);
+  CATCH_REQUIRE(checkSequence(*seq2, kv));
+  CATCH_REQUIRE(sampler2.history == sampler.history);
+
+  // the generator continues from where it was saved.
+  lut::Random random2;
+  random2.reset(sampler2.rngState);
+  CATCH_REQUIRE(random2.nextInt() == random.nextInt());
+
+  // the full blocks cached in the pool are reused.
+  std::unique_ptr<KVSequence> seq3 = loadSession(filename, pool);
+  CATCH_REQUIRE(pool->getStats().numHits == 2);
+  CATCH_REQUIRE(seq3->getBlocks()[0] == seq.getBlocks()[0]);
+  CATCH_REQUIRE(checkSequence(*seq3, kv));
+
+  // empty session.
+  KVSequence empty(pool);
+  saveSession(filename, empty, SamplerState());
+  CATCH_REQUIRE(loadSession(filename, pool2)->getLength() == 0);
+}
+
+CATCH_TEST_CASE("test session in compact dtypes", "[core][session]") {
+  std::vector<LongType> tokens{1, 2, 3, 4, 5, 6, 7};
+  Tensor kv = F::rand({kNumLayers, 7, kNumHeads, kHeadDim}, DType::kFloat);
+  std::string filename = getTestFilename();
+
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig(4));
+  KVSequence seq(pool);
+  prefill(&seq, tokens, kv);
+
+  saveSession(filename, seq, SamplerState(), DType::kFloat16);
+  std::shared_ptr<KVBlockPool> pool2 = KVBlockPool::create(getTestConfig(4));
+  CATCH_REQUIRE(checkSequence(*loadSession(filename, pool2), kv, 2e-3));
+
+  saveSession(filename, seq, SamplerState(), DType::kInt8);
+  pool2 = KVBlockPool::create(getTestConfig(4));
+  CATCH_REQUIRE(checkSequence(*loadSession(filename, pool2), kv, 2e-2));
+
+  // int8 pool to int8 file, then back into an int8 pool.
+  std::shared_ptr<KVBlockPool> poolInt8 = KVBlockPool::create(getTestConfig(4, DType::kInt8));
+  KVSequence seqInt8(poolInt8);
+  prefill(&seqInt8, tokens, kv);
+  saveSession(filename, seqInt8, SamplerState());
+  pool2 = KVBlockPool::create(getTestConfig(4, DType::kInt8));
+  std::unique_ptr<KVSequence> seq2 = loadSession(filename, pool2);
+  for (int layer = 0; layer < kNumLayers; ++layer) {
+    CATCH_REQUIRE(F::allClose(seq2->getKey(layer), seqInt8.getKey(layer), 1e-3, 1e-5));
+    CATCH_REQUIRE(F::allClose(seq2->getValue(layer), seqInt8.getValue(layer), 1e-3, 1e-5));
+  }
+}
+
+CATCH_TEST_CASE("test session invalid file", "[core][session]") {
+  std::vector<LongType> tokens{1, 2, 3, 4, 5};
+  Tensor kv = F::rand({kNumLayers, 5, kNumHeads, kHeadDim}, DType::kFloat);
+  std::string filename = getTestFilename();
+
+  std::shared_ptr<KVBlockPool> pool = KVBlockPool::create(getTestConfig(4));
+  KVSequence seq(pool);
+  prefill(&seq, tokens, kv);
+  saveSession(filename, seq, SamplerState());
+
+  // config mismatch.
+  KVCacheConfig config = getTestConfig(4);
+  config.numHeads = 1;
+  CATCH_REQUIRE_THROWS_AS(loadSession(filename, KVBlockPool::create(config)), lut::AbortedError);
+
+  // truncated file.
+  std::shared_ptr<lut::MappedFile> file = lut::MappedFile::open(filename);
+  std::string data(reinterpret_cast<const char *>(file->getData().data()), file->getData().size());
+  file = nullptr;
+  writeFile(filename, data.substr(0, data.size() - 64));
+  CATCH_REQUIRE_THROWS_AS(loadSession(filename, pool), lut::AbortedError);
+
+  // bad magic number.
+  data[0] = 'X';
+  writeFile(filename, data);
+  CATCH_REQUIRE_THROWS_AS(loadSession(filename, pool), lut::AbortedError);
+}
+
+}  // namespace lten
@@ -21,22 +21,27 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <limits>
 
+#include "lten/cpu/arena.h"
 #include "lten/cpu/cpu_tensor_data.h"
+#include "lten/cpu/numa.h"
 #include "lten/cpu/view.h"
 #include "lten/functional.h"
+#include "lten/mp.h"
 #include "lutil/error.h"
 #include "lutil/strings.h"
+#include "lutil/zip_file.h"
 
 namespace lten {
 
 template<typename T>
-Tensor Tensor::create(std::initializer_list<int> shape, lut::Span<const T> data) {
+Tensor Tensor::create(std::initializer_list<ShapeType> shape, lut::Span<const T> data) {
   Tensor tensor;
 
-  tensor._shape = std::make_shared<TensorShape>(shape);
-  int64_t numel = tensor._shape->getNumEl();
+  tensor._shape = TensorShape(shape);
+  int64_t numel = tensor._shape.getNumEl();
 
   DType dtype = DType::getType<T>();
   tensor._data = op::cpu::CpuTensorData::create(numel, dtype);
@@ -49,11 +54,15 @@ Tensor Tensor::create(std::initializer_list<int> shape, lut::Span<const T> data)
   return tensor;
 }
 
-template Tensor Tensor::create(std::initializer_list<int> shape, lut::Span<const float> data);
-template Tensor Tensor::create(std::initializer_list<int> shape, lut::Span<const LongType> data);
+template Tensor Tensor::create(
+    std::initializer_list<ShapeType> shape,
+    lut::Span<const float> data);
+template Tensor Tensor::create(
+    std::initializer_list<ShapeType> shape,
+    lut::Span<const LongType> data);
 
 Tensor Tensor::create(
-    std::shared_ptr<TensorShape> shape,
+    const TensorShape &shape,
     std::shared_ptr<TensorData> data,
     int64_t offset) {
   Tensor tensor;
@@ -85,16 +94,21 @@ Tensor &Tensor::operator=(const Tensor &tensor) {
 }
 
 Tensor::Tensor(Tensor &&tensor) noexcept {
-  _data = tensor._data;
-  _shape = std::move(tensor._shape);
+  _data = std::move(tensor._data);
+  _shape = tensor._shape;
   _offset = tensor._offset;
+
+  tensor._shape = TensorShape();
 }
 
 Tensor &Tensor::operator=(Tensor &&tensor) {
-  _data = tensor._data;
-  _shape = std::move(tensor._shape);
+  if (this == &tensor) return *this;
+
+  _data = std::move(tensor._data);
+  _shape = tensor._shape;
   _offset = tensor._offset;
 
+  tensor._shape = TensorShape();
   return *this;
 }
 
@@ -109,26 +123,57 @@ void Tensor::read(lut::Reader *fp) {
   _offset = 0;
 
   // check
-  if (_shape->getNumEl() != _data->getNumEl())
+  if (_shape.getNumEl() != _data->getNumEl())
     throw lut::AbortedError("tensor data and shape mismatch.");
+
+  // weights are first touched by the loading thread, move the rows to the NUMA nodes of the
+  // threads reading them in GEMV. The pages mapped from the model file are shared with the page
+  // cache, leave them where they are.
+  if (getDim() == 2 && !_data->isExternal()) op::cpu::placeRowsOnNumaNodes(*this);
+}
+
+Tensor readTensor(const lut::ZipFile &zipFile, const std::string &name, DType dtype) {
+  op::cpu::NoArenaScope noArenaScope;
+
+  std::shared_ptr<lut::Reader> reader = zipFile.open(name);
+  reader->adviseSequential();
+
+  Tensor tensor;
+  tensor.read(reader.get());
+  if (dtype != DType::kUnknown && tensor.getDType() != dtype) tensor = F::cast(tensor, dtype);
+
+  return tensor;
+}
+
+std::vector<Tensor> readTensors(
+    const lut::ZipFile &zipFile,
+    lut::Span<const std::string> names,
+    DType dtype) {
+  std::vector<Tensor> tensors(names.size());
+  MP::parallelForOrThrow(names.size(), [&zipFile, names, dtype, &tensors](MP::Context ctx) {
+    int64_t i = ctx.getBlockIdx();
+    tensors[i] = readTensor(zipFile, names[i], dtype);
+  });
+
+  return tensors;
 }
 
-Tensor Tensor::view(lut::Span<const int> shape) const {
+Tensor Tensor::view(lut::Span<const ShapeType> shape) const {
   return op::cpu::view(*this, shape);
 }
 
-Tensor Tensor::expand(lut::Span<const int> shape) const {
+Tensor Tensor::expand(lut::Span<const ShapeType> shape) const {
   CHECK(!getDType().isQuantized());
   Tensor x;
   x._data = _data;
   x._offset = _offset;
-  x._shape = _shape->expand(shape);
+  x._shape = _shape.expand(shape);
 
   return x;
 }
 
-std::vector<int> Tensor::getShape() const {
-  std::vector<int> shape;
+std::vector<Tensor::ShapeType> Tensor::getShape() const {
+  std::vector<ShapeType> shape;
   for (int d = 0; d < getDim(); ++d) {
     shape.push_back(getShape(d));
   }
@@ -136,11 +181,11 @@ std::vector<int> Tensor::getShape() const {
 }
 
 std::string Tensor::getShapeString() const {
-  return _shape->toString();
+  return _shape.toString();
 }
 
 bool Tensor::isContiguous() const {
-  int numel = 1;
+  int64_t numel = 1;
   for (int i = getDim() - 1; i >= 0; --i) {
     if (numel != getStride(i) && getShape(i) != 1) return false;
     numel *= getShape(i);
@@ -149,49 +194,61 @@ bool Tensor::isContiguous() const {
   return true;
 }
 
-Tensor Tensor::slice(int dim, std::pair<int, int> range) const {
+bool Tensor::isDataExclusive() const {
+  return _data && _data.use_count() == 1 && !_data->isExternal();
+}
+
+void Tensor::makeExclusive() {
+  if (isDataExclusive()) return;
+
+  Tensor x = F::tensorLike(*this);
+  F::copy(*this, x);
+  *this = x;
+}
+
+Tensor Tensor::slice(int dim, std::pair<ShapeType, ShapeType> range) const {
   CHECK(!getDType().isQuantized());
 
-  dim = _shape->getRealDim(dim);
+  dim = _shape.getRealDim(dim);
   CHECK(dim >= 0 && dim < this->getDim());
 
-  int begin = range.first;
-  int end = range.second;
+  ShapeType begin = range.first;
+  ShapeType end = range.second;
 
   if (begin == None) begin = 0;
   if (end == None) end = getShape(dim);
 
-  begin = _shape->getRealIndex(dim, begin);
-  end = _shape->getRealIndex(dim, end);
+  begin = _shape.getRealIndex(dim, begin);
+  end = _shape.getRealIndex(dim, end);
   CHECK(begin >= 0 && begin < end && end <= getShape(dim));
 
   Tensor tensor;
   tensor._data = _data;
-  tensor._shape = std::make_shared<TensorShape>(*_shape);
-  tensor._shape->setShape(dim, end - begin);
-  tensor._offset = _offset + _shape->getStride(dim) * begin;
+  tensor._shape = _shape;
+  tensor._shape.setShape(dim, end - begin);
+  tensor._offset = _offset + _shape.getStride(dim) * begin;
 
   return tensor;
 }
 
-Tensor Tensor::slice(std::pair<int, int> range) const {
+Tensor Tensor::slice(std::pair<ShapeType, ShapeType> range) const {
   CHECK(!getDType().isQuantized());
 
-  int begin = range.first;
-  int end = range.second;
+  ShapeType begin = range.first;
+  ShapeType end = range.second;
   return slice(0, {begin, end});
 }
 
-Tensor Tensor::subtensor(int index) const {
+Tensor Tensor::subtensor(ShapeType index) const {
   CHECK(!getDType().isQuantized());
 
-  index = _shape->getRealIndex(0, index);
+  index = _shape.getRealIndex(0, index);
   CHECK(index >= 0 && index < getShape(0));
 
   Tensor tensor;
   tensor._data = _data;
-  tensor._shape = _shape->subsize(1);
-  tensor._offset = _offset + _shape->getStride(0) * index;
+  tensor._shape = _shape.subsize(1);
+  tensor._offset = _offset + _shape.getStride(0) * index;
 
   return tensor;
 }
@@ -200,7 +257,7 @@ Tensor Tensor::transpose(int dim0, int dim1) const {
   Tensor tensor;
   tensor._data = _data;
   tensor._offset = _offset;
-  tensor._shape = _shape->transpose(dim0, dim1);
+  tensor._shape = _shape.transpose(dim0, dim1);
 
   return tensor;
 }
@@ -209,7 +266,7 @@ Tensor Tensor::unsqueeze(int dim) const {
   Tensor tensor;
   tensor._data = _data;
   tensor._offset = _offset;
-  tensor._shape = _shape->unsqueeze(dim);
+  tensor._shape = _shape.unsqueeze(dim);
 
   return tensor;
 }
@@ -218,12 +275,12 @@ Tensor Tensor::squeeze(int dim) const {
   Tensor tensor;
   tensor._data = _data;
   tensor._offset = _offset;
-  tensor._shape = _shape->squeeze(dim);
+  tensor._shape = _shape.squeeze(dim);
 
   return tensor;
 }
 
-void Tensor::throwIfInvalidShape(lut::Span<const int> shape, const std::string &name) const {
+void Tensor::throwIfInvalidShape(lut::Span<const ShapeType> shape, const std::string &name) const {
   if (static_cast<int>(shape.size()) != getDim()) {
     throw lut::AbortedError(
         lut::sprintf(
@@ -235,7 +292,7 @@ void Tensor::throwIfInvalidShape(lut::Span<const int> shape, const std::string &
 
   int i = 0;
   bool correct = true;
-  for (int s : shape) {
+  for (ShapeType s : shape) {
     if (this->getShape(i) != s) {
       correct = false;
     }
@@ -254,7 +311,7 @@ void Tensor::throwIfInvalidShape(lut::Span<const int> shape, const std::string &
     std::ostringstream expected;
     bool first = true;
     expected << "(";
-    for (int s : shape) {
+    for (ShapeType s : shape) {
       if (!first) expected << ", ";
       expected << s;
       first = false;
@@ -275,19 +332,19 @@ const TensorData *Tensor::getDataObject() const {
 }
 
 int Tensor::getDim() const {
-  return _shape->getDim();
+  return _shape.getDim();
 }
 
-int Tensor::getShape(int d) const {
-  return _shape->getShape(d);
+Tensor::ShapeType Tensor::getShape(int d) const {
+  return _shape.getShape(d);
 }
 
 const TensorShape *Tensor::getShape_() const {
-  return _shape.get();
+  return &_shape;
 }
 
 bool Tensor::empty() const {
-  return !_shape;
+  return _shape.getDim() == kEmptyRank;
 }
 
 Device Tensor::getDevice() const {
@@ -295,11 +352,11 @@ Device Tensor::getDevice() const {
 }
 
 Tensor::ShapeType Tensor::getStride(int d) const {
-  return _shape->getStride(d);
+  return _shape.getStride(d);
 }
 
 int64_t Tensor::getNumEl() const {
-  return _shape->getNumEl();
+  return _shape.getNumEl();
 }
 
 int64_t Tensor::getOffset_() const {
@@ -314,111 +371,91 @@ std::shared_ptr<TensorData> Tensor::getDataShared_() const {
 // TensorShaoe                                                                                    |
 // -----------------------------------------------------------------------------------------------+
 
-TensorShape::TensorShape(const TensorShape &size)
-    : _data(size._data.copy()) {
-}
-TensorShape::TensorShape(TensorShape &&size) noexcept
-    : _data(std::move(size._data)) {
-}
-TensorShape &TensorShape::operator=(const TensorShape &size) {
-  _data = size._data.copy();
-  return *this;
-}
-TensorShape &TensorShape::operator=(TensorShape &&size) noexcept {
-  _data = std::move(size._data);
-  return *this;
+TensorShape::TensorShape()
+    : _dim(Tensor::kEmptyRank) {
 }
 
 TensorShape::TensorShape(lut::Span<const ShapeType> shape) {
-  _data = lut::FixedArray<Elem>(shape.size());
-  lut::FixedArray<Elem>::iterator it = _data.begin();
-  for (int n : shape) {
-    it->shape = n;
-    ++it;
-  }
+  CHECK(shape.size() <= MaxDim) << "too many dimensions.";
+  _dim = static_cast<int>(shape.size());
 
-  int64_t stride = 1;
-  for (int d = static_cast<int>(shape.size()) - 1; d >= 0; --d) {
-    CHECK(stride < std::numeric_limits<ShapeType>::max());
-    _data[d].stride = static_cast<ShapeType>(stride);
+  ShapeType stride = 1;
+  for (int d = _dim - 1; d >= 0; --d) {
+    _data[d].shape = shape[d];
+    _data[d].stride = stride;
     stride *= _data[d].shape;
   }
 }
 
 TensorShape::TensorShape(lut::Span<const Elem> shape) {
-  _data = lut::FixedArray<Elem>(shape.size());
-  std::copy(shape.begin(), shape.end(), _data.begin());
+  CHECK(shape.size() <= MaxDim) << "too many dimensions.";
+  _dim = static_cast<int>(shape.size());
+  std::copy(shape.begin(), shape.end(), _data);
 }
 
-std::shared_ptr<TensorShape> TensorShape::subsize(int d) const {
+TensorShape TensorShape::subsize(int d) const {
   CHECK(d < getDim());
-
-  std::shared_ptr<TensorShape> subsize{new TensorShape()};
-  subsize->_data = lut::FixedArray<Elem>(getDim() - d);
-  std::copy(_data.begin() + d, _data.end(), subsize->_data.begin());
-
-  return subsize;
+  return TensorShape(lut::makeConstSpan(_data + d, getDim() - d));
 }
 
-std::shared_ptr<TensorShape> TensorShape::read(lut::Reader *fp) {
+TensorShape TensorShape::read(lut::Reader *fp) {
   // rank
   int16_t rank = fp->readValue<int16_t>();
-  if (rank > 16 || rank < 0) {
+  if (rank > MaxDim || rank < 0) {
     throw lut::AbortedError("invalid rank.");
   }
 
   // shape
-  std::vector<ShapeType> shape;
+  ShapeType shape[MaxDim];
   for (int16_t d = 0; d < rank; ++d) {
     int32_t size = fp->readValue<int32_t>();
-    if (size >= 1048576 || size <= 0) throw lut::AbortedError("invalid size in shape.");
+    if (size <= 0) throw lut::AbortedError("invalid size in shape.");
 
-    shape.push_back(size);
+    shape[d] = size;
   }
 
-  return std::make_shared<TensorShape>(lut::makeConstSpan(shape));
+  return TensorShape(lut::makeConstSpan(shape, rank));
 }
 
-std::shared_ptr<TensorShape> TensorShape::transpose(int dim0, int dim1) const {
+TensorShape TensorShape::transpose(int dim0, int dim1) const {
   dim0 = getRealDim(dim0);
   dim1 = getRealDim(dim1);
 
-  std::shared_ptr<TensorShape> size = std::make_shared<TensorShape>(*this);
-  Elem dim0_elem = size->_data[dim0];
-  size->_data[dim0] = size->_data[dim1];
-  size->_data[dim1] = dim0_elem;
+  TensorShape size = *this;
+  std::swap(size._data[dim0], size._data[dim1]);
 
   return size;
 }
 
-std::shared_ptr<TensorShape> TensorShape::squeeze(int dim) const {
+TensorShape TensorShape::squeeze(int dim) const {
   CHECK(getShape(dim) == 1);
 
   dim = getRealDim(dim);
-  std::shared_ptr<TensorShape> size{new TensorShape()};
-  size->_data = lut::FixedArray<Elem>(getDim() - 1);
+  TensorShape size;
+  size._dim = getDim() - 1;
   for (int d = 0; d < dim; ++d) {
-    size->_data[d] = _data[d];
+    size._data[d] = _data[d];
   }
   for (int d = dim + 1; d < getDim(); ++d) {
-    size->_data[d - 1] = _data[d];
+    size._data[d - 1] = _data[d];
   }
 
   return size;
 }
 
-std::shared_ptr<TensorShape> TensorShape::unsqueeze(int dim) const {
+TensorShape TensorShape::unsqueeze(int dim) const {
   if (dim != getDim()) dim = getRealDim(dim);
+  CHECK(getDim() < MaxDim) << "too many dimensions.";
 
-  std::shared_ptr<TensorShape> size{new TensorShape()};
-  size->_data = lut::FixedArray<Elem>(getDim() + 1);
+  TensorShape size;
+  size._dim = getDim() + 1;
   for (int d = 0; d < dim; ++d) {
-    size->_data[d] = _data[d];
+    size._data[d] = _data[d];
   }
-  size->_data[dim].shape = 1;
-  size->_data[dim].stride = dim == 0 ? getStride(0) * getShape(0) : getStride(dim - 1);
+  size._data[dim].shape = 1;
+  size._data[dim].stride = dim == 0 ? getStride(0) * getShape(0) : getStride(dim - 1);
   for (int d = dim; d < getDim(); ++d) {
-    size->_data[d + 1] = _data[d];
+    size._data[d + 1] = _data[d];
   }
 
   return size;
@@ -435,11 +472,11 @@ int TensorShape::getRealDim(int d) const {
   return d;
 }
 
-int TensorShape::getRealIndex(int dim, int index) const {
+TensorShape::ShapeType TensorShape::getRealIndex(int dim, ShapeType index) const {
   CHECK(!empty());
   dim = getRealDim(dim);
 
-  int shape = _data[dim].shape;
+  ShapeType shape = _data[dim].shape;
   index = index >= 0 ? index : shape + index;
 
   CHECK(index >= 0 && index <= shape);
@@ -447,18 +484,18 @@ int TensorShape::getRealIndex(int dim, int index) const {
 }
 
 int TensorShape::getDim() const {
-  return static_cast<int>(_data.size());
+  return _dim;
 }
 
 bool TensorShape::empty() const {
-  return _data.empty();
+  return _dim <= 0;
 }
 
-int TensorShape::getShape(int d) const {
+TensorShape::ShapeType TensorShape::getShape(int d) const {
   return _data[getRealDim(d)].shape;
 }
 
-int TensorShape::getStride(int d) const {
+TensorShape::ShapeType TensorShape::getStride(int d) const {
   return _data[getRealDim(d)].stride;
 }
 
@@ -468,8 +505,8 @@ int64_t TensorShape::getNumEl() const {
   }
 
   int64_t n = 1;
-  for (const Elem &elem : _data) {
-    n *= elem.shape;
+  for (int d = 0; d < _dim; ++d) {
+    n *= _data[d].shape;
   }
   return n;
 }
@@ -482,15 +519,15 @@ void TensorShape::setShape(int dim, ShapeType shape) {
   _data[dim].shape = shape;
 }
 
-std::shared_ptr<TensorShape> TensorShape::expand(lut::Span<const int> shape) const {
+TensorShape TensorShape::expand(lut::Span<const ShapeType> shape) const {
   CHECK(getDim() == static_cast<int>(shape.size()));
-  std::shared_ptr<TensorShape> view = std::make_shared<TensorShape>(lut::makeConstSpan(_data));
+  TensorShape view = *this;
   int dim = getDim();
   for (int d = 0; d < dim; ++d) {
     if (shape[d] != getShape(d)) {
       CHECK(getShape(d) == 1) << "unable to expand a non-singleton dimension (size > 1).";
-      view->_data[d].shape = shape[d];
-      view->_data[d].stride = 0;
+      view._data[d].shape = shape[d];
+      view._data[d].stride = 0;
     }
   }
 
@@ -502,7 +539,7 @@ std::string TensorShape::toString() const {
   bool first = true;
 
   os << "(";
-  for (Elem elem : _data) {
+  for (Elem elem : getData_()) {
     if (first) {
       first = false;
     } else {
@@ -30,14 +30,80 @@
 #include "lutil/reader.h"
 #include "lutil/span.h"
 
+namespace lut {
+class ZipFile;
+}  // namespace lut
+
 namespace lten {
 
-class TensorShape;
 class TensorData;
 
+// Stores shape and stride of a Tensor. The elements are stored inline, so that TensorShape could
+// be held and copied by value without any heap allocation. Both shape and stride are 64-bit, so a
+// single tensor could have more than 2^31 elements.
+class TensorShape {
+ public:
+  typedef int64_t ShapeType;
+  struct Elem {
+    ShapeType shape;
+    ShapeType stride;
+  };
+
+  // maximum number of dimensions of a tensor.
+  static constexpr int MaxDim = 8;
+
+  // read tensor shape from file.
+  static TensorShape read(lut::Reader *fp);
+
+  // shape of an empty Tensor, getDim() returns -1.
+  TensorShape();
+
+  // from shape.
+  TensorShape(lut::Span<const ShapeType> shape);
+  TensorShape(lut::Span<const Elem> shape);
+
+  bool empty() const;
+  int getDim() const;
+  ShapeType getShape(int index) const;
+  ShapeType getStride(int index) const;
+  int64_t getNumEl() const;
+
+  // Returns a sub-Size starting at specified dimension.
+  TensorShape subsize(int d) const;
+
+  // Returns a Size that is a transposed version of current size. The given
+  // dimensions dim0 and dim1 are swapped.
+  TensorShape transpose(int dim0, int dim1) const;
+
+  // add or remove one shape=1 dimension at specified dimension.
+  TensorShape unsqueeze(int dim) const;
+  TensorShape squeeze(int dim) const;
+
+  // set the value of shape(dim). Negative dim is allowed. new `shape` should be less or equal to
+  // current size.
+  void setShape(int dim, ShapeType shape);
+
+  // return a new shape that expand singleton dimensions to a larger size.
+  TensorShape expand(lut::Span<const ShapeType> shape) const;
+
+  // convert negative dimension or index (in specific `dim`) to positive.
+  int getRealDim(int dim) const;
+  ShapeType getRealIndex(int dim, ShapeType index) const;
+
+  lut::Span<const Elem> getData_() const {
+    return lut::makeConstSpan(_data, _dim > 0 ? _dim : 0);
+  }
+
+  std::string toString() const;
+
+ private:
+  Elem _data[MaxDim];
+  int _dim;
+};
+
 class Tensor {
  public:
-  typedef int32_t ShapeType;
+  typedef TensorShape::ShapeType ShapeType;
   // rank for empty tansor.
   static constexpr int kEmptyRank = -1;
 
@@ -45,14 +111,14 @@ class Tensor {
   // Example:
   //   Tensor x = Tensor::FromData({2, 2}, {1.0f, 0.8f, 0.6f, 0.2f});
   template<typename T>
-  static Tensor create(std::initializer_list<int> shape, lut::Span<const T> data);
+  static Tensor create(std::initializer_list<ShapeType> shape, lut::Span<const T> data);
 
   /// @brief Create Tensor from TensorShape and TensorData.
-  /// @param shape pointer to TensorShape.
+  /// @param shape the TensorShape, copied into the tensor.
   /// @param data pointer to TensorData.
   /// @return The Tensor created.
   static Tensor create(
-      std::shared_ptr<TensorShape> shape,
+      const TensorShape &shape,
       std::shared_ptr<TensorData> data,
       int64_t offset = 0);
 
@@ -75,7 +141,7 @@ class Tensor {
   // get the size in dimention `d`. `d` supports positive number (index) and negative number (index
   // from back). Crash if `d` is out of boundary
   ShapeType getShape(int d) const;
-  std::vector<int> getShape() const;
+  std::vector<ShapeType> getShape() const;
   std::string getShapeString() const;
 
   // get stride for dimension `d`.
@@ -95,21 +161,21 @@ class Tensor {
   Device getDevice() const;
 
   // Get a new view of the tensor..
-  Tensor view(lut::Span<const int> shape) const;
+  Tensor view(lut::Span<const ShapeType> shape) const;
 
   // Get a new view of the tensor with singleton dimensions expanded to a larger size.
-  Tensor expand(lut::Span<const int> shape) const;
+  Tensor expand(lut::Span<const ShapeType> shape) const;
 
   // Get slice of this tensor. `dim` is the dimension to slice. [begin, end) is the range. For
   // [begin, end) only version, dimension 0 is used. Negative `begin` and `end` is accepted. Crash
   // if dim or range out of boundary.
   // None could be used in both begin and end. (None, 5) means [: 5], (5, None) means [5: ].
-  Tensor slice(int dim, std::pair<int, int> range) const;
-  Tensor slice(std::pair<int, int> range) const;
+  Tensor slice(int dim, std::pair<ShapeType, ShapeType> range) const;
+  Tensor slice(std::pair<ShapeType, ShapeType> range) const;
 
   // Get subtensor at specified index of first dimension. Negative `index` is accepted. Crash if
   // `index` out of boundary.
-  Tensor subtensor(int index) const;
+  Tensor subtensor(ShapeType index) const;
 
   // add or remove an additional shape=1 dimension at specified position.
   Tensor unsqueeze(int dim) const;
@@ -120,6 +186,14 @@ class Tensor {
   // return true if the tensor is contigous.
   bool isContiguous() const;
 
+  // return true if no other tensor (including views) shares the data of this tensor, so the data
+  // could be modified in place. Data borrowed from external memory is never exclusive.
+  bool isDataExclusive() const;
+
+  // copy-on-write: if the data is shared with other tensors, replace it with a contiguous copy
+  // owned by this tensor only. Call it before modifying a view in place.
+  void makeExclusive();
+
   // pointer of data in this tensor
   template<typename T>
   T *getData();
@@ -128,7 +202,7 @@ class Tensor {
 
   // Check the shape of a tensor. If shape of `tensor` does not match `shape`, return AbortedError
   // with message "invalid shape".
-  void throwIfInvalidShape(lut::Span<const int> shape, const std::string &name) const;
+  void throwIfInvalidShape(lut::Span<const ShapeType> shape, const std::string &name) const;
 
   // low-level functions. DO NOT use them outside llyn.
   const TensorData *getDataObject() const;
@@ -138,71 +212,34 @@ class Tensor {
 
  protected:
   std::shared_ptr<TensorData> _data;
-  std::shared_ptr<TensorShape> _shape;
+  TensorShape _shape;
   int64_t _offset;
 };
 
-// Stores shape and stride of a Tensor.
-class TensorShape {
- public:
-  typedef Tensor::ShapeType ShapeType;
-  struct Elem {
-    ShapeType shape;
-    ShapeType stride;
-  };
-
-  // read tensor shape from file.
-  static std::shared_ptr<TensorShape> read(lut::Reader *fp);
-
-  // from shape.
-  TensorShape(lut::Span<const ShapeType> shape);
-  TensorShape(lut::Span<const Elem> shape);
-
-  TensorShape(const TensorShape &size);
-  TensorShape(TensorShape &&size) noexcept;
-  TensorShape &operator=(const TensorShape &size);
-  TensorShape &operator=(TensorShape &&size) noexcept;
-
-  bool empty() const;
-  int getDim() const;
-  ShapeType getShape(int index) const;
-  ShapeType getStride(int index) const;
-  int64_t getNumEl() const;
-
-  // Returns a sub-Size starting at specified dimension.
-  std::shared_ptr<TensorShape> subsize(int d) const;
-
-  // Returns a Size that is a transposed version of current size. The given
-  // dimensions dim0 and dim1 are swapped.
-  std::shared_ptr<TensorShape> transpose(int dim0, int dim1) const;
-
-  // add or remove one shape=1 dimension at specified dimension.
-  std::shared_ptr<TensorShape> unsqueeze(int dim) const;
-  std::shared_ptr<TensorShape> squeeze(int dim) const;
-
-  // set the value of shape(dim). Negative dim is allowed. new `shape` should be less or equal to
-  // current size.
-  void setShape(int dim, ShapeType shape);
-
-  // return a new shape that expand singleton dimensions to a larger size.
-  std::shared_ptr<TensorShape> expand(lut::Span<const int> shape) const;
-
-  // convert negative dimension or index (in specific `dim`) to positive.
-  int getRealDim(int dim) const;
-  int getRealIndex(int dim, int index) const;
-
-  lut::Span<const Elem> getData_() const {
-    return lut::makeConstSpan(_data);
-  }
-
-  std::string toString() const;
-
- private:
-  lut::FixedArray<Elem> _data;
-
-  // an empty Tensor.
-  TensorShape() = default;
-};
+/// @brief Read the tensor from the entry `name` of the zip file, in the format of Tensor::read().
+/// The tensor data is allocated outside the arena of current thread, since it is expected to live
+/// longer than the arena scope.
+/// @param zipFile the zip file.
+/// @param name name of the entry.
+/// @param dtype if not DType::kUnknown, the tensor is also converted to `dtype`.
+/// @return the tensor.
+Tensor readTensor(
+    const lut::ZipFile &zipFile,
+    const std::string &name,
+    DType dtype = DType::kUnknown);
+
+/// @brief Read the tensors from the entries `names` of the zip file concurrently on the worker
+/// threads, so loading a large model is bounded by the disk bandwidth instead of a single thread
+/// copying the data. Each entry is in the format of Tensor::read().
+/// @param zipFile the zip file.
+/// @param names names of the entries.
+/// @param dtype if not DType::kUnknown, the tensors are also converted to `dtype` (for example,
+/// dequantized) in the worker threads.
+/// @return the tensors in the same order as `names`.
+std::vector<Tensor> readTensors(
+    const lut::ZipFile &zipFile,
+    lut::Span<const std::string> names,
+    DType dtype = DType::kUnknown);
 
 /// @brief A data record in TensorData object.
 class SlotBase {
@@ -252,13 +289,20 @@ inline void *SlotBase::getData<void>(int64_t offset) const {
 class TensorData {
  public:
   static constexpr int MaxSlot = 3;
-  static constexpr int64_t MaxNumEl = 1073741824;
+  // upper bound of the number of elements in a slot, only for sanity check of the inputs.
+  static constexpr int64_t MaxNumEl = int64_t(1) << 48;
 
   virtual ~TensorData() = default;
 
   // get the device of tensor data.
   virtual Device getDevice() const = 0;
 
+  /// @brief Returns true if the data borrows external memory, which should not be overwritten by
+  /// the operators.
+  virtual bool isExternal() const {
+    return false;
+  }
+
   /// @brief Get number of slots in this tensor data.
   /// @return number of slots.
   virtual int getNumSlot() const = 0;
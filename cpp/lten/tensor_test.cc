@@ -19,8 +19,20 @@
 
 #include "lten/tensor.h"
 
+#include <stdio.h>
+
 #include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lten/cpu/accessor.h"
 #include "lten/functional.h"
+#include "lten/lten.h"
+#include "lten/test_helper.h"
+#include "lutil/error.h"
+#include "lutil/log.h"
+#include "lutil/mapped_file.h"
+#include "lutil/path.h"
+#include "lutil/strings.h"
+#include "lutil/time.h"
+#include "lutil/zip_file.h"
 
 namespace lten {
 
@@ -82,4 +94,299 @@ CATCH_TEST_CASE("test subtensor and slice", "[core][nn][tensor]") {
   CATCH_REQUIRE(F::allClose(tensor.slice(0, {1, 3}).slice(1, {1, 3}), subtensor));
 }
 
+CATCH_TEST_CASE("test inline tensor shape", "[core][nn][tensor]") {
+  Tensor x = F::rand({2, 3, 4}, DType::kFloat);
+  Tensor y = x.transpose(0, 2).unsqueeze(0).slice(1, {1, 3});
+  CATCH_REQUIRE(y.getShape() == std::vector<Tensor::ShapeType>{1, 2, 3, 2});
+  CATCH_REQUIRE(y.getStride(1) == 1);
+  CATCH_REQUIRE(y.getStride(3) == 12);
+  CATCH_REQUIRE(y.getOffset_() == 1);
+
+  // views do not share the shape with the source tensor.
+  Tensor z = y.squeeze(0);
+  CATCH_REQUIRE(y.getDim() == 4);
+  CATCH_REQUIRE(z.getShape() == std::vector<Tensor::ShapeType>{2, 3, 2});
+
+  // moved-from tensor is empty.
+  Tensor w = std::move(z);
+  CATCH_REQUIRE(z.empty());
+  CATCH_REQUIRE(!w.empty());
+  CATCH_REQUIRE(F::allClose(w, x.transpose(0, 2).slice(0, {1, 3})));
+
+  // the maximum rank.
+  std::vector<Tensor::ShapeType> shape(TensorShape::MaxDim, 1);
+  Tensor t = F::zeros(shape, DType::kFloat);
+  CATCH_REQUIRE(t.view({-1}).getShape(0) == 1);
+  CATCH_REQUIRE(t.getDim() == TensorShape::MaxDim);
+}
+
+CATCH_TEST_CASE("test TensorList strided iteration", "[core][nn][tensor]") {
+  Tensor x = F::rand({2, 3, 4, 5}, DType::kFloat);
+
+  // the batch dims are (3, 2) with stride (20, 60) after transpose.
+  Tensor y = x.transpose(0, 1);
+  op::cpu::TensorList<const float, 2> list = op::cpu::TensorList<const float, 2>::fromTensor(y);
+  CATCH_REQUIRE(list.getLength() == 6);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      const float *p = list.getDataPtr(i * 2 + j);
+      CATCH_REQUIRE(p == y.subtensor(i).subtensor(j).getData<float>());
+      CATCH_REQUIRE(list.getTensor(i * 2 + j)[3][4] == p[19]);
+    }
+  }
+
+  // contiguous batch dims are merged, singleton ones are dropped.
+  Tensor z = x.unsqueeze(1).slice(3, {1, 3});
+  op::cpu::TensorList<const float, 1> rows = op::cpu::TensorList<const float, 1>::fromTensor(z);
+  CATCH_REQUIRE(rows.getLength() == 2 * 3 * 2);
+  Tensor row5 = z.subtensor(0).subtensor(0).subtensor(2).subtensor(1);
+  CATCH_REQUIRE(rows.getDataPtr(5) == row5.getData<float>());
+}
+
+CATCH_TEST_CASE("test tensor from external memory", "[core][nn][tensor]") {
+  std::vector<float> buffer(12);
+  for (int i = 0; i < 12; ++i) buffer[i] = static_cast<float>(i);
+
+  int numDeleted = 0;
+  auto deleter = [](void * /*ptr*/, void *ctx) { ++*reinterpret_cast<int *>(ctx); };
+
+  // a transposed (3, 4) buffer.
+  int64_t shape[] = {4, 3};
+  int64_t strides[] = {1, 4};
+  LTensor *tensor = lten_new_tensor_from_ptr(
+      2,
+      shape,
+      strides,
+      LTEN_DTYPE_FLOAT,
+      buffer.data(),
+      deleter,
+      &numDeleted);
+  CATCH_REQUIRE(tensor);
+
+  // transposed back to the (3, 4) contiguous buffer.
+  LTensor *view = lten_transpose(tensor, 0, 1);
+  CATCH_REQUIRE(lten_get_data_ptr(view) == buffer.data());
+
+  // values are read through the strides.
+  LTensor *x =
+      lten_apply_operator(tensor, nullptr, nullptr, nullptr, 0, 0, 0, 0, LTEN_OP_CONTIGUOUS);
+  const float *data = reinterpret_cast<const float *>(lten_get_data_ptr(x));
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      CATCH_REQUIRE(data[i * 3 + j] == buffer[j * 4 + i]);
+    }
+  }
+  lten_destroy_tensor(x);
+
+  // the deleter is called after the last reference.
+  lten_destroy_tensor(tensor);
+  CATCH_REQUIRE(numDeleted == 0);
+  lten_destroy_tensor(view);
+  CATCH_REQUIRE(numDeleted == 1);
+
+  // quantized dtype is rejected.
+  LTensor *qtensor = lten_new_tensor_from_ptr(
+      2,
+      shape,
+      nullptr,
+      LTEN_DTYPE_QINT4,
+      buffer.data(),
+      deleter,
+      &numDeleted);
+  CATCH_REQUIRE(!qtensor);
+  CATCH_REQUIRE(numDeleted == 1);
+
+  // the span of elements overflows.
+  int64_t largeShape[] = {int64_t(1) << 40, int64_t(1) << 40};
+  LTensor *ltensor = lten_new_tensor_from_ptr(
+      2,
+      largeShape,
+      nullptr,
+      LTEN_DTYPE_FLOAT,
+      buffer.data(),
+      deleter,
+      &numDeleted);
+  CATCH_REQUIRE(!ltensor);
+  CATCH_REQUIRE(numDeleted == 1);
+}
+
+CATCH_TEST_CASE("test in-place reuse and copy-on-write", "[core][nn][tensor]") {
+  Tensor x = F::rand({4, 8}, DType::kFloat);
+  Tensor ref = F::gelu(x);
+  CATCH_REQUIRE(ref.getData<float>() != x.getData<float>());
+
+  // the data of moved-in tensor is reused.
+  const float *ptr = x.getData<float>();
+  CATCH_REQUIRE(x.isDataExclusive());
+  Tensor y = F::gelu(std::move(x));
+  CATCH_REQUIRE(y.getData<float>() == ptr);
+  CATCH_REQUIRE(F::allClose(y, ref));
+
+  y = F::add(std::move(y), ref);
+  y = F::mul(std::move(y), 0.5f);
+  CATCH_REQUIRE(y.getData<float>() == ptr);
+  CATCH_REQUIRE(F::allClose(y, ref));
+
+  // shared by a view.
+  Tensor v = y.slice(1, {0, 4});
+  CATCH_REQUIRE(!y.isDataExclusive());
+  CATCH_REQUIRE(F::softmax(Tensor(y)).getData<float>() != ptr);
+
+  // copy-on-write of the view.
+  v.makeExclusive();
+  CATCH_REQUIRE(v.isDataExclusive());
+  CATCH_REQUIRE(v.isContiguous());
+  CATCH_REQUIRE(v.getData<float>() != ptr);
+  CATCH_REQUIRE(F::allClose(v, ref.slice(1, {0, 4})));
+
+  // no copy when the data is already exclusive.
+  CATCH_REQUIRE(y.isDataExclusive());
+  y.makeExclusive();
+  CATCH_REQUIRE(y.getData<float>() == ptr);
+}
+
+CATCH_TEST_CASE("test tensor read from mapped zip file", "[core][nn][tensor]") {
+  Tensor a = F::rand({16, 64}, DType::kFloat);
+  Tensor b = F::rand({8, 32}, DType::kFloat);
+
+  std::string zipData;
+  appendTensorZipEntry(&zipData, "a.tensor", a, 0);
+  appendTensorZipEntry(&zipData, "b.tensor", b, 4);
+
+  lut::Path dirname = lut::Path::currentExecutablePath().dirname();
+  std::string filename = (dirname / "test_mapped.zip").string();
+  writeFile(filename, zipData);
+
+  Tensor ma, mb;
+  const int8_t *expectedPtr = nullptr;
+  {
+    std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(filename);
+    std::shared_ptr<lut::Reader> reader = zipFile->open("a.tensor");
+
+    int64_t offset;
+    std::shared_ptr<lut::MappedFile> mappedFile = reader->getMappedFile(&offset);
+    CATCH_REQUIRE(mappedFile);
+    expectedPtr = mappedFile->getData().data() + offset + 32;
+
+    ma.read(reader.get());
+    mb.read(zipFile->open("b.tensor").get());
+  }
+
+  // the aligned data points into the mapping, which outlives the zip file.
+  CATCH_REQUIRE(reinterpret_cast<const int8_t *>(ma.getData<float>()) == expectedPtr);
+  CATCH_REQUIRE(!ma.isDataExclusive());
+  CATCH_REQUIRE(F::allClose(ma, a));
+
+  // the read-only mapping is never reused by the in-place operators.
+  Tensor ref = F::gelu(a);
+  CATCH_REQUIRE(F::allClose(F::gelu(std::move(ma)), ref));
+
+  // the misaligned data is copied.
+  CATCH_REQUIRE(mb.isDataExclusive());
+  CATCH_REQUIRE(reinterpret_cast<uintptr_t>(mb.getData<float>()) % 32 == 0);
+  CATCH_REQUIRE(F::allClose(mb, b));
+
+  remove(filename.c_str());
+}
+
+CATCH_TEST_CASE("test read tensors in parallel", "[core][nn][tensor]") {
+  constexpr int NumTensors = 32;
+
+  std::string zipData;
+  std::vector<std::string> names;
+  std::vector<Tensor> tensors;
+  for (int i = 0; i < NumTensors; ++i) {
+    Tensor x = F::cast(F::rand({i + 1, 64}, DType::kFloat), DType::kQInt4x32);
+    names.push_back(lut::sprintf("%d.tensor", i));
+    tensors.push_back(x);
+
+    // mix the mapped and copied tensors.
+    appendTensorZipEntry(&zipData, names.back(), x, i % 2 ? 4 : 0);
+  }
+
+  lut::Path dirname = lut::Path::currentExecutablePath().dirname();
+  std::string filename = (dirname / "test_parallel.zip").string();
+  writeFile(filename, zipData);
+
+  std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(filename);
+  std::vector<Tensor> readTensors = lten::readTensors(*zipFile, names);
+  std::vector<Tensor> readFloatTensors = lten::readTensors(*zipFile, names, DType::kFloat);
+  CATCH_REQUIRE(readTensors.size() == NumTensors);
+  CATCH_REQUIRE(readFloatTensors.size() == NumTensors);
+
+  for (int i = 0; i < NumTensors; ++i) {
+    Tensor x = F::cast(tensors[i], DType::kFloat);
+    CATCH_REQUIRE(readTensors[i].getDType() == DType::kQInt4x32);
+    CATCH_REQUIRE(F::allClose(F::cast(readTensors[i], DType::kFloat), x));
+    CATCH_REQUIRE(readFloatTensors[i].getDType() == DType::kFloat);
+    CATCH_REQUIRE(F::allClose(readFloatTensors[i], x));
+  }
+
+  // errors in the worker threads are thrown to the caller.
+  names.push_back("missing.tensor");
+  CATCH_REQUIRE_THROWS_AS(lten::readTensors(*zipFile, names), lut::AbortedError);
+
+  zipFile = nullptr;
+  remove(filename.c_str());
+}
+
+CATCH_TEST_CASE("benchmark tensor loading", "[.][benchmark][tensor]") {
+  constexpr int NumLoops = 5;
+
+  // 128MB tensor. It is stored misaligned, so the data is read into memory instead of mapped.
+  Tensor x = F::zeros({8192, 4096}, DType::kFloat);
+  std::string zipData;
+  appendTensorZipEntry(&zipData, "x.tensor", x, 4);
+
+  lut::Path dirname = lut::Path::currentExecutablePath().dirname();
+  std::string filename = (dirname / "benchmark_loading.zip").string();
+  writeFile(filename, zipData);
+  zipData = std::string();
+
+  std::shared_ptr<lut::ZipFile> zipFile = lut::ZipFile::fromFile(filename);
+
+  // warm up the page cache, so it measures the copies instead of the disk.
+  Tensor y;
+  y.read(zipFile->open("x.tensor").get());
+
+  double t0 = lut::now();
+  for (int i = 0; i < NumLoops; ++i) {
+    y = Tensor();
+    y.read(zipFile->open("x.tensor").get());
+  }
+
+  double dt = (lut::now() - t0) / NumLoops;
+  int64_t size = x.getNumEl() * sizeof(float);
+  LOG(INFO) << lut::sprintf("load tensor (%d MB): %.1f MB/s", size >> 20, size / dt / 1e6);
+
+  zipFile = nullptr;
+  remove(filename.c_str());
+}
+
+CATCH_TEST_CASE("test tensor with more than 2^31 elements", "[core][nn][tensor]") {
+  constexpr Tensor::ShapeType N = 65536;
+  TensorShape shape(lut::makeConstSpan<Tensor::ShapeType>({N, N, 2}));
+  CATCH_REQUIRE(shape.getNumEl() == N * N * 2);
+  CATCH_REQUIRE(shape.getStride(0) == N * 2);
+  CATCH_REQUIRE(shape.transpose(0, 2).getStride(2) == N * 2);
+
+  // only the shape and offset are checked, the 2^33 elements are never touched.
+  Tensor x = F::rand({N, 1, 2}, DType::kFloat);
+  Tensor z = Tensor::create(shape, x.getDataShared_());
+  Tensor s = z.view({-1}).slice({N * N, N * N + 2});
+  CATCH_REQUIRE(s.getShape(0) == 2);
+  CATCH_REQUIRE(s.getOffset_() == N * N);
+  CATCH_REQUIRE(z.subtensor(N - 1).getOffset_() == (N - 1) * N * 2);
+  Tensor v = z.slice(1, {1, N}).view({N, -1});
+  CATCH_REQUIRE(v.getShape(1) == N * 2 - 2);
+  CATCH_REQUIRE(v.getStride(0) == N * 2);
+
+  // strided iteration over more than 2^31 sub-tensors.
+  Tensor y = x.expand({N, N, 2}).transpose(0, 1);
+  CATCH_REQUIRE(y.getNumEl() == N * N * 2);
+  op::cpu::TensorList<const float, 1> rows = op::cpu::TensorList<const float, 1>::fromTensor(y);
+  CATCH_REQUIRE(rows.getLength() == N * N);
+  CATCH_REQUIRE(rows.getDataPtr(N * N - 1) == x.getData<float>() + (N - 1) * 2);
+}
+
 }  // namespace lten
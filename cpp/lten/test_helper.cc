@@ -19,9 +19,12 @@
 
 #include "lten/test_helper.h"
 
+#include <stdio.h>
+
 #include "catch2/catch_amalgamated.hpp"
 #include "lten/functional.h"
 #include "lten/tensor.h"
+#include "lutil/path.h"
 
 namespace lten {
 
@@ -68,6 +71,62 @@ bool ModuleTester::allClose(Tensor a, lut::Span<const float> ref) const {
   return allClose;
 }
 
+void appendTensorZipEntry(std::string *buffer, const std::string &name, Tensor x, int misalign) {
+  CATCH_REQUIRE(x.getDim() == 2);
+  CATCH_REQUIRE(x.isContiguous());
+
+  std::string entry = "tnsr";
+  appendValue<int16_t>(&entry, 2);
+  appendValue<int32_t>(&entry, static_cast<int32_t>(x.getShape(0)));
+  appendValue<int32_t>(&entry, static_cast<int32_t>(x.getShape(1)));
+  entry += "tdat";
+  appendValue<int32_t>(&entry, 1);
+  appendValue<int16_t>(&entry, x.getDType());
+  appendValue<int64_t>(&entry, x.getNumEl());
+  int64_t dataOffset = static_cast<int64_t>(entry.size());
+  entry.append(
+      reinterpret_cast<const char *>(x.getDataObject()->getSlot(0)->getRawData()),
+      x.getDType().getTotalSize(x.getNumEl()));
+  appendValue<int16_t>(&entry, 0x55aa);
+
+  // 30 bytes of local file header, the name, the extra field (at least 4 bytes for its header),
+  // then the entry.
+  int64_t offset = static_cast<int64_t>(buffer->size()) + 30 + name.size() + 4 + dataOffset;
+  int16_t extraSize = 4 + static_cast<int16_t>((32 + misalign - offset % 32) % 32);
+
+  appendValue<uint32_t>(buffer, 0x04034b50);
+  appendValue<uint16_t>(buffer, 10);  // version
+  appendValue<uint16_t>(buffer, 0);   // flag
+  appendValue<uint16_t>(buffer, 0);   // compression
+  appendValue<uint32_t>(buffer, 0);   // last modify time and date
+  appendValue<uint32_t>(buffer, 0);   // crc32
+  appendValue<uint32_t>(buffer, static_cast<uint32_t>(entry.size()));
+  appendValue<uint32_t>(buffer, static_cast<uint32_t>(entry.size()));
+  appendValue<uint16_t>(buffer, static_cast<uint16_t>(name.size()));
+  appendValue<uint16_t>(buffer, extraSize);
+  *buffer += name;
+  appendValue<uint16_t>(buffer, 0xcafe);
+  appendValue<uint16_t>(buffer, extraSize - 4);
+  buffer->append(extraSize - 4, '\0');
+  *buffer += entry;
+}
+
+void writeFile(const std::string &filename, const std::string &data) {
+  FILE *fp = fopen(filename.c_str(), "wb");
+  CATCH_REQUIRE(fp);
+  CATCH_REQUIRE(fwrite(data.data(), data.size(), 1, fp) == 1);
+  fclose(fp);
+}
+
+std::string getTestFilePath(const std::string &name) {
+  lut::Path dirname = lut::Path::currentExecutablePath().dirname();
+  return (dirname / name).string();
+}
+
+bool allCloseAsFloat(Tensor a, Tensor b) {
+  return F::allClose(F::cast(a, DType::kFloat), F::cast(b, DType::kFloat));
+}
+
 float ModuleTester::getRtol() const {
   DType defaultFloatType = F::getDefaultFloatType(getDevice());
   if (getDevice().getType() == Device::kCpu && defaultFloatType == DType::kFloat16) {
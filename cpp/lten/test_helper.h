@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "lten/cpu/fingerprint.h"
 #include "lten/tensor.h"
 #include "lten/test_helper.h"
@@ -75,4 +77,25 @@ class ModuleTester {
   lut::Random _random;
 };
 
+/// @brief Append the bytes of `value` to `buffer`, for building the files in test.
+template<typename T>
+void appendValue(std::string *buffer, T value) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/// @brief Append the 2D contiguous tensor `x` to `buffer` as a stored entry of zip file, in the
+/// format of Tensor::read(). The extra field is padded so that the tensor data begins at
+/// `misalign` bytes past a 32-byte boundary of the file.
+void appendTensorZipEntry(std::string *buffer, const std::string &name, Tensor x, int misalign);
+
+/// @brief Write `data` into file `filename`.
+void writeFile(const std::string &filename, const std::string &data);
+
+/// @brief Get the path of file `name` in the directory of the test executable.
+std::string getTestFilePath(const std::string &name);
+
+/// @brief allClose() of two tensors of any float type. They are compared in float32, since
+/// allClose() of float16 tensors is only implemented on aarch64.
+bool allCloseAsFloat(Tensor a, Tensor b);
+
 }  // namespace lten
@@ -0,0 +1,157 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lutil/crc32.h"
+
+#include <string.h>
+
+#include <array>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#define LUT_CRC32C_SSE42
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#define LUT_CRC32C_ARMV8
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+namespace lut {
+
+namespace {
+
+typedef std::array<std::array<uint32_t, 256>, 4> Crc32Table;
+
+// tables for slicing-by-4 of the reversed polynomial `poly`: table[0] is the byte-wise table,
+// table[k][i] is the CRC of byte i followed by k zero bytes.
+Crc32Table makeCrc32Table(uint32_t poly) {
+  Crc32Table table;
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1) ? poly ^ (c >> 1) : c >> 1;
+    }
+    table[0][i] = c;
+  }
+
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (int k = 1; k < 4; ++k) {
+      uint32_t c = table[k - 1][i];
+      table[k][i] = table[0][c & 0xff] ^ (c >> 8);
+    }
+  }
+
+  return table;
+}
+
+const Crc32Table gCrc32Table = makeCrc32Table(0xedb88320);
+const Crc32Table gCrc32cTable = makeCrc32Table(0x82f63b78);
+
+uint32_t crc32Slicing4(const Crc32Table &table, Span<const int8_t> data, uint32_t crc) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(data.data());
+  int64_t n = static_cast<int64_t>(data.size());
+
+  uint32_t c = ~crc;
+  for (; n >= 4; n -= 4, p += 4) {
+    c ^= static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    c = table[3][c & 0xff] ^ table[2][(c >> 8) & 0xff] ^ table[1][(c >> 16) & 0xff] ^
+        table[0][c >> 24];
+  }
+  for (; n > 0; --n, ++p) {
+    c = table[0][(c ^ *p) & 0xff] ^ (c >> 8);
+  }
+
+  return ~c;
+}
+
+#if defined(LUT_CRC32C_SSE42)
+
+// the file is built without -msse4.2, so the function is compiled for SSE4.2 alone and only
+// called after checking the CPU.
+__attribute__((target("sse4.2"))) uint32_t crc32cHardware(Span<const int8_t> data, uint32_t crc) {
+  const int8_t *p = data.data();
+  int64_t n = static_cast<int64_t>(data.size());
+
+  uint64_t c = ~crc;
+  for (; n >= 8; n -= 8, p += 8) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    c = _mm_crc32_u64(c, v);
+  }
+
+  uint32_t c32 = static_cast<uint32_t>(c);
+  for (; n > 0; --n, ++p) {
+    c32 = _mm_crc32_u8(c32, static_cast<uint8_t>(*p));
+  }
+
+  return ~c32;
+}
+
+bool isCrc32cHardwareSupported() {
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+}
+
+#elif defined(LUT_CRC32C_ARMV8)
+
+// the CRC32 instructions are optional in armv8.0-a. Like SSE4.2 above, the function is compiled
+// for the CRC extension alone and only called after checking the CPU.
+__attribute__((target("+crc"))) uint32_t crc32cHardware(Span<const int8_t> data, uint32_t crc) {
+  const int8_t *p = data.data();
+  int64_t n = static_cast<int64_t>(data.size());
+
+  uint32_t c = ~crc;
+  for (; n >= 8; n -= 8, p += 8) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    c = __crc32cd(c, v);
+  }
+  for (; n > 0; --n, ++p) {
+    c = __crc32cb(c, static_cast<uint8_t>(*p));
+  }
+
+  return ~c;
+}
+
+bool isCrc32cHardwareSupported() {
+  static const bool supported = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+  return supported;
+}
+
+#endif
+
+}  // namespace
+
+uint32_t crc32(Span<const int8_t> data, uint32_t crc) {
+  return crc32Slicing4(gCrc32Table, data, crc);
+}
+
+uint32_t crc32c(Span<const int8_t> data, uint32_t crc) {
+#if defined(LUT_CRC32C_SSE42) || defined(LUT_CRC32C_ARMV8)
+  if (isCrc32cHardwareSupported()) return crc32cHardware(data, crc);
+#endif
+
+  return crc32Slicing4(gCrc32cTable, data, crc);
+}
+
+}  // namespace lut
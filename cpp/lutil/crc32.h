@@ -0,0 +1,36 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "lutil/span.h"
+
+namespace lut {
+
+// CRC-32 (the polynomial used by zip and zlib) of `data`. To compute the CRC of a stream chunk by
+// chunk, pass the result of the previous chunk as `crc`.
+uint32_t crc32(Span<const int8_t> data, uint32_t crc = 0);
+
+// CRC-32C (Castagnoli) of `data`, chained the same way as crc32(). It uses the CRC32 instructions
+// of SSE4.2 or ARMv8 when the CPU supports them.
+uint32_t crc32c(Span<const int8_t> data, uint32_t crc = 0);
+
+}  // namespace lut
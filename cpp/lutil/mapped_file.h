@@ -0,0 +1,53 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2024 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "lutil/noncopyable.h"
+#include "lutil/span.h"
+
+namespace lut {
+
+// read-only memory mapping of a whole file. The pages are loaded from the page cache on demand,
+// so the data is shared between the processes mapping the same file and no copy is made until
+// it is accessed.
+class MappedFile : private NonCopyable {
+ public:
+  class Impl;
+
+  ~MappedFile();
+
+  // map the file `filename` into memory. Throw AbortedError if failed.
+  static std::shared_ptr<MappedFile> open(const std::string &filename);
+
+  // get the mapped data of the whole file. The begin of the data is aligned to the page size.
+  Span<const int8_t> getData() const;
+
+ private:
+  std::unique_ptr<Impl> _impl;
+
+  MappedFile();
+};
+
+}  // namespace lut
@@ -0,0 +1,106 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2024 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lutil/error.h"
+#include "lutil/mapped_file.h"
+#include "lutil/strings.h"
+
+namespace lut {
+
+class MappedFile::Impl {
+ public:
+  Impl();
+  ~Impl();
+
+  static std::unique_ptr<Impl> open(const std::string &filename);
+  Span<const int8_t> getData() const;
+
+ private:
+  void *_data;
+  int64_t _size;
+};
+
+MappedFile::Impl::Impl()
+    : _data(nullptr),
+      _size(0) {
+}
+
+MappedFile::Impl::~Impl() {
+  if (_data) {
+    munmap(_data, _size);
+    _data = nullptr;
+  }
+}
+
+std::unique_ptr<MappedFile::Impl> MappedFile::Impl::open(const std::string &filename) {
+  std::unique_ptr<Impl> impl{new Impl()};
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) THROW(Aborted, lut::sprintf("unable to open file %s", filename));
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    THROW(Aborted, lut::sprintf("unable to stat file %s", filename));
+  }
+
+  // mmap() rejects the zero-length mapping, keep the data empty for an empty file.
+  impl->_size = st.st_size;
+  if (impl->_size > 0) {
+    void *data = mmap(nullptr, impl->_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      THROW(Aborted, lut::sprintf("unable to map file %s", filename));
+    }
+
+    impl->_data = data;
+  }
+
+  // the mapping holds its own reference to the file.
+  close(fd);
+  return impl;
+}
+
+Span<const int8_t> MappedFile::Impl::getData() const {
+  return Span<const int8_t>(reinterpret_cast<const int8_t *>(_data), _size);
+}
+
+// -- class MappedFile ----------
+
+MappedFile::MappedFile() {
+}
+MappedFile::~MappedFile() {
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &filename) {
+  std::shared_ptr<MappedFile> mappedFile{new MappedFile()};
+  mappedFile->_impl = Impl::open(filename);
+  return mappedFile;
+}
+
+Span<const int8_t> MappedFile::getData() const {
+  return _impl->getData();
+}
+
+}  // namespace lut
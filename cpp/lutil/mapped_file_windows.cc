@@ -0,0 +1,119 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2024 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <windows.h>
+
+#include "lutil/error.h"
+#include "lutil/mapped_file.h"
+#include "lutil/path.h"
+#include "lutil/strings.h"
+
+namespace lut {
+
+class MappedFile::Impl {
+ public:
+  Impl();
+  ~Impl();
+
+  static std::unique_ptr<Impl> open(const std::string &filename);
+  Span<const int8_t> getData() const;
+
+ private:
+  void *_data;
+  int64_t _size;
+};
+
+MappedFile::Impl::Impl()
+    : _data(nullptr),
+      _size(0) {
+}
+
+MappedFile::Impl::~Impl() {
+  if (_data) {
+    UnmapViewOfFile(_data);
+    _data = nullptr;
+  }
+}
+
+std::unique_ptr<MappedFile::Impl> MappedFile::Impl::open(const std::string &filename) {
+  std::unique_ptr<Impl> impl{new Impl()};
+
+  HANDLE hFile = CreateFileW(
+      Path(filename).wstring().c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (hFile == INVALID_HANDLE_VALUE) {
+    THROW(Aborted, lut::sprintf("unable to open file %s", filename));
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(hFile, &size)) {
+    CloseHandle(hFile);
+    THROW(Aborted, lut::sprintf("unable to get size of file %s", filename));
+  }
+
+  // CreateFileMapping() rejects the empty file, keep the data empty for it.
+  impl->_size = size.QuadPart;
+  if (impl->_size > 0) {
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hMapping) {
+      CloseHandle(hFile);
+      THROW(Aborted, lut::sprintf("unable to map file %s", filename));
+    }
+
+    impl->_data = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+    // the view holds its own references to the mapping and the file.
+    CloseHandle(hMapping);
+    if (!impl->_data) {
+      CloseHandle(hFile);
+      THROW(Aborted, lut::sprintf("unable to map file %s", filename));
+    }
+  }
+
+  CloseHandle(hFile);
+  return impl;
+}
+
+Span<const int8_t> MappedFile::Impl::getData() const {
+  return Span<const int8_t>(reinterpret_cast<const int8_t *>(_data), _size);
+}
+
+// -- class MappedFile ----------
+
+MappedFile::MappedFile() {
+}
+MappedFile::~MappedFile() {
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &filename) {
+  std::shared_ptr<MappedFile> mappedFile{new MappedFile()};
+  mappedFile->_impl = Impl::open(filename);
+  return mappedFile;
+}
+
+Span<const int8_t> MappedFile::getData() const {
+  return _impl->getData();
+}
+
+}  // namespace lut
@@ -0,0 +1,58 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "lutil/span.h"
+
+namespace lut {
+
+/// @brief A NUMA node with its online CPUs.
+struct NumaNode {
+  int id;
+  std::vector<int> cpus;
+};
+
+/// @brief Get the NUMA nodes that have CPUs. On Linux they are read from
+/// /sys/devices/system/node, no libnuma is required. On other platforms, or when the information
+/// is not available, a single node 0 with all the CPUs is returned.
+const std::vector<NumaNode> &getNumaNodes();
+
+/// @brief Parse the CPU or node list in sysfs format, like "0-3,8,10-11".
+std::vector<int> parseCpuList(const std::string &s);
+
+/// @brief Bind current thread to the given CPUs. Returns false if not supported or failed.
+bool bindCurrentThreadToCpus(lut::Span<const int> cpus);
+
+/// @brief Move the pages inside [ptr, ptr + size) to NUMA node `node` and bind them there (mbind
+/// with MPOL_BIND and MPOL_MF_MOVE). The partial pages at the two ends are not bound, they stay
+/// on the node of first touch. Returns false if not supported or failed.
+bool bindMemoryToNode(void *ptr, int64_t size, int node);
+
+/// @brief Interleave the pages inside [ptr, ptr + size) over `nodes`, the partial pages at the two
+/// ends are not changed. The pages already faulted are moved. Returns false if not supported or
+/// failed.
+bool interleaveMemory(void *ptr, int64_t size, lut::Span<const int> nodes);
+
+}  // namespace lut
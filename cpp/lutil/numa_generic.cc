@@ -0,0 +1,54 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NUMA functions for the platforms without NUMA support: there is only one node.
+
+#include <thread>
+
+#include "lutil/numa.h"
+
+namespace lut {
+
+const std::vector<NumaNode> &getNumaNodes() {
+  static std::vector<NumaNode> nodes = []() {
+    NumaNode node;
+    node.id = 0;
+    for (int i = 0; i < static_cast<int>(std::thread::hardware_concurrency()); ++i) {
+      node.cpus.push_back(i);
+    }
+
+    return std::vector<NumaNode>{node};
+  }();
+
+  return nodes;
+}
+
+bool bindCurrentThreadToCpus(lut::Span<const int> cpus) {
+  return false;
+}
+
+bool bindMemoryToNode(void *ptr, int64_t size, int node) {
+  return false;
+}
+
+bool interleaveMemory(void *ptr, int64_t size, lut::Span<const int> nodes) {
+  return false;
+}
+
+}  // namespace lut
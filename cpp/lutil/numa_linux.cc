@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <thread>
+
+#include "lutil/numa.h"
+#include "lutil/strings.h"
+
+namespace lut {
+
+namespace {
+
+// constants of mbind(2). They are defined here since <numaif.h> belongs to libnuma.
+constexpr int MpolBind = 2;
+constexpr int MpolInterleave = 3;
+constexpr unsigned MpolMfMove = 1 << 1;
+constexpr int MaxNumaNodes = 256;
+constexpr int64_t PageSize = 4096;
+
+std::string readSysFile(const std::string &filename) {
+  FILE *fp = fopen(filename.c_str(), "r");
+  if (!fp) return "";
+
+  char line[4096] = "";
+  if (!fgets(line, sizeof(line), fp)) line[0] = '\0';
+  fclose(fp);
+
+  return lut::trim(line);
+}
+
+std::vector<NumaNode> readNumaNodes() {
+  std::vector<NumaNode> nodes;
+  for (int id : parseCpuList(readSysFile("/sys/devices/system/node/online"))) {
+    NumaNode node;
+    node.id = id;
+    node.cpus = parseCpuList(
+        readSysFile(lut::sprintf("/sys/devices/system/node/node%d/cpulist", id)));
+
+    // memory-only nodes are ignored.
+    if (!node.cpus.empty()) nodes.emplace_back(std::move(node));
+  }
+
+  if (nodes.empty()) {
+    NumaNode node;
+    node.id = 0;
+    for (int i = 0; i < static_cast<int>(std::thread::hardware_concurrency()); ++i) {
+      node.cpus.push_back(i);
+    }
+    nodes.emplace_back(std::move(node));
+  }
+
+  return nodes;
+}
+
+bool mbindNodes(void *ptr, int64_t size, int mode, lut::Span<const int> nodes) {
+  unsigned long nodeMask[MaxNumaNodes / (8 * sizeof(unsigned long))] = {0};
+  constexpr int BitsPerWord = 8 * sizeof(unsigned long);
+  for (int node : nodes) {
+    if (node < 0 || node >= MaxNumaNodes) return false;
+    nodeMask[node / BitsPerWord] |= 1UL << (node % BitsPerWord);
+  }
+
+  // mbind requires page aligned address. Only the pages inside the range are bound, since a page
+  // on the boundary may be shared with the neighbouring range bound to another node.
+  uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+  begin = (begin + PageSize - 1) / PageSize * PageSize;
+  uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) / PageSize * PageSize;
+  if (begin >= end) return true;
+
+  long ret = syscall(
+      SYS_mbind,
+      reinterpret_cast<void *>(begin),
+      static_cast<unsigned long>(end - begin),
+      mode,
+      nodeMask,
+      static_cast<unsigned long>(MaxNumaNodes + 1),
+      MpolMfMove);
+  return ret == 0;
+}
+
+}  // namespace
+
+const std::vector<NumaNode> &getNumaNodes() {
+  static std::vector<NumaNode> nodes = readNumaNodes();
+  return nodes;
+}
+
+bool bindCurrentThreadToCpus(lut::Span<const int> cpus) {
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    CPU_SET(cpu, &cpuSet);
+  }
+
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+bool bindMemoryToNode(void *ptr, int64_t size, int node) {
+  return mbindNodes(ptr, size, MpolBind, {node});
+}
+
+bool interleaveMemory(void *ptr, int64_t size, lut::Span<const int> nodes) {
+  return mbindNodes(ptr, size, MpolInterleave, nodes);
+}
+
+}  // namespace lut
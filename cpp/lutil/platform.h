@@ -28,6 +28,25 @@ namespace lut {
 
 void *alloc32ByteAlignedMem(int64_t nbytes);
 void free32ByteAlignedMem(void *);
+
+/// @brief Size of the huge pages used by allocHugePageMem().
+constexpr int64_t HugePageSize = 2 * 1024 * 1024;
+
+/// @brief Allocate memory aligned to HugePageSize for large and long-lived buffers. If
+/// `useHugeTlb` is true, try the reserved huge pages (MAP_HUGETLB) first. Otherwise, or if it
+/// failed, the memory is mapped normally and advised to be backed by transparent huge pages
+/// (MADV_HUGEPAGE). On the platforms without huge page support it falls back to aligned memory.
+/// @param size bytes to allocate.
+/// @param useHugeTlb try MAP_HUGETLB first.
+/// @param isHugeTlb output if the memory is from MAP_HUGETLB. Should be passed to
+///     freeHugePageMem().
+/// @return the memory, or nullptr if failed.
+void *allocHugePageMem(int64_t size, bool useHugeTlb, bool *isHugeTlb);
+void freeHugePageMem(void *ptr, int64_t size, bool isHugeTlb);
+
+/// @brief Get the number of transparent huge pages (AnonHugePages) of all the mappings in the
+/// process, not only the ones from allocHugePageMem(). -1 if not available.
+int64_t getNumProcessTransparentHugePages();
 const char *getPathDelim();
 
 }  // namespace lut
@@ -17,7 +17,10 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 
 #include "lutil/platform.h"
 
@@ -34,6 +37,78 @@ void free32ByteAlignedMem(void *ptr) {
   free(ptr);
 }
 
+void *allocHugePageMem(int64_t size, bool useHugeTlb, bool *isHugeTlb) {
+  *isHugeTlb = false;
+
+#ifdef MAP_HUGETLB
+  if (useHugeTlb) {
+    int64_t mapSize = (size + HugePageSize - 1) / HugePageSize * HugePageSize;
+    void *ptr = mmap(
+        nullptr,
+        mapSize,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0);
+    if (ptr != MAP_FAILED) {
+      *isHugeTlb = true;
+      return ptr;
+    }
+  }
+#endif  // MAP_HUGETLB
+
+  // map one more huge page, then unmap the unaligned head and tail.
+  int64_t pageSize = 4096;
+  int64_t mapSize = (size + pageSize - 1) / pageSize * pageSize;
+  int64_t reserveSize = mapSize + HugePageSize;
+  void *base = mmap(
+      nullptr,
+      reserveSize,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (base == MAP_FAILED) return nullptr;
+
+  uintptr_t baseAddr = reinterpret_cast<uintptr_t>(base);
+  uintptr_t addr = (baseAddr + HugePageSize - 1) / HugePageSize * HugePageSize;
+  int64_t headSize = addr - baseAddr;
+  int64_t tailSize = reserveSize - headSize - mapSize;
+  if (headSize) munmap(base, headSize);
+  if (tailSize) munmap(reinterpret_cast<void *>(addr + mapSize), tailSize);
+
+  void *ptr = reinterpret_cast<void *>(addr);
+#ifdef MADV_HUGEPAGE
+  madvise(ptr, mapSize, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+
+  return ptr;
+}
+
+void freeHugePageMem(void *ptr, int64_t size, bool isHugeTlb) {
+  int64_t pageSize = isHugeTlb ? HugePageSize : 4096;
+  int64_t mapSize = (size + pageSize - 1) / pageSize * pageSize;
+  munmap(ptr, mapSize);
+}
+
+int64_t getNumProcessTransparentHugePages() {
+  FILE *fp = fopen("/proc/self/smaps_rollup", "r");
+  if (!fp) fp = fopen("/proc/self/smaps", "r");
+  if (!fp) return -1;
+
+  // sum the AnonHugePages of all mappings.
+  char line[256];
+  int64_t numKb = 0;
+  while (fgets(line, sizeof(line), fp)) {
+    if (strncmp(line, "AnonHugePages:", 14) == 0) {
+      numKb += strtoll(line + 14, nullptr, 10);
+    }
+  }
+  fclose(fp);
+
+  return numKb * 1024 / HugePageSize;
+}
+
 const char *getPathDelim() {
   return "/";
 }
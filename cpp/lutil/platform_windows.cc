@@ -31,6 +31,19 @@ void free32ByteAlignedMem(void *ptr) {
   _aligned_free(ptr);
 }
 
+void *allocHugePageMem(int64_t size, bool useHugeTlb, bool *isHugeTlb) {
+  *isHugeTlb = false;
+  return _aligned_malloc(size, HugePageSize);
+}
+
+void freeHugePageMem(void *ptr, int64_t size, bool isHugeTlb) {
+  _aligned_free(ptr);
+}
+
+int64_t getNumProcessTransparentHugePages() {
+  return -1;
+}
+
 const char *getPathDelim() {
   return "\\";
 }
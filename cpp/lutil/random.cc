@@ -84,6 +84,10 @@ void Random::reset(uint64_t seed) {
   _x = seed % RandMax;
 }
 
+uint64_t Random::getState() const {
+  return _x;
+}
+
 void Random::fillGaussian(Span<float> l, float mean, float sigma) {
   std::vector<float> U(l.size() * 2);
   fill(lut::makeSpan(U), 0.0f, 1.0f);
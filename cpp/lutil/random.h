@@ -59,6 +59,9 @@ class Random {
   // reset the random number generator.
   void reset(uint64_t seed);
 
+  // get the internal state. reset(getState()) restores the generator to the current point.
+  uint64_t getState() const;
+
  private:
   uint64_t _x;
 };
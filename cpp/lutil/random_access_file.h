@@ -0,0 +1,57 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2024 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "lutil/noncopyable.h"
+#include "lutil/span.h"
+
+namespace lut {
+
+// file for reading at arbitrary offsets. Different from the FILE* with fseek, reads do not share
+// a file position, so multiple threads could read the same file concurrently.
+class RandomAccessFile : private NonCopyable {
+ public:
+  class Impl;
+
+  ~RandomAccessFile();
+
+  // open the file for reading. Throw AbortedError if failed.
+  static std::shared_ptr<RandomAccessFile> open(const std::string &filename);
+
+  // read `buffer.size()` bytes at `offset` of the file. Throw OutOfRangeError if EOF reached and
+  // AbortedError for other errors. It is thread-safe.
+  void readAt(int64_t offset, Span<int8_t> buffer) const;
+
+  // hint that [offset, offset + length) will be read soon, so that the OS could start reading it
+  // into the page cache in background. It may do nothing on some platforms.
+  void adviseWillNeed(int64_t offset, int64_t length) const;
+
+ private:
+  std::unique_ptr<Impl> _impl;
+
+  RandomAccessFile();
+};
+
+}  // namespace lut
@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2024 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lutil/attributes.h"
+#include "lutil/error.h"
+#include "lutil/random_access_file.h"
+#include "lutil/strings.h"
+
+namespace lut {
+
+class RandomAccessFile::Impl {
+ public:
+  Impl();
+  ~Impl();
+
+  static std::unique_ptr<Impl> open(const std::string &filename);
+  void readAt(int64_t offset, Span<int8_t> buffer) const;
+  void adviseWillNeed(int64_t offset, int64_t length) const;
+
+ private:
+  int _fd;
+};
+
+RandomAccessFile::Impl::Impl()
+    : _fd(-1) {
+}
+
+RandomAccessFile::Impl::~Impl() {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+std::unique_ptr<RandomAccessFile::Impl> RandomAccessFile::Impl::open(const std::string &filename) {
+  std::unique_ptr<Impl> impl{new Impl()};
+  impl->_fd = ::open(filename.c_str(), O_RDONLY);
+  if (impl->_fd < 0) THROW(Aborted, lut::sprintf("unable to open file %s", filename));
+
+  return impl;
+}
+
+void RandomAccessFile::Impl::readAt(int64_t offset, Span<int8_t> buffer) const {
+  int8_t *data = buffer.data();
+  int64_t nRemain = static_cast<int64_t>(buffer.size());
+
+  // pread() may return less bytes than requested, for example, the large reads are capped to
+  // about 2GB by Linux.
+  while (nRemain > 0) {
+    ssize_t n = pread(_fd, data, nRemain, offset);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) THROW(Aborted, "failed to read file.");
+    if (n == 0) throw OutOfRangeError("unexcpected EOF");
+
+    data += n;
+    offset += n;
+    nRemain -= n;
+  }
+}
+
+void RandomAccessFile::Impl::adviseWillNeed(int64_t offset, int64_t length) const {
+#ifdef LUT_PLATFORM_LINUX
+  posix_fadvise(_fd, offset, length, POSIX_FADV_WILLNEED);
+#endif
+}
+
+// -- class RandomAccessFile ----------
+
+RandomAccessFile::RandomAccessFile() {
+}
+RandomAccessFile::~RandomAccessFile() {
+}
+
+std::shared_ptr<RandomAccessFile> RandomAccessFile::open(const std::string &filename) {
+  std::shared_ptr<RandomAccessFile> file{new RandomAccessFile()};
+  file->_impl = Impl::open(filename);
+  return file;
+}
+
+void RandomAccessFile::readAt(int64_t offset, Span<int8_t> buffer) const {
+  _impl->readAt(offset, buffer);
+}
+
+void RandomAccessFile::adviseWillNeed(int64_t offset, int64_t length) const {
+  _impl->adviseWillNeed(offset, length);
+}
+
+}  // namespace lut
@@ -0,0 +1,117 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2024 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <windows.h>
+
+#include <algorithm>
+
+#include "lutil/error.h"
+#include "lutil/path.h"
+#include "lutil/random_access_file.h"
+#include "lutil/strings.h"
+
+namespace lut {
+
+class RandomAccessFile::Impl {
+ public:
+  Impl();
+  ~Impl();
+
+  static std::unique_ptr<Impl> open(const std::string &filename);
+  void readAt(int64_t offset, Span<int8_t> buffer) const;
+
+ private:
+  HANDLE _handle;
+};
+
+RandomAccessFile::Impl::Impl()
+    : _handle(INVALID_HANDLE_VALUE) {
+}
+
+RandomAccessFile::Impl::~Impl() {
+  if (_handle != INVALID_HANDLE_VALUE) {
+    CloseHandle(_handle);
+    _handle = INVALID_HANDLE_VALUE;
+  }
+}
+
+std::unique_ptr<RandomAccessFile::Impl> RandomAccessFile::Impl::open(const std::string &filename) {
+  std::unique_ptr<Impl> impl{new Impl()};
+  impl->_handle = CreateFileW(
+      Path(filename).wstring().c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+      nullptr);
+  if (impl->_handle == INVALID_HANDLE_VALUE) {
+    THROW(Aborted, lut::sprintf("unable to open file %s", filename));
+  }
+
+  return impl;
+}
+
+void RandomAccessFile::Impl::readAt(int64_t offset, Span<int8_t> buffer) const {
+  int8_t *data = buffer.data();
+  int64_t nRemain = static_cast<int64_t>(buffer.size());
+
+  // for the synchronous handle, ReadFile() reads at the offset in OVERLAPPED, which makes it
+  // equivalent to pread(). The size of each read is limited to DWORD.
+  while (nRemain > 0) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xffffffff);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD nRead = 0;
+    DWORD nToRead = static_cast<DWORD>(std::min<int64_t>(nRemain, 1 << 30));
+    if (!ReadFile(_handle, data, nToRead, &nRead, &overlapped)) {
+      if (GetLastError() == ERROR_HANDLE_EOF) throw OutOfRangeError("unexcpected EOF");
+      THROW(Aborted, "failed to read file.");
+    }
+    if (nRead == 0) throw OutOfRangeError("unexcpected EOF");
+
+    data += nRead;
+    offset += nRead;
+    nRemain -= nRead;
+  }
+}
+
+// -- class RandomAccessFile ----------
+
+RandomAccessFile::RandomAccessFile() {
+}
+RandomAccessFile::~RandomAccessFile() {
+}
+
+std::shared_ptr<RandomAccessFile> RandomAccessFile::open(const std::string &filename) {
+  std::shared_ptr<RandomAccessFile> file{new RandomAccessFile()};
+  file->_impl = Impl::open(filename);
+  return file;
+}
+
+void RandomAccessFile::readAt(int64_t offset, Span<int8_t> buffer) const {
+  _impl->readAt(offset, buffer);
+}
+
+void RandomAccessFile::adviseWillNeed(int64_t offset, int64_t length) const {
+  // the handle is opened with FILE_FLAG_RANDOM_ACCESS, no range hint for ReadFile().
+}
+
+}  // namespace lut
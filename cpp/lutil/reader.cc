@@ -19,10 +19,16 @@
 
 #include "lutil/reader.h"
 
+#include "lutil/attributes.h"
 #include "lutil/error.h"
 #include "lutil/log.h"
+#include "lutil/mapped_file.h"
 #include "lutil/strings.h"
 
+#ifdef LUT_PLATFORM_LINUX
+#include <fcntl.h>
+#endif
+
 namespace lut {
 
 // -- class Reader -------------------------------------------------------------------------
@@ -56,6 +62,20 @@ void Reader::readSpan(Span<int8_t> span) {
   int64_t bytesRead = readFromBuffer(span);
 
   while (bytesRead < static_cast<int64_t>(span.size())) {
+    int64_t nRemain = static_cast<int64_t>(span.size()) - bytesRead;
+
+    // the buffer is empty here. For the remaining data not less than the buffer, read it into
+    // `span` directly instead of copying it twice through the buffer.
+    if (nRemain >= static_cast<int64_t>(_buffer.size())) {
+      int64_t n = readData(span.subspan(bytesRead));
+      if (!n) {
+        throw OutOfRangeError("unexcpected EOF");
+      }
+
+      bytesRead += n;
+      continue;
+    }
+
     int64_t n = readNextBuffer();
     if (!n) {
       throw OutOfRangeError("unexcpected EOF");
@@ -96,6 +116,41 @@ std::string Reader::readLine() {
   NOT_IMPL();
 }
 
+void Reader::skip(int64_t n) {
+  CHECK(n >= 0);
+  int64_t nBuffer = std::min(n, _w - _r);
+  _r += nBuffer;
+
+  if (n > nBuffer) skipData(n - nBuffer);
+}
+
+void Reader::skipData(int64_t n) {
+  while (n > 0) {
+    int64_t nBlock = std::min(n, static_cast<int64_t>(_buffer.size()));
+    int64_t nRead = readData(makeSpan(_buffer).subspan(0, nBlock));
+    if (!nRead) throw OutOfRangeError("unexcpected EOF");
+
+    n -= nRead;
+  }
+}
+
+std::shared_ptr<MappedFile> Reader::getMappedFile(int64_t *offset) {
+  int64_t pos = 0;
+  std::shared_ptr<MappedFile> mappedFile = getMappedFileImpl(&pos);
+  if (!mappedFile) return nullptr;
+
+  // the bytes remaining in buffer are already consumed from the underlying stream.
+  *offset = pos - (_w - _r);
+  return mappedFile;
+}
+
+std::shared_ptr<MappedFile> Reader::getMappedFileImpl(int64_t * /*pos*/) {
+  return nullptr;
+}
+
+void Reader::adviseSequential() {
+}
+
 // -- class ReadableFile ---------------------------------------------------------------------------
 
 ReadableFile::ReadableFile()
@@ -118,6 +173,13 @@ std::unique_ptr<ReadableFile> ReadableFile::open(const std::string &filename) {
   return fp;
 }
 
+void ReadableFile::adviseSequential() {
+#ifdef LUT_PLATFORM_LINUX
+  // doubles the readahead window of the file.
+  posix_fadvise(fileno(_fp), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
 int64_t ReadableFile::readData(Span<int8_t> buffer) {
   CHECK(buffer.size() != 0);
   size_t n = fread(buffer.data(), sizeof(int8_t), buffer.size(), _fp);
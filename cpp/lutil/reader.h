@@ -32,6 +32,8 @@
 
 namespace lut {
 
+class MappedFile;
+
 // -----------------------------------------------------------------------------------------------+
 // class Reader                                                                                   |
 // -----------------------------------------------------------------------------------------------+
@@ -44,6 +46,7 @@ class Reader {
   Reader(int buffer_size = kDefaultBufferSize);
 
   // read `buffer.size()` bytes and fill the `buffer`. Throw if EOF reached or other errors occured.
+  // Large spans are read into `buffer` directly, bypassing the internal buffer.
   void readSpan(Span<int8_t> buffer);
 
   // read a variable from reader
@@ -57,11 +60,31 @@ class Reader {
   // other error occurs.
   std::string readLine();
 
+  // skip the next `n` bytes. Throw if EOF reached or other errors occured.
+  void skip(int64_t n);
+
+  // if the stream is backed by a memory mapped file, return the mapped file and store the offset
+  // of the next byte to read into `offset`. Otherwise, return nullptr. It allows the callers to
+  // access the data in place instead of copying it through readSpan().
+  std::shared_ptr<MappedFile> getMappedFile(int64_t *offset);
+
+  // hint that the remaining data will be read sequentially, so that the OS could read ahead more
+  // aggressively. It does nothing by default.
+  virtual void adviseSequential();
+
  protected:
   // Implemented by sub classes. Read a span from file and return number of bytes read. On EOF
   // reached, returns 0. Throw exceptions if other errors occured.
   virtual int64_t readData(Span<int8_t> buffer) = 0;
 
+  // skip `n` bytes in the underlying stream. The default implementation reads and drops the data,
+  // sub classes could override it with a seek. Throw if EOF reached.
+  virtual void skipData(int64_t n);
+
+  // return the mapped file backing the stream and store the offset of the underlying stream
+  // position into `pos`. Returns nullptr by default.
+  virtual std::shared_ptr<MappedFile> getMappedFileImpl(int64_t *pos);
+
  private:
   FixedArray<int8_t> _buffer;
 
@@ -98,6 +121,9 @@ class ReadableFile : public Reader {
   ReadableFile(ReadableFile &) = delete;
   ReadableFile &operator=(ReadableFile &) = delete;
 
+  // implements interface Reader
+  void adviseSequential() override;
+
  protected:
   // implements interface Reader
   int64_t readData(Span<int8_t> buffer) override;
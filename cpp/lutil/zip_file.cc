@@ -24,17 +24,12 @@
 #include <memory>
 
 #include "lutil/error.h"
+#include "lutil/log.h"
+#include "lutil/mapped_file.h"
+#include "lutil/random_access_file.h"
 #include "lutil/reader.h"
 #include "lutil/strings.h"
 
-#ifdef _MSC_VER
-#define FSEEK64 _fseeki64
-#elif _FILE_OFFSET_BITS == 64
-#define FSEEK64 fseeko
-#else
-#define FSEEK64 fseeko64
-#endif  // _MSC_VER
-
 namespace lut {
 
 class ZipFile::Impl {
@@ -50,16 +45,25 @@ class ZipFile::Impl {
   void open(const std::string &path);
   std::vector<std::string> getList() const;
   StoreZipMeta getFileMeta(const std::string &name) const;
-  FILE *getFp();
+  // get the file for the positional reads of entries.
+  std::shared_ptr<RandomAccessFile> getFile();
+
+  // get the memory mapping of the whole zip file, nullptr if the file could not be mapped.
+  std::shared_ptr<MappedFile> getMappedFile();
 
  private:
+  // only used to parse the headers in open().
   FILE *_fp;
+
+  std::shared_ptr<RandomAccessFile> _file;
+  std::shared_ptr<MappedFile> _mappedFile;
   std::map<std::string, StoreZipMeta> _filemetas;
 
   int close();
 };
 
-// reader for a file inside the zip file.
+// reader for a file inside the zip file. Each reader keeps its own position and reads with
+// RandomAccessFile, so the readers of different entries could be used concurrently.
 class ZipFile::FileReader : public Reader {
  public:
   FileReader();
@@ -67,15 +71,20 @@ class ZipFile::FileReader : public Reader {
 
   void init(std::shared_ptr<ZipFile::Impl> zipFile, const std::string &filename);
 
+  // implements interface Reader
+  void adviseSequential() override;
+
  protected:
   // implements interface Reader
   int64_t readData(Span<int8_t> buffer) override;
+  void skipData(int64_t n) override;
+  std::shared_ptr<MappedFile> getMappedFileImpl(int64_t *pos) override;
 
  private:
   // We need to hold a pointer to the zip file to prevent it from being destructed before the file
   // reader.
   std::shared_ptr<ZipFile::Impl> _zipFile;
-  FILE *_fp;
+  std::shared_ptr<RandomAccessFile> _file;
   Impl::StoreZipMeta _fileMeta;
   int64_t _pos;
   std::string _filename;
@@ -105,13 +114,6 @@ PACK(struct local_file_header {
   uint16_t extra_field_length;
 });
 
-PACK(struct zip64_extended_extra_field {
-  uint64_t uncompressed_size;
-  uint64_t compressed_size;
-  uint64_t lfh_offset;
-  uint32_t disk_number;
-});
-
 PACK(struct central_directory_file_header {
   uint16_t version_made;
   uint16_t version;
@@ -209,7 +211,7 @@ void ZipFile::Impl::open(const std::string &path) {
       uint64_t compressed_size = lfh.compressed_size;
       uint64_t uncompressed_size = lfh.uncompressed_size;
       if (compressed_size == 0xffffffff && uncompressed_size == 0xffffffff) {
-        uint16_t extra_offset = 0;
+        int extra_offset = 0;
         while (extra_offset < lfh.extra_field_length) {
           uint16_t extra_id;
           uint16_t extra_size;
@@ -225,25 +227,32 @@ void ZipFile::Impl::open(const std::string &path) {
 
           if (extra_id != 0x0001) {
             // skip this extra field block
-            fseek(_fp, extra_size - 4, SEEK_CUR);
-            extra_offset += extra_size;
+            fseek(_fp, extra_size, SEEK_CUR);
+            extra_offset += 4 + extra_size;
             continue;
           }
 
-          // zip64 extra field
-          zip64_extended_extra_field zip64_eef;
-          n = fread((char *)&zip64_eef, sizeof(zip64_eef), 1, _fp);
+          // zip64 extra field. In local file header it only contains the sizes.
+          uint64_t sizes[2];
+          if (extra_size < sizeof(sizes)) {
+            THROW(Aborted, lut::sprintf("invalid zip64 extra field in %s", path));
+          }
+          n = fread((char *)sizes, sizeof(sizes), 1, _fp);
           if (!n) {
             THROW(Aborted, lut::sprintf("unable to read file %s", path));
           }
 
-          compressed_size = zip64_eef.compressed_size;
-          uncompressed_size = zip64_eef.uncompressed_size;
+          uncompressed_size = sizes[0];
+          compressed_size = sizes[1];
 
           // skip remaining extra field blocks
-          fseek(_fp, lfh.extra_field_length - extra_offset - 4 - sizeof(zip64_eef), SEEK_CUR);
+          fseek(_fp, lfh.extra_field_length - extra_offset - 4 - sizeof(sizes), SEEK_CUR);
+          extra_offset = lfh.extra_field_length;
           break;
         }
+        if (extra_offset != lfh.extra_field_length) {
+          THROW(Aborted, lut::sprintf("invalid extra field in %s", path));
+        }
       } else {
         // skip extra field
         fseek(_fp, lfh.extra_field_length, SEEK_CUR);
@@ -301,6 +310,19 @@ void ZipFile::Impl::open(const std::string &path) {
       THROW(Aborted, lut::sprintf("unsupported signature %x\n", signature));
     }
   }
+
+  fclose(_fp);
+  _fp = nullptr;
+  _file = RandomAccessFile::open(path);
+
+  // entries are stored without compression, so they could be read in place from the mapping.
+  // Fall back to fread() if the file could not be mapped.
+  try {
+    _mappedFile = MappedFile::open(path);
+  } catch (const AbortedError &e) {
+    LOG(WARN) << "unable to map " << path << ", fall back to read: " << e.what();
+    _mappedFile = nullptr;
+  }
 }
 
 std::vector<std::string> ZipFile::Impl::getList() const {
@@ -323,6 +345,8 @@ ZipFile::Impl::StoreZipMeta ZipFile::Impl::getFileMeta(const std::string &name)
 }
 
 int ZipFile::Impl::close() {
+  _file = nullptr;
+  _mappedFile = nullptr;
   if (!_fp) return 0;
 
   fclose(_fp);
@@ -331,8 +355,12 @@ int ZipFile::Impl::close() {
   return 0;
 }
 
-FILE *ZipFile::Impl::getFp() {
-  return _fp;
+std::shared_ptr<RandomAccessFile> ZipFile::Impl::getFile() {
+  return _file;
+}
+
+std::shared_ptr<MappedFile> ZipFile::Impl::getMappedFile() {
+  return _mappedFile;
 }
 
 // -----------------------------------------------------------------------------------------------+
@@ -340,8 +368,7 @@ FILE *ZipFile::Impl::getFp() {
 // -----------------------------------------------------------------------------------------------+
 
 ZipFile::FileReader::FileReader()
-    : _fp(nullptr),
-      _pos(0) {
+    : _pos(0) {
 }
 ZipFile::FileReader::~FileReader() {
 }
@@ -350,7 +377,8 @@ void ZipFile::FileReader::init(
     std::shared_ptr<ZipFile::Impl> zipImpl,
     const std::string &filename) {
   _fileMeta = zipImpl->getFileMeta(filename);
-  _fp = zipImpl->getFp();
+  _file = zipImpl->getFile();
+  _zipFile = zipImpl;
 }
 
 int64_t ZipFile::FileReader::readData(Span<int8_t> buffer) {
@@ -359,16 +387,31 @@ int64_t ZipFile::FileReader::readData(Span<int8_t> buffer) {
 
   // on EOF.
   if (nRead == 0) return 0;
-  int ok = FSEEK64(_fp, _fileMeta.offset + _pos, SEEK_SET);
-  if (ok != 0) THROW(Aborted, "failed to read zip file.");
-
-  int n = fread(buffer.data(), nRead, 1, _fp);
-  if (n != 1) THROW(Aborted, "failed to read zip file.");
+  _file->readAt(_fileMeta.offset + _pos, buffer.subspan(0, nRead));
 
   _pos += nRead;
   return nRead;
 }
 
+void ZipFile::FileReader::skipData(int64_t n) {
+  if (n > static_cast<int64_t>(_fileMeta.size) - _pos) throw OutOfRangeError("unexcpected EOF");
+  _pos += n;
+}
+
+void ZipFile::FileReader::adviseSequential() {
+  // the whole remaining entry will be read, start reading it ahead. It also works for the data
+  // accessed through the mapping, since the mapping shares the page cache.
+  _file->adviseWillNeed(_fileMeta.offset + _pos, _fileMeta.size - _pos);
+}
+
+std::shared_ptr<MappedFile> ZipFile::FileReader::getMappedFileImpl(int64_t *pos) {
+  std::shared_ptr<MappedFile> mappedFile = _zipFile->getMappedFile();
+  if (!mappedFile) return nullptr;
+
+  *pos = _fileMeta.offset + _pos;
+  return mappedFile;
+}
+
 // -----------------------------------------------------------------------------------------------+
 // class ZipFile                                                                                  |
 // -----------------------------------------------------------------------------------------------+
@@ -381,6 +424,14 @@ std::shared_ptr<ZipFile> ZipFile::fromFile(const std::string &filename) {
   return zipFile;
 }
 
+std::vector<std::string> ZipFile::getList() const {
+  return _impl->getList();
+}
+
+int64_t ZipFile::getFileSize(const std::string &filename) const {
+  return _impl->getFileMeta(filename).size;
+}
+
 std::shared_ptr<Reader> ZipFile::open(const std::string &filename) const {
   std::shared_ptr<FileReader> reader = std::make_shared<FileReader>();
   reader->init(_impl, filename);
@@ -20,6 +20,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "lutil/reader.h"
 
@@ -34,6 +36,12 @@ class ZipFile {
 
   std::shared_ptr<Reader> open(const std::string &filename) const;
 
+  // names of all entries in the zip file, in sorted order.
+  std::vector<std::string> getList() const;
+
+  // size of the entry `filename`. Throw AbortedError if it not exists.
+  int64_t getFileSize(const std::string &filename) const;
+
  private:
   class Impl;
   class FileReader;
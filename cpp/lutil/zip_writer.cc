@@ -0,0 +1,259 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lutil/zip_writer.h"
+
+#include <algorithm>
+
+#include "lutil/crc32.h"
+#include "lutil/error.h"
+#include "lutil/strings.h"
+
+#ifdef _MSC_VER
+#define FSEEK64 _fseeki64
+#elif _FILE_OFFSET_BITS == 64
+#define FSEEK64 fseeko
+#else
+#define FSEEK64 fseeko64
+#endif  // _MSC_VER
+
+namespace lut {
+
+namespace {
+
+constexpr uint32_t Max32 = 0xffffffff;
+constexpr uint16_t Zip64ExtraId = 0x0001;
+
+// extra field id for the alignment padding, the same as the zipalign and OPC growth hint.
+constexpr uint16_t PaddingExtraId = 0xa220;
+
+// version needed to extract: 2.0 for stored entries and 4.5 for zip64.
+constexpr uint16_t Version = 20;
+constexpr uint16_t VersionZip64 = 45;
+
+template<typename T>
+void appendValue(std::string *buffer, T value) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+}  // namespace
+
+ZipWriter::ZipWriter()
+    : _fp(nullptr),
+      _pos(0),
+      _inEntry(false),
+      _entryWritten(0) {
+}
+
+ZipWriter::~ZipWriter() {
+  if (_fp) {
+    fclose(_fp);
+    _fp = nullptr;
+  }
+}
+
+std::unique_ptr<ZipWriter> ZipWriter::create(const std::string &filename) {
+  std::unique_ptr<ZipWriter> writer{new ZipWriter()};
+  writer->_fp = fopen(filename.c_str(), "wb");
+  if (!writer->_fp) THROW(Aborted, lut::sprintf("unable to open file %s", filename));
+
+  return writer;
+}
+
+void ZipWriter::writeData(const std::string &data) {
+  writeRaw(data.data(), static_cast<int64_t>(data.size()));
+}
+
+void ZipWriter::writeRaw(const void *data, int64_t size) {
+  if (size == 0) return;
+  if (fwrite(data, size, 1, _fp) != 1) THROW(Aborted, "failed to write file.");
+  _pos += size;
+}
+
+void ZipWriter::seek(int64_t pos) {
+  if (FSEEK64(_fp, pos, SEEK_SET) != 0) THROW(Aborted, "failed to seek file.");
+}
+
+void ZipWriter::beginEntry(
+    const std::string &name,
+    int64_t size,
+    int64_t alignOffset,
+    int alignment) {
+  CHECK(_fp && !_inEntry);
+  CHECK(size >= 0 && alignment > 0);
+  if (name.size() > 0xffff) THROW(Aborted, "name too long.");
+
+  bool zip64 = size >= Max32;
+  std::string extra;
+  if (zip64) {
+    appendValue<uint16_t>(&extra, Zip64ExtraId);
+    appendValue<uint16_t>(&extra, 16);
+    appendValue<uint64_t>(&extra, size);
+    appendValue<uint64_t>(&extra, size);
+  }
+
+  if (alignment > 1) {
+    int64_t offset = _pos + 30 + name.size() + extra.size() + 4 + alignOffset;
+    int64_t padding = (alignment - offset % alignment) % alignment;
+
+    // the length of extra field is 16-bit.
+    CHECK(extra.size() + 4 + padding <= 0xffff) << "alignment too large.";
+    appendValue<uint16_t>(&extra, PaddingExtraId);
+    appendValue<uint16_t>(&extra, static_cast<uint16_t>(padding));
+    extra.append(padding, '\0');
+  }
+
+  // local file header. crc32 is filled in endEntry().
+  std::string header;
+  appendValue<uint32_t>(&header, 0x04034b50);
+  appendValue<uint16_t>(&header, zip64 ? VersionZip64 : Version);
+  appendValue<uint16_t>(&header, 0);  // flag
+  appendValue<uint16_t>(&header, 0);  // compression: stored
+  appendValue<uint16_t>(&header, 0);  // last modify time
+  appendValue<uint16_t>(&header, 0x21);  // last modify date: 1980-01-01
+  appendValue<uint32_t>(&header, 0);  // crc32
+  appendValue<uint32_t>(&header, zip64 ? Max32 : static_cast<uint32_t>(size));
+  appendValue<uint32_t>(&header, zip64 ? Max32 : static_cast<uint32_t>(size));
+  appendValue<uint16_t>(&header, static_cast<uint16_t>(name.size()));
+  appendValue<uint16_t>(&header, static_cast<uint16_t>(extra.size()));
+  header += name;
+  header += extra;
+
+  Entry entry;
+  entry.name = name;
+  entry.offset = _pos;
+  entry.size = size;
+  entry.crc = 0;
+
+  writeData(header);
+  _entries.emplace_back(entry);
+
+  _inEntry = true;
+  _entryWritten = 0;
+}
+
+void ZipWriter::write(Span<const int8_t> data) {
+  CHECK(_inEntry);
+  writeRaw(data.data(), static_cast<int64_t>(data.size()));
+
+  _entryWritten += data.size();
+  _entries.back().crc = crc32(data, _entries.back().crc);
+}
+
+void ZipWriter::endEntry() {
+  CHECK(_inEntry);
+  Entry &entry = _entries.back();
+  if (_entryWritten != entry.size) {
+    THROW(Aborted, lut::sprintf("size mismatch in entry %s.", entry.name));
+  }
+
+  // fill the crc32 of local file header.
+  uint32_t crc = entry.crc;
+  seek(entry.offset + 14);
+  if (fwrite(&crc, sizeof(crc), 1, _fp) != 1) THROW(Aborted, "failed to write file.");
+  seek(_pos);
+
+  _inEntry = false;
+}
+
+void ZipWriter::close() {
+  CHECK(_fp && !_inEntry);
+
+  // central directory.
+  int64_t cdOffset = _pos;
+  for (const Entry &entry : _entries) {
+    bool zip64Size = entry.size >= Max32;
+    bool zip64Offset = entry.offset >= Max32;
+
+    std::string extra;
+    if (zip64Size || zip64Offset) {
+      appendValue<uint16_t>(&extra, Zip64ExtraId);
+      appendValue<uint16_t>(&extra, (zip64Size ? 16 : 0) + (zip64Offset ? 8 : 0));
+      if (zip64Size) {
+        appendValue<uint64_t>(&extra, entry.size);
+        appendValue<uint64_t>(&extra, entry.size);
+      }
+      if (zip64Offset) appendValue<uint64_t>(&extra, entry.offset);
+    }
+
+    uint16_t version = extra.empty() ? Version : VersionZip64;
+    std::string header;
+    appendValue<uint32_t>(&header, 0x02014b50);
+    appendValue<uint16_t>(&header, version);  // version made by
+    appendValue<uint16_t>(&header, version);  // version needed
+    appendValue<uint16_t>(&header, 0);  // flag
+    appendValue<uint16_t>(&header, 0);  // compression: stored
+    appendValue<uint16_t>(&header, 0);  // last modify time
+    appendValue<uint16_t>(&header, 0x21);  // last modify date: 1980-01-01
+    appendValue<uint32_t>(&header, entry.crc);
+    appendValue<uint32_t>(&header, zip64Size ? Max32 : static_cast<uint32_t>(entry.size));
+    appendValue<uint32_t>(&header, zip64Size ? Max32 : static_cast<uint32_t>(entry.size));
+    appendValue<uint16_t>(&header, static_cast<uint16_t>(entry.name.size()));
+    appendValue<uint16_t>(&header, static_cast<uint16_t>(extra.size()));
+    appendValue<uint16_t>(&header, 0);  // file comment length
+    appendValue<uint16_t>(&header, 0);  // disk number start
+    appendValue<uint16_t>(&header, 0);  // internal file attributes
+    appendValue<uint32_t>(&header, 0);  // external file attributes
+    appendValue<uint32_t>(&header, zip64Offset ? Max32 : static_cast<uint32_t>(entry.offset));
+    header += entry.name;
+    header += extra;
+    writeData(header);
+  }
+  int64_t cdSize = _pos - cdOffset;
+  int64_t numEntries = static_cast<int64_t>(_entries.size());
+
+  std::string eocd;
+  if (numEntries >= 0xffff || cdOffset >= Max32 || cdSize >= Max32) {
+    // zip64 end of central directory record and locator.
+    int64_t eocd64Offset = _pos;
+    appendValue<uint32_t>(&eocd, 0x06064b50);
+    appendValue<uint64_t>(&eocd, 44);  // size of the remaining record
+    appendValue<uint16_t>(&eocd, VersionZip64);
+    appendValue<uint16_t>(&eocd, VersionZip64);
+    appendValue<uint32_t>(&eocd, 0);  // number of this disk
+    appendValue<uint32_t>(&eocd, 0);  // disk of the central directory
+    appendValue<uint64_t>(&eocd, numEntries);
+    appendValue<uint64_t>(&eocd, numEntries);
+    appendValue<uint64_t>(&eocd, cdSize);
+    appendValue<uint64_t>(&eocd, cdOffset);
+
+    appendValue<uint32_t>(&eocd, 0x07064b50);
+    appendValue<uint32_t>(&eocd, 0);  // disk of the zip64 end of central directory
+    appendValue<uint64_t>(&eocd, eocd64Offset);
+    appendValue<uint32_t>(&eocd, 1);  // total number of disks
+  }
+
+  appendValue<uint32_t>(&eocd, 0x06054b50);
+  appendValue<uint16_t>(&eocd, 0);  // number of this disk
+  appendValue<uint16_t>(&eocd, 0);  // disk of the central directory
+  appendValue<uint16_t>(&eocd, static_cast<uint16_t>(std::min<int64_t>(numEntries, 0xffff)));
+  appendValue<uint16_t>(&eocd, static_cast<uint16_t>(std::min<int64_t>(numEntries, 0xffff)));
+  appendValue<uint32_t>(&eocd, static_cast<uint32_t>(std::min<int64_t>(cdSize, Max32)));
+  appendValue<uint32_t>(&eocd, static_cast<uint32_t>(std::min<int64_t>(cdOffset, Max32)));
+  appendValue<uint16_t>(&eocd, 0);  // comment length
+  writeData(eocd);
+
+  if (fclose(_fp) != 0) {
+    _fp = nullptr;
+    THROW(Aborted, "failed to write file.");
+  }
+  _fp = nullptr;
+}
+
+}  // namespace lut
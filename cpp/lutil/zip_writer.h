@@ -0,0 +1,91 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lutil/noncopyable.h"
+#include "lutil/span.h"
+
+namespace lut {
+
+// writer for the zip file with stored (uncompressed) entries, which could be read by ZipFile.
+// Zip64 records are used when the sizes or offsets exceed 4GB. Example:
+//
+//   auto writer = ZipWriter::create("model.zip");
+//   writer->beginEntry("a.tensor", data.size());
+//   writer->write(data);
+//   writer->endEntry();
+//   writer->close();
+class ZipWriter : private NonCopyable {
+ public:
+  // create the zip file `filename`. Throw AbortedError if failed.
+  static std::unique_ptr<ZipWriter> create(const std::string &filename);
+
+  // the file is incomplete if it is destructed without close().
+  ~ZipWriter();
+
+  // begin an entry of `size` bytes. The extra field of the entry is padded so that the byte at
+  // `alignOffset` of the entry data is aligned to `alignment` bytes in the file. It allows the
+  // readers of the mapped file to access that data in place. The padding is limited by the 16-bit
+  // length of extra field, so `alignment` should be far less than 64KB.
+  void beginEntry(
+      const std::string &name,
+      int64_t size,
+      int64_t alignOffset = 0,
+      int alignment = 1);
+
+  // write the data of current entry.
+  void write(Span<const int8_t> data);
+
+  // finish current entry. Throw if the size of data written mismatches beginEntry().
+  void endEntry();
+
+  // write the central directory and close the file.
+  void close();
+
+ private:
+  struct Entry {
+    std::string name;
+    int64_t offset;
+    int64_t size;
+    uint32_t crc;
+  };
+
+  FILE *_fp;
+  int64_t _pos;
+  std::vector<Entry> _entries;
+
+  bool _inEntry;
+  int64_t _entryWritten;
+
+  ZipWriter();
+
+  void writeData(const std::string &data);
+  void writeRaw(const void *data, int64_t size);
+  void seek(int64_t pos);
+};
+
+}  // namespace lut
@@ -0,0 +1,114 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Xiaoyang Chen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "lutil/zip_writer.h"
+
+#include <string>
+
+#include "../../third_party/catch2/catch_amalgamated.hpp"
+#include "lutil/crc32.h"
+#include "lutil/path.h"
+#include "lutil/reader.h"
+#include "lutil/zip_file.h"
+
+namespace lut {
+
+namespace {
+
+Span<const int8_t> toSpan(const std::string &s) {
+  return makeConstSpan(reinterpret_cast<const int8_t *>(s.data()), s.size());
+}
+
+}  // namespace
+
+CATCH_TEST_CASE("test crc32", "[core][util][zip]") {
+  CATCH_REQUIRE(crc32(toSpan("")) == 0);
+  CATCH_REQUIRE(crc32(toSpan("123456789")) == 0xcbf43926);
+
+  // chained crc equals the crc of the concatenated data.
+  std::string s = "The quick brown fox jumps over the lazy dog";
+  CATCH_REQUIRE(crc32(toSpan(s)) == 0x414fa339);
+  CATCH_REQUIRE(crc32(toSpan(s.substr(7)), crc32(toSpan(s.substr(0, 7)))) == 0x414fa339);
+}
+
+CATCH_TEST_CASE("test crc32c", "[core][util][zip]") {
+  CATCH_REQUIRE(crc32c(toSpan("")) == 0);
+  CATCH_REQUIRE(crc32c(toSpan("123456789")) == 0xe3069283);
+
+  std::string s = "The quick brown fox jumps over the lazy dog";
+  CATCH_REQUIRE(crc32c(toSpan(s)) == 0x22620404);
+  CATCH_REQUIRE(crc32c(toSpan(s.substr(7)), crc32c(toSpan(s.substr(0, 7)))) == 0x22620404);
+
+  // the hardware path against the bitwise definition, for unaligned heads and tails.
+  std::string data(100, '\0');
+  for (int i = 0; i < 100; ++i) data[i] = static_cast<char>(i * 37 + 11);
+  for (int begin = 0; begin < 9; ++begin) {
+    for (int end = 90; end < 100; ++end) {
+      uint32_t c = 0xffffffff;
+      for (int i = begin; i < end; ++i) {
+        c ^= static_cast<uint8_t>(data[i]);
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0x82f63b78 ^ (c >> 1) : c >> 1;
+      }
+      CATCH_REQUIRE(crc32c(toSpan(data.substr(begin, end - begin))) == ~c);
+    }
+  }
+}
+
+CATCH_TEST_CASE("test ZipWriter", "[core][util][zip]") {
+  Path dirname = Path::currentExecutablePath().dirname();
+  std::string filename = (dirname / "test_zip_writer.zip").string();
+
+  std::string a = "hello, world!";
+  std::string b(1000, 'b');
+
+  std::unique_ptr<ZipWriter> writer = ZipWriter::create(filename);
+  writer->beginEntry("mismatch", 10);
+  writer->write(toSpan(a.substr(0, 5)));
+  CATCH_REQUIRE_THROWS(writer->endEntry());
+
+  writer = ZipWriter::create(filename);
+  writer->beginEntry("a.txt", a.size());
+  writer->write(toSpan(a));
+  writer->endEntry();
+
+  writer->beginEntry("b.bin", b.size(), 10, 64);
+  writer->write(toSpan(b));
+  writer->endEntry();
+
+  writer->beginEntry("empty", 0);
+  writer->endEntry();
+  writer->close();
+
+  std::shared_ptr<ZipFile> zipFile = ZipFile::fromFile(filename);
+  CATCH_REQUIRE(zipFile->getList() == std::vector<std::string>{"a.txt", "b.bin", "empty"});
+  CATCH_REQUIRE(zipFile->getFileSize("a.txt") == static_cast<int64_t>(a.size()));
+  CATCH_REQUIRE(zipFile->getFileSize("empty") == 0);
+
+  std::shared_ptr<Reader> reader = zipFile->open("a.txt");
+  CATCH_REQUIRE(reader->readString(a.size()) == a);
+
+  reader = zipFile->open("b.bin");
+  reader->skip(10);
+  int64_t offset;
+  CATCH_REQUIRE(reader->getMappedFile(&offset));
+  CATCH_REQUIRE(offset % 64 == 0);
+  CATCH_REQUIRE(reader->readString(b.size() - 10) == b.substr(10));
+}
+
+}  // namespace lut
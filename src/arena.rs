@@ -0,0 +1,59 @@
+use crate::{lten, Result};
+use std::marker::PhantomData;
+
+/// Run `f` in an arena scope. While `f` is running, the CPU tensors created in current thread are
+/// allocated from a bump-pointer arena, which is reset when `f` returns. Tensors that outlive the
+/// scope (including the ones returned by `f`) are promoted to regular memory, so they stay valid.
+/// Slices from `Tensor::data` taken inside the scope must not be used after it.
+///
+/// Arena scopes could only be entered by this function, so nested scopes always exit in the
+/// reverse order of entering.
+pub fn with_arena_scope<T, F: FnOnce() -> T>(f: F) -> Result<T> {
+    let scope = ArenaScope::enter()?;
+    let ret = f();
+    scope.exit()?;
+
+    Ok(ret)
+}
+
+/// Guard of an arena scope, it only exits the scope by itself when `f` of `with_arena_scope`
+/// panics.
+struct ArenaScope {
+    scopep: lten::LArenaScopePtr,
+
+    // the scope is bound to current thread.
+    _marker: PhantomData<*mut ()>,
+}
+
+impl ArenaScope {
+    fn enter() -> Result<ArenaScope> {
+        let scopep = unsafe { lten::lten_enter_arena_scope() };
+        if scopep.is_null() {
+            Err(lten::last_error())
+        } else {
+            Ok(ArenaScope {
+                scopep,
+                _marker: PhantomData,
+            })
+        }
+    }
+
+    fn exit(self) -> Result<()> {
+        let scopep = self.scopep;
+        std::mem::forget(self);
+
+        let retcode = unsafe { lten::lten_exit_arena_scope(scopep) };
+        if retcode != 0 {
+            Err(lten::last_error())
+        } else {
+            Ok(())
+        }
+    }
+}
+
+impl Drop for ArenaScope {
+    fn drop(&mut self) {
+        // the inner scopes were already dropped while unwinding, this scope is the innermost one.
+        unsafe { lten::lten_exit_arena_scope(self.scopep) };
+    }
+}
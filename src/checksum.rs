@@ -0,0 +1,42 @@
+use crate::{lten, Error, Result};
+use std::ffi::CString;
+use std::path::Path;
+
+/// Result of `verify_model`.
+#[derive(Debug, Clone)]
+pub struct VerifyResult {
+    /// Number of tensor slots whose CRC-32C matched.
+    pub num_verified: i64,
+
+    /// Number of tensor slots without checksum, written by the converters before it.
+    pub num_unchecked: i64,
+
+    /// True if the file was not read since its sidecar shows it was verified before.
+    pub cached: bool,
+}
+
+/// Verify the CRC-32C checksums of all the tensors in model file `path` before loading it. Returns
+/// the error of the first corrupted tensor. If `use_cache` is true, a file recorded as verified in
+/// the sidecar "<path>.verified" is not read again, and a newly verified file is recorded.
+pub fn verify_model(path: &Path, use_cache: bool) -> Result<VerifyResult> {
+    let path = path
+        .to_str()
+        .ok_or(Error::LtenError("invalid path".to_string()))?;
+    let path = CString::new(path).map_err(|e| Error::LtenError(e.to_string()))?;
+
+    let mut result = lten::LVerifyResult {
+        num_verified: 0,
+        num_unchecked: 0,
+        cached: 0,
+    };
+    let retcode = unsafe { lten::lten_verify_model(path.as_ptr(), use_cache as i32, &mut result) };
+    if retcode != 0 {
+        return Err(lten::last_error());
+    }
+
+    Ok(VerifyResult {
+        num_verified: result.num_verified,
+        num_unchecked: result.num_unchecked,
+        cached: result.cached != 0,
+    })
+}
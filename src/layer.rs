@@ -1,5 +1,92 @@
-use crate::{operator::F, Error, Result, Tensor};
-use std::{collections::HashMap, rc::Rc};
+use crate::{lten, operator::F, DType, Error, Result, Tensor};
+use std::ffi::{c_char, CStr, CString};
+use std::path::Path;
+use std::{collections::HashMap, ptr, rc::Rc};
+
+// a safetensors file opened by lten. The tensors loaded from it keep the mapped file alive, so it
+// could be dropped once they are loaded.
+struct SafeTensors {
+    stp: lten::LSafeTensorsPtr,
+}
+
+impl Drop for SafeTensors {
+    fn drop(&mut self) {
+        let retcode = unsafe { lten::lten_destroy_safetensors(self.stp) };
+        if retcode != 0 {
+            eprintln!(
+                "an error occured when dropping a safetensors: {}",
+                lten::last_error_string()
+            );
+        }
+    }
+}
+
+impl SafeTensors {
+    fn open(path: &Path) -> Result<SafeTensors> {
+        let path = path
+            .to_str()
+            .ok_or(Error::LtenError("invalid path".to_string()))?;
+        let path = CString::new(path).map_err(|e| Error::LtenError(e.to_string()))?;
+        let stp = unsafe { lten::lten_open_safetensors(path.as_ptr()) };
+        if stp.is_null() {
+            Err(lten::last_error())
+        } else {
+            Ok(SafeTensors { stp })
+        }
+    }
+
+    fn names(&self) -> Result<Vec<String>> {
+        let mut num_tensors: i32 = 0;
+        let retcode = unsafe { lten::lten_safetensors_get_num_tensors(self.stp, &mut num_tensors) };
+        if retcode != 0 {
+            return Err(lten::last_error());
+        }
+
+        let mut names = Vec::new();
+        for i in 0..num_tensors {
+            let name = unsafe { lten::lten_safetensors_get_name(self.stp, i) };
+            if name.is_null() {
+                return Err(lten::last_error());
+            }
+            let name = unsafe { CStr::from_ptr(name) };
+            names.push(name.to_string_lossy().into_owned());
+        }
+
+        Ok(names)
+    }
+
+    // loads the tensors concurrently in the worker threads of lten.
+    fn get_tensors(&self, names: &[String], dtype: Option<DType>) -> Result<Vec<Tensor>> {
+        let names = names
+            .iter()
+            .map(|name| CString::new(name.as_str()).map_err(|e| Error::LtenError(e.to_string())))
+            .collect::<Result<Vec<CString>>>()?;
+        let name_ptrs: Vec<*const c_char> = names.iter().map(|name| name.as_ptr()).collect();
+        let mut tensorps: Vec<lten::LTensorPtr> = vec![ptr::null_mut(); names.len()];
+
+        let dtypel = match dtype {
+            Some(dtype) => dtype.to_lten(),
+            None => 0,
+        };
+        let retcode = unsafe {
+            lten::lten_safetensors_get_tensors(
+                self.stp,
+                names.len() as i32,
+                name_ptrs.as_ptr(),
+                dtypel,
+                tensorps.as_mut_ptr(),
+            )
+        };
+        if retcode != 0 {
+            return Err(lten::last_error());
+        }
+
+        Ok(tensorps
+            .into_iter()
+            .map(|tensorp| Tensor { tensorp })
+            .collect())
+    }
+}
 
 #[derive(Clone)]
 pub struct Builder {
@@ -8,13 +95,44 @@ pub struct Builder {
 }
 
 impl Builder {
+    /// Creates the builder of the root module from a safetensors file. All the tensors are loaded
+    /// concurrently, and the weights point into the mapped file without copying. If `dtype` is
+    /// given (`DType::Float` or `DType::Float16`), the float tensors are converted to it when
+    /// loading. BF16 tensors are always converted, to float if `dtype` is None.
+    pub fn from_safetensors<P: AsRef<Path>>(path: P, dtype: Option<DType>) -> Result<Builder> {
+        let st = SafeTensors::open(path.as_ref())?;
+        let names = st.names()?;
+        let tensors = st.get_tensors(&names, dtype)?;
+
+        Ok(Builder {
+            tensor_map: Rc::new(names.into_iter().zip(tensors).collect()),
+            name: String::new(),
+        })
+    }
+
+    /// Gets the builder of the child module `name`.
+    pub fn subscope(&self, name: &str) -> Builder {
+        Builder {
+            tensor_map: self.tensor_map.clone(),
+            name: self.get_full_name(name),
+        }
+    }
+
     pub fn get_tensor(&self, name: &str) -> Result<Tensor> {
-        let tensor_name = self.name.clone() + "." + name;
+        let tensor_name = self.get_full_name(name);
         match self.tensor_map.get(&tensor_name) {
             Some(tensor) => Ok(tensor.clone()),
             None => Err(Error::TensorNotExistError),
         }
     }
+
+    fn get_full_name(&self, name: &str) -> String {
+        if self.name.is_empty() {
+            name.to_string()
+        } else {
+            self.name.clone() + "." + name
+        }
+    }
 }
 
 pub struct LayerNorm {
@@ -1,11 +1,23 @@
+mod arena;
+mod checksum;
 mod layer;
 mod lten;
+mod memory;
 mod operator;
 mod tensor;
 
+pub use arena::with_arena_scope;
+pub use checksum::verify_model;
+pub use checksum::VerifyResult;
+pub use layer::Builder;
+pub use memory::get_memory_stats;
+pub use memory::reset_peak_memory_stats;
+pub use memory::MemoryScope;
+pub use memory::MemoryStats;
 pub use operator::F;
 pub use tensor::DType;
 pub use tensor::Device;
+pub use tensor::NumaPlacement;
 pub use tensor::Tensor;
 
 #[derive(thiserror::Error, Debug)]
@@ -1,6 +1,30 @@
 use std::ffi::{c_char, c_void, CStr};
 
 pub(crate) type LTensorPtr = *mut c_void;
+pub(crate) type LArenaScopePtr = *mut c_void;
+pub(crate) type LMemoryScopePtr = *mut c_void;
+pub(crate) type LSafeTensorsPtr = *mut c_void;
+pub(crate) type LDeleter = Option<unsafe extern "C" fn(ptr: *mut c_void, ctx: *mut c_void)>;
+
+pub(crate) const MEMORY_HISTOGRAM_SIZE: usize = 16;
+pub(crate) const MEMORY_SCOPE_NAME_SIZE: usize = 64;
+
+#[repr(C)]
+pub(crate) struct LMemoryStats {
+    pub(crate) live_bytes: i64,
+    pub(crate) peak_bytes: i64,
+    pub(crate) num_allocs: i64,
+    pub(crate) num_frees: i64,
+    pub(crate) histogram: [i64; MEMORY_HISTOGRAM_SIZE],
+    pub(crate) peak_scope: [c_char; MEMORY_SCOPE_NAME_SIZE],
+}
+
+#[repr(C)]
+pub(crate) struct LVerifyResult {
+    pub(crate) num_verified: i64,
+    pub(crate) num_unchecked: i64,
+    pub(crate) cached: i32,
+}
 
 extern "C" {
     pub(crate) fn lten_last_error_message() -> *const c_char;
@@ -11,6 +35,15 @@ extern "C" {
         dtype: i32,
         device: i32,
     ) -> LTensorPtr;
+    pub(crate) fn lten_new_tensor_from_ptr(
+        dim: i32,
+        shape: *const i64,
+        strides: *const i64,
+        dtype: i32,
+        ptr: *mut c_void,
+        deleter: LDeleter,
+        ctx: *mut c_void,
+    ) -> LTensorPtr;
     pub(crate) fn lten_get_dim(tensor: LTensorPtr, dim: *mut i32) -> i32;
     pub(crate) fn lten_get_shape(tensor: LTensorPtr, dim: i32, size: *mut i64) -> i32;
     pub(crate) fn lten_get_numel(tensor: LTensorPtr, numel: *mut i64) -> i32;
@@ -28,6 +61,37 @@ extern "C" {
     pub(crate) fn lten_copy(dest: LTensorPtr, src: LTensorPtr) -> i32;
     pub(crate) fn lten_fill_float(tensor: LTensorPtr, value: f32) -> i32;
     pub(crate) fn lten_print(tensor: LTensorPtr) -> i32;
+    pub(crate) fn lten_place_numa(tensor: LTensorPtr, placement: i32) -> i32;
+    pub(crate) fn lten_enter_arena_scope() -> LArenaScopePtr;
+    pub(crate) fn lten_exit_arena_scope(scope: LArenaScopePtr) -> i32;
+    pub(crate) fn lten_get_memory_stats(device: i32, stats: *mut LMemoryStats) -> i32;
+    pub(crate) fn lten_reset_peak_memory_stats(device: i32) -> i32;
+    pub(crate) fn lten_enter_memory_scope(name: *const c_char) -> LMemoryScopePtr;
+    pub(crate) fn lten_get_memory_scope_stats(
+        scope: LMemoryScopePtr,
+        device: i32,
+        stats: *mut LMemoryStats,
+    ) -> i32;
+    pub(crate) fn lten_exit_memory_scope(scope: LMemoryScopePtr) -> i32;
+    pub(crate) fn lten_open_safetensors(filename: *const c_char) -> LSafeTensorsPtr;
+    pub(crate) fn lten_destroy_safetensors(st: LSafeTensorsPtr) -> i32;
+    pub(crate) fn lten_safetensors_get_num_tensors(
+        st: LSafeTensorsPtr,
+        num_tensors: *mut i32,
+    ) -> i32;
+    pub(crate) fn lten_safetensors_get_name(st: LSafeTensorsPtr, index: i32) -> *const c_char;
+    pub(crate) fn lten_safetensors_get_tensors(
+        st: LSafeTensorsPtr,
+        num_tensors: i32,
+        names: *const *const c_char,
+        dtype: i32,
+        tensors: *mut LTensorPtr,
+    ) -> i32;
+    pub(crate) fn lten_verify_model(
+        filename: *const c_char,
+        use_cache: i32,
+        result: *mut LVerifyResult,
+    ) -> i32;
     pub(crate) fn lten_apply_operator(
         targ0: LTensorPtr,
         targ1: LTensorPtr,
@@ -55,6 +119,7 @@ pub(crate) const OPERATOR_LOOKUP: i32 = 10;
 pub(crate) const OPERATOR_SCALAR_MUL: i32 = 11;
 pub(crate) const OPERATOR_LAYER_NORM: i32 = 12;
 pub(crate) const OPERATOR_RMS_NORM: i32 = 13;
+pub(crate) const OPERATOR_FLAG_MOVE_TARG0: i32 = 0x10000;
 
 pub(crate) const DEVICE_CPU: i32 = 0x0000_0000;
 pub(crate) const DEVICE_CUDA: i32 = 0x0001_0000;
@@ -68,6 +133,9 @@ pub(crate) const DTYPE_INT8: i32 = 6;
 
 pub(crate) const RANGE_NONE: i64 = -0x1000000000000000;
 
+pub(crate) const NUMA_PARTITION_ROWS: i32 = 1;
+pub(crate) const NUMA_INTERLEAVE: i32 = 2;
+
 pub(crate) fn last_error_string() -> String {
     unsafe {
         let ptr = lten_last_error_message();
@@ -0,0 +1,124 @@
+use crate::{lten, Device, Error, Result};
+use std::ffi::{CStr, CString};
+use std::marker::PhantomData;
+
+/// Memory counters of the tensor data on one device.
+#[derive(Debug, Clone)]
+pub struct MemoryStats {
+    /// Bytes of the tensor data currently alive. In a scope it is the net bytes allocated since the
+    /// scope was entered, which could be negative.
+    pub live_bytes: i64,
+
+    /// Maximum of `live_bytes` since the start or the last `reset_peak_memory_stats`.
+    pub peak_bytes: i64,
+
+    /// Number of buffers allocated and freed, one for each slot of the tensor data.
+    pub num_allocs: i64,
+    pub num_frees: i64,
+
+    /// Bucket i counts the buffers with size in [2^i MB, 2^(i+1) MB), the last bucket also counts
+    /// all the larger ones.
+    pub histogram: [i64; lten::MEMORY_HISTOGRAM_SIZE],
+
+    /// Name of the innermost `MemoryScope` when `peak_bytes` was reached. Empty in the stats of
+    /// scopes.
+    pub peak_scope: String,
+}
+
+impl MemoryStats {
+    fn from_lten(stats: &lten::LMemoryStats) -> MemoryStats {
+        let peak_scope = unsafe { CStr::from_ptr(stats.peak_scope.as_ptr()) };
+        MemoryStats {
+            live_bytes: stats.live_bytes,
+            peak_bytes: stats.peak_bytes,
+            num_allocs: stats.num_allocs,
+            num_frees: stats.num_frees,
+            histogram: stats.histogram,
+            peak_scope: peak_scope.to_string_lossy().into_owned(),
+        }
+    }
+
+    fn new_lten() -> lten::LMemoryStats {
+        lten::LMemoryStats {
+            live_bytes: 0,
+            peak_bytes: 0,
+            num_allocs: 0,
+            num_frees: 0,
+            histogram: [0; lten::MEMORY_HISTOGRAM_SIZE],
+            peak_scope: [0; lten::MEMORY_SCOPE_NAME_SIZE],
+        }
+    }
+}
+
+/// Get the global memory counters of tensor data on `device`.
+pub fn get_memory_stats(device: Device) -> Result<MemoryStats> {
+    let mut stats = MemoryStats::new_lten();
+    let retcode = unsafe { lten::lten_get_memory_stats(device.to_lten(), &mut stats) };
+    if retcode != 0 {
+        return Err(lten::last_error());
+    }
+
+    Ok(MemoryStats::from_lten(&stats))
+}
+
+/// Reset the peak bytes of `device` to its current live bytes.
+pub fn reset_peak_memory_stats(device: Device) -> Result<()> {
+    let retcode = unsafe { lten::lten_reset_peak_memory_stats(device.to_lten()) };
+    if retcode != 0 {
+        return Err(lten::last_error());
+    }
+
+    Ok(())
+}
+
+/// Guard of a named memory scope. While it is alive, the buffers allocated and freed by current
+/// thread are also counted in the scope. The name of the innermost scope is recorded with the
+/// global peak.
+///
+/// Guards are bound to the thread that created them and should be dropped in the reverse order
+/// of creation.
+pub struct MemoryScope {
+    scopep: lten::LMemoryScopePtr,
+
+    // the scope is bound to current thread.
+    _marker: PhantomData<*mut ()>,
+}
+
+impl MemoryScope {
+    pub fn new(name: &str) -> Result<MemoryScope> {
+        let name = CString::new(name).map_err(|e| Error::LtenError(e.to_string()))?;
+        let scopep = unsafe { lten::lten_enter_memory_scope(name.as_ptr()) };
+        if scopep.is_null() {
+            Err(lten::last_error())
+        } else {
+            Ok(MemoryScope {
+                scopep,
+                _marker: PhantomData,
+            })
+        }
+    }
+
+    /// Get the counters of this scope on `device`.
+    pub fn stats(&self, device: Device) -> Result<MemoryStats> {
+        let mut stats = MemoryStats::new_lten();
+        let retcode =
+            unsafe { lten::lten_get_memory_scope_stats(self.scopep, device.to_lten(), &mut stats) };
+        if retcode != 0 {
+            return Err(lten::last_error());
+        }
+
+        Ok(MemoryStats::from_lten(&stats))
+    }
+}
+
+impl Drop for MemoryScope {
+    fn drop(&mut self) {
+        let retcode = unsafe { lten::lten_exit_memory_scope(self.scopep) };
+        if retcode != 0 {
+            eprintln!(
+                "an error occured when dropping a memory scope: {}",
+                lten::last_error_string()
+            );
+        }
+    }
+}
@@ -248,6 +248,52 @@ impl F {
         )
     }
 
+    /// Same as `add`, but consumes `lhs`. When no other tensor shares the data of `lhs`, the output
+    /// is written into it instead of a new tensor.
+    pub fn add_owned(lhs: Tensor, rhs: &Tensor) -> Result<Tensor> {
+        Self::apply_op_owned(lhs, Some(rhs), 0.0, lten::OPERATOR_ADD)
+    }
+
+    /// Same as `mul`, but consumes `lhs` and reuses its data when possible.
+    pub fn mul_owned(lhs: Tensor, rhs: &Tensor) -> Result<Tensor> {
+        Self::apply_op_owned(lhs, Some(rhs), 0.0, lten::OPERATOR_MUL)
+    }
+
+    /// Same as `scalar_mul`, but consumes `tensor` and reuses its data when possible.
+    pub fn scalar_mul_owned(tensor: Tensor, rhs: f32) -> Result<Tensor> {
+        Self::apply_op_owned(tensor, None, rhs, lten::OPERATOR_SCALAR_MUL)
+    }
+
+    /// Same as `softmax`, but consumes `tensor` and reuses its data when possible.
+    pub fn softmax_owned(tensor: Tensor) -> Result<Tensor> {
+        Self::apply_op_owned(tensor, None, 0.0, lten::OPERATOR_SOFTMAX)
+    }
+
+    /// Same as `gelu`, but consumes `tensor` and reuses its data when possible.
+    pub fn gelu_owned(tensor: Tensor) -> Result<Tensor> {
+        Self::apply_op_owned(tensor, None, 0.0, lten::OPERATOR_GELU)
+    }
+
+    // moves the data of targ0 into the operator, the emptied handle is destroyed on drop.
+    fn apply_op_owned(
+        targ0: Tensor,
+        targ1: Option<&Tensor>,
+        farg0: f32,
+        op: i32,
+    ) -> Result<Tensor> {
+        Self::apply_op(
+            &targ0,
+            targ1,
+            None,
+            None,
+            0,
+            0,
+            farg0,
+            0.0,
+            op | lten::OPERATOR_FLAG_MOVE_TARG0,
+        )
+    }
+
     fn apply_op(
         targ0: &Tensor,
         targ1: Option<&Tensor>,
@@ -1,10 +1,24 @@
 use crate::{lten, operator::F, Error, Result};
 use std::any::TypeId;
+use std::ffi::c_void;
 use std::fmt;
-use std::io::BufReader;
+use std::fs::File;
 use std::io::Read;
 use std::ops::{Bound, RangeBounds};
+use std::os::unix::fs::FileExt;
 use std::ptr;
+use std::sync::Mutex;
+use std::thread;
+
+const TENSOR_TAG: &[u8; 16] = b"[tensor]        ";
+const TENSOR_END_TAG: &[u8; 16] = b"[/tensor]       ";
+
+// upper bound of the number of dimensions, to reject a corrupted header before allocating.
+const MAX_DIM: i64 = 16;
+
+// payloads larger than this are split in `Tensor::read_many_at`, so that a single large tensor is
+// also read by all the threads.
+const READ_CHUNK_SIZE: usize = 16 << 20;
 
 pub struct Shape {
     size: Vec<i64>,
@@ -48,6 +62,15 @@ impl Shape {
     pub(crate) fn dim(&self) -> i32 {
         self.size.len() as i32
     }
+
+    pub(crate) fn numel(&self) -> i64 {
+        self.size.iter().product()
+    }
+}
+
+// releases the buffer owned by a tensor created in `Tensor::from_buffer`.
+unsafe extern "C" fn drop_buffer<B>(_ptr: *mut c_void, ctx: *mut c_void) {
+    drop(Box::from_raw(ctx as *mut B));
 }
 
 pub enum Device {
@@ -72,6 +95,24 @@ impl Device {
     }
 }
 
+/// How the data of a CPU tensor is placed on the NUMA nodes.
+pub enum NumaPlacement {
+    /// Rows of a 2D weight are moved to the nodes of the threads computing them in GEMV.
+    PartitionRows,
+
+    /// Pages are interleaved over all the nodes.
+    Interleave,
+}
+
+impl NumaPlacement {
+    pub(crate) fn to_lten(&self) -> i32 {
+        match self {
+            Self::PartitionRows => lten::NUMA_PARTITION_ROWS,
+            Self::Interleave => lten::NUMA_INTERLEAVE,
+        }
+    }
+}
+
 #[derive(PartialEq, Clone, Copy)]
 pub enum DType {
     Float,
@@ -134,7 +175,8 @@ impl DType {
             Self::Int64 => Ok(numel * 8),
             Self::UInt8 => Ok(numel),
             Self::Float16 => Ok(numel * 2),
-            Self::QInt4 => Ok(numel / 2),
+            Self::QInt4 if numel % 32 == 0 => Ok(numel / 32 * 20),
+            Self::QInt4 => Err(Error::LtenError("invalid numel for qint4x32".to_string())),
             Self::Int8 => Ok(numel),
             _ => Err(Error::LtenError("unknown dtype".to_string())),
         }
@@ -201,62 +243,76 @@ impl Tensor {
         }
     }
 
-    pub fn from_reader<R: Read>(r: &mut BufReader<R>) -> Result<Tensor> {
-        // opening tag
-        let mut s = String::new();
-        r.take(16).read_to_string(&mut s)?;
-        if s != "[tensor]        " {
-            return Err(Error::LtenError("invalid tensor data".to_string()));
-        }
-
-        let mut b = [0u8; 8];
+    /// Reads a tensor serialized as the `[tensor]` header, the payload and the `[/tensor]` tag. The
+    /// payload is read into the tensor memory directly. Reads larger than the capacity of a
+    /// `BufReader` bypass its internal buffer, so the payload is not copied twice with it either.
+    pub fn from_reader<R: Read>(r: &mut R) -> Result<Tensor> {
+        let header = TensorHeader::read(r)?;
+        let mut tensor = Tensor::new(&header.shape, header.dtype, Device::Cpu)?;
+        r.read_exact(tensor.bytes_mut(header.num_bytes)?)?;
 
-        // version
-        r.read_exact(&mut b)?;
-        let version = i64::from_le_bytes(b) as i32;
-        if version != 1 {
-            return Err(Error::LtenError("unsupported tensor".to_string()));
-        }
-
-        // shape
-        r.read_exact(&mut b)?;
-        let dim = i64::from_le_bytes(b);
-        let mut shape: Vec<i64> = Vec::new();
-        let mut shape_numel: i64 = 1;
-        for _ in 0..dim {
-            r.read_exact(&mut b)?;
-            let n = i64::from_le_bytes(b);
-            shape.push(n);
-            shape_numel *= n;
-        }
-
-        // dtype
-        r.read_exact(&mut b)?;
-        let dtypel = i64::from_le_bytes(b) as i32;
-        let dtype = DType::from_lten(dtypel)?;
-
-        // numel
-        r.read_exact(&mut b)?;
-        let numel = i64::from_le_bytes(b);
-        if numel != shape_numel {
-            return Err(Error::LtenError("shape and numel mismatch".to_string()));
-        }
-
-        // data
-        let tensor = Tensor::new(&shape, dtype, Device::Cpu)?;
-        let total_bytes = dtype.num_bytes(numel as usize)?;
-        let data = unsafe { std::slice::from_raw_parts_mut::<u8>(tensor.raw_data()?, total_bytes) };
-        r.read_exact(data)?;
-
-        // closing tag
-        r.take(16).read_to_string(&mut s)?;
-        if s != "[/tensor]       " {
+        let mut tag = [0u8; 16];
+        r.read_exact(&mut tag)?;
+        if &tag != TENSOR_END_TAG {
             return Err(Error::LtenError("invalid tensor data".to_string()));
         }
 
         Ok(tensor)
     }
 
+    /// Reads the tensor serialized at `offset` of `file`. It uses positional reads and leaves the
+    /// cursor of `file` unchanged, so the file handle could be shared by threads. Returns the
+    /// tensor and the offset next to it.
+    pub fn read_at(file: &File, offset: u64) -> Result<(Tensor, u64)> {
+        let header = TensorHeader::read_at(file, offset)?;
+        let mut tensor = Tensor::new(&header.shape, header.dtype, Device::Cpu)?;
+        file.read_exact_at(tensor.bytes_mut(header.num_bytes)?, header.payload_offset)?;
+
+        Ok((tensor, header.end_offset()))
+    }
+
+    /// Reads `count` tensors serialized one after another from `offset` of `file`. The headers
+    /// are read first to allocate the tensors, then the payloads are read into the tensor memory
+    /// concurrently by the threads sharing the file handle.
+    pub fn read_many_at(file: &File, offset: u64, count: usize) -> Result<Vec<Tensor>> {
+        let mut tensors = Vec::with_capacity(count);
+        let mut jobs: Vec<(u64, &mut [u8])> = Vec::new();
+        let mut offset = offset;
+        for _ in 0..count {
+            let header = TensorHeader::read_at(file, offset)?;
+            let mut tensor = Tensor::new(&header.shape, header.dtype, Device::Cpu)?;
+            let data = tensor.bytes_mut(header.num_bytes)?;
+            for (i, chunk) in data.chunks_mut(READ_CHUNK_SIZE).enumerate() {
+                jobs.push((header.payload_offset + (i * READ_CHUNK_SIZE) as u64, chunk));
+            }
+
+            tensors.push(tensor);
+            offset = header.end_offset();
+        }
+
+        let num_threads = thread::available_parallelism().map_or(1, |n| n.get());
+        let num_threads = num_threads.min(jobs.len());
+        let jobs = Mutex::new(jobs);
+        thread::scope(|s| {
+            let workers: Vec<_> = (0..num_threads)
+                .map(|_| {
+                    s.spawn(|| -> std::io::Result<()> {
+                        loop {
+                            let job = jobs.lock().unwrap().pop();
+                            match job {
+                                Some((offset, chunk)) => file.read_exact_at(chunk, offset)?,
+                                None => return Ok(()),
+                            }
+                        }
+                    })
+                })
+                .collect();
+            workers.into_iter().try_for_each(|w| w.join().unwrap())
+        })?;
+
+        Ok(tensors)
+    }
+
     pub fn from_slice<S: Into<Shape>, T: 'static + Copy>(shape: S, data: &[T]) -> Result<Tensor> {
         let dtype = DType::from_type::<T>()?;
         let mut tensor = Self::new(shape, dtype, Device::Cpu)?;
@@ -274,6 +330,48 @@ impl Tensor {
         Ok(tensor)
     }
 
+    /// Creates a CPU tensor from `buffer` without copying the data. The tensor takes the ownership
+    /// of the buffer (e.g. a `Vec<T>` or a `Box<[T]>`). The buffer is dropped when the last tensor
+    /// sharing its data is dropped, which may happen in another thread.
+    pub fn from_buffer<S, T, B>(shape: S, buffer: B) -> Result<Tensor>
+    where
+        S: Into<Shape>,
+        T: 'static + Copy,
+        B: AsMut<[T]> + Send + 'static,
+    {
+        let dtype = DType::from_type::<T>()?;
+        let s: Shape = shape.into();
+
+        let mut buffer = Box::new(buffer);
+        let data = (*buffer).as_mut();
+        if s.numel() != data.len() as i64 {
+            return Err(Error::LtenError(
+                "shape and buffer length mismatch".to_string(),
+            ));
+        }
+
+        let ptr = data.as_mut_ptr() as *mut c_void;
+        let ctx = Box::into_raw(buffer) as *mut c_void;
+        let tensorp = unsafe {
+            lten::lten_new_tensor_from_ptr(
+                s.dim(),
+                s.as_ptr(),
+                ptr::null(),
+                dtype.to_lten(),
+                ptr,
+                Some(drop_buffer::<B>),
+                ctx,
+            )
+        };
+        if tensorp.is_null() {
+            // the deleter is not called on failure.
+            unsafe { drop(Box::from_raw(ctx as *mut B)) };
+            Err(lten::last_error())
+        } else {
+            Ok(Tensor { tensorp })
+        }
+    }
+
     pub fn dim(&self) -> Result<i64> {
         let mut d: i32 = 0;
         let retcode = unsafe { lten::lten_get_dim(self.tensorp, &mut d) };
@@ -434,6 +532,16 @@ impl Tensor {
         F::print(self);
     }
 
+    /// Place the data on the NUMA nodes. Does nothing on single-node machines.
+    pub fn place_numa(&self, placement: NumaPlacement) -> Result<()> {
+        let retcode = unsafe { lten::lten_place_numa(self.tensorp, placement.to_lten()) };
+        if retcode != 0 {
+            Err(lten::last_error())
+        } else {
+            Ok(())
+        }
+    }
+
     pub fn to_device(&self, device: Device) -> Result<Tensor> {
         F::to(device, self)
     }
@@ -458,6 +566,15 @@ impl Tensor {
         F::scalar_mul(self, rhs)
     }
 
+    // the data of a newly created CPU tensor as bytes, used to read the payload into it.
+    fn bytes_mut<'a>(&mut self, num_bytes: usize) -> Result<&'a mut [u8]>
+    where
+        Self: 'a,
+    {
+        let p = self.raw_data::<u8>()?;
+        Ok(unsafe { std::slice::from_raw_parts_mut::<'a, u8>(p, num_bytes) })
+    }
+
     fn raw_data<'a, T: 'static>(&self) -> Result<*mut T>
     where
         Self: 'a,
@@ -471,6 +588,100 @@ impl Tensor {
     }
 }
 
+// header of a serialized tensor, from the opening tag to numel.
+struct TensorHeader {
+    shape: Vec<i64>,
+    dtype: DType,
+    num_bytes: usize,
+    payload_offset: u64,
+}
+
+impl TensorHeader {
+    fn read<R: Read>(r: &mut R) -> Result<TensorHeader> {
+        let mut tag = [0u8; 16];
+        r.read_exact(&mut tag)?;
+        if &tag != TENSOR_TAG {
+            return Err(Error::LtenError("invalid tensor data".to_string()));
+        }
+
+        let version = read_i64(r)?;
+        if version != 1 {
+            return Err(Error::LtenError("unsupported tensor".to_string()));
+        }
+
+        let dim = read_i64(r)?;
+        if !(0..=MAX_DIM).contains(&dim) {
+            return Err(Error::LtenError("invalid tensor dim".to_string()));
+        }
+
+        let mut shape: Vec<i64> = Vec::with_capacity(dim as usize);
+        let mut shape_numel: i64 = 1;
+        for _ in 0..dim {
+            let n = read_i64(r)?;
+            shape_numel = match shape_numel.checked_mul(n) {
+                Some(numel) if n >= 0 => numel,
+                _ => return Err(Error::LtenError("invalid tensor shape".to_string())),
+            };
+            shape.push(n);
+        }
+
+        let dtype = DType::from_lten(read_i64(r)? as i32)?;
+        let numel = read_i64(r)?;
+        if numel != shape_numel {
+            return Err(Error::LtenError("shape and numel mismatch".to_string()));
+        }
+
+        let num_bytes = dtype.num_bytes(numel as usize)?;
+        let payload_offset = 16 + 8 * (4 + dim as u64);
+        Ok(TensorHeader {
+            shape,
+            dtype,
+            num_bytes,
+            payload_offset,
+        })
+    }
+
+    // reads the header at `offset` of `file` and checks the closing tag after the payload.
+    fn read_at(file: &File, offset: u64) -> Result<TensorHeader> {
+        let mut r = PositionalReader { file, offset };
+        let mut header = Self::read(&mut r)?;
+        header.payload_offset += offset;
+
+        let mut tag = [0u8; 16];
+        file.read_exact_at(&mut tag, header.payload_offset + header.num_bytes as u64)?;
+        if &tag != TENSOR_END_TAG {
+            return Err(Error::LtenError("invalid tensor data".to_string()));
+        }
+
+        Ok(header)
+    }
+
+    // offset next to the closing tag, when the header is read by `read_at`.
+    fn end_offset(&self) -> u64 {
+        self.payload_offset + self.num_bytes as u64 + TENSOR_END_TAG.len() as u64
+    }
+}
+
+fn read_i64<R: Read>(r: &mut R) -> Result<i64> {
+    let mut b = [0u8; 8];
+    r.read_exact(&mut b)?;
+    Ok(i64::from_le_bytes(b))
+}
+
+// reads a file from `offset` without moving its cursor.
+struct PositionalReader<'a> {
+    file: &'a File,
+    offset: u64,
+}
+
+impl Read for PositionalReader<'_> {
+    fn read(&mut self, buf: &mut [u8]) -> std::io::Result<usize> {
+        let n = self.file.read_at(buf, self.offset)?;
+        self.offset += n as u64;
+        Ok(n)
+    }
+}
+
 impl Clone for Tensor {
     fn clone(&self) -> Self {
         let tensorp = unsafe { lten::lten_clone(self.tensorp) };